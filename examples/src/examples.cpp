@@ -51,6 +51,7 @@ void json_traits_integer_examples();
 void json_traits_polymorphic_examples();
 void jsonschema_examples();
 void erase_examples();
+void inline_string_examples();
 
 void comment_example()
 {
@@ -464,6 +465,8 @@ int main()
         jsonpointer_examples();
 
         jsonpath_examples();
+
+        inline_string_examples();
     }
     catch (const std::exception& e)
     {
@@ -0,0 +1,191 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <jsoncons/json.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+    // Counts the bytes and blocks that are live
+
+    struct allocation_counter
+    {
+        std::size_t bytes;
+        std::size_t blocks;
+
+        static allocation_counter& instance()
+        {
+            static allocation_counter counter = {0,0};
+            return counter;
+        }
+    };
+
+    template <class T>
+    class counting_allocator
+    {
+    public:
+        using value_type = T;
+
+        counting_allocator() noexcept = default;
+
+        template <class U>
+        counting_allocator(const counting_allocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            allocation_counter::instance().bytes += n*sizeof(T);
+            ++allocation_counter::instance().blocks;
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            allocation_counter::instance().bytes -= n*sizeof(T);
+            --allocation_counter::instance().blocks;
+            std::allocator<T>().deallocate(p, n);
+        }
+
+        friend bool operator==(const counting_allocator&, const counting_allocator&) noexcept
+        {
+            return true;
+        }
+
+        friend bool operator!=(const counting_allocator&, const counting_allocator&) noexcept
+        {
+            return false;
+        }
+    };
+
+    // Orders with UUIDs, object ids, timestamps and a few short strings
+    std::string make_orders(std::size_t count)
+    {
+        const char* hex = "0123456789abcdef";
+        const char* statuses[] = {"new", "paid", "shipped", "returned"};
+
+        std::string s = "[";
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::string uuid;
+            std::string object_id;
+            for (std::size_t k = 0; k < 32; ++k)
+            {
+                uuid.push_back(hex[(i*31 + k*7) % 16]);
+                if (k == 7 || k == 11 || k == 15 || k == 19)
+                {
+                    uuid.push_back('-');
+                }
+            }
+            for (std::size_t k = 0; k < 24; ++k)
+            {
+                object_id.push_back(hex[(i*17 + k*5) % 16]);
+            }
+            std::string day = std::to_string(10 + i % 18);
+
+            if (i > 0)
+            {
+                s.push_back(',');
+            }
+            s += "{\"id\":\"" + uuid + "\"";
+            s += ",\"customer\":{\"id\":\"" + object_id + "\",\"name\":\"customer " + std::to_string(i % 100) + "\"}";
+            s += ",\"created\":\"2020-11-" + day + "T08:15:30Z\"";
+            s += ",\"sku\":\"SKU-" + std::to_string(1000000 + i) + "-XL\"";
+            s += ",\"status\":\"" + std::string(statuses[i % 4]) + "\"";
+            s += ",\"amount\":" + std::to_string(i % 1000) + ".25";
+            s += ",\"tags\":[\"priority\",\"gift-wrapped\",\"warehouse-" + std::to_string(i % 10) + "\"]}";
+        }
+        s.push_back(']');
+        return s;
+    }
+
+    template <class Json>
+    std::size_t string_length_sum(const Json& j)
+    {
+        std::size_t sum = 0;
+        if (j.is_string())
+        {
+            sum += j.as_string_view().size();
+        }
+        else if (j.is_array())
+        {
+            for (const auto& item : j.array_range())
+            {
+                sum += string_length_sum(item);
+            }
+        }
+        else if (j.is_object())
+        {
+            for (const auto& member : j.object_range())
+            {
+                sum += member.key().size() + string_length_sum(member.value());
+            }
+        }
+        return sum;
+    }
+
+    template <class Policy>
+    void measure(const char* name, const std::string& input)
+    {
+        using Json = basic_json<char,Policy,counting_allocator<char>>;
+        using clock = std::chrono::steady_clock;
+
+        std::size_t bytes = allocation_counter::instance().bytes;
+        std::size_t blocks = allocation_counter::instance().blocks;
+
+        auto start = clock::now();
+        Json j = Json::parse(input);
+        auto parsed = clock::now();
+
+        std::size_t sum = 0;
+        const std::size_t passes = 20;
+        for (std::size_t i = 0; i < passes; ++i)
+        {
+            sum += string_length_sum(j);
+        }
+        auto traversed = clock::now();
+
+        auto parse_time = std::chrono::duration_cast<std::chrono::microseconds>(parsed - start).count();
+        auto traversal_time = std::chrono::duration_cast<std::chrono::microseconds>(traversed - parsed).count()/passes;
+
+        std::cout << std::left << std::setw(32) << name
+                  << std::right << std::setw(8) << sizeof(Json)
+                  << std::setw(12) << (allocation_counter::instance().bytes - bytes)
+                  << std::setw(10) << (allocation_counter::instance().blocks - blocks)
+                  << std::setw(12) << parse_time
+                  << std::setw(14) << traversal_time
+                  << "  (" << sum/passes << ")\n";
+    }
+
+    void compare_layouts()
+    {
+        std::string input = make_orders(20000);
+
+        std::cout << "Input: " << input.size() << " bytes\n\n";
+        std::cout << std::left << std::setw(32) << "policy"
+                  << std::right << std::setw(8) << "sizeof"
+                  << std::setw(12) << "heap bytes"
+                  << std::setw(10) << "blocks"
+                  << std::setw(12) << "parse (us)"
+                  << std::setw(14) << "traverse (us)" << "\n";
+
+        measure<sorted_policy>("sorted_policy", input);
+        measure<inline_string_policy>("inline_string_policy", input);
+        measure<basic_inline_string_policy<40>>("basic_inline_string_policy<40>", input);
+    }
+
+} // namespace
+
+void inline_string_examples()
+{
+    std::cout << "\nInline string examples\n\n";
+    compare_layouts();
+    std::cout << std::endl;
+}
@@ -32,6 +32,7 @@
 #include <jsoncons/json_options.hpp>
 #include <jsoncons/json_encoder.hpp>
 #include <jsoncons/json_decoder.hpp>
+#include <jsoncons/interned_key.hpp>
 #include <jsoncons/json_reader.hpp>
 #include <jsoncons/json_type_traits.hpp>
 #include <jsoncons/byte_string.hpp>
@@ -230,6 +231,23 @@ namespace jsoncons {
                 return next += offset;
             }
         };
+
+        // The size of a basic_json, policies that don't have a storage_size get 16 bytes
+
+        template <class Policy>
+        using policy_storage_size_t = decltype(Policy::storage_size);
+
+        template <class Policy,class Enable=void>
+        struct json_storage_size
+        {
+            static constexpr std::size_t value = 2*sizeof(uint64_t);
+        };
+
+        template <class Policy>
+        struct json_storage_size<Policy,typename std::enable_if<type_traits::is_detected<policy_storage_size_t,Policy>::value>::type>
+        {
+            static constexpr std::size_t value = Policy::storage_size;
+        };
     } // namespace detail
 
     struct sorted_policy 
@@ -250,6 +268,27 @@ namespace jsoncons {
         using key_order = preserve_key_order;
     };
 
+    // Text strings of up to Size - 3 chars are stored inline, in a basic_json of Size bytes,
+    // rather than the 13 chars that fit in the default 16 bytes
+
+    template <std::size_t Size>
+    struct basic_inline_string_policy : public sorted_policy
+    {
+        static constexpr std::size_t storage_size = Size;
+    };
+
+    template <std::size_t Size>
+    constexpr std::size_t basic_inline_string_policy<Size>::storage_size;
+
+    using inline_string_policy = basic_inline_string_policy<24>;
+
+    // Keys are interned, objects with the same member names share the name strings
+    struct interned_policy : public sorted_policy
+    {
+        template <class CharT, class CharTraits, class Allocator>
+        using key_storage = basic_interned_key<CharT, CharTraits, Allocator>;
+    };
+
     template <class IteratorT, class ConstIteratorT>
     class range 
     {
@@ -338,7 +377,7 @@ namespace jsoncons {
 
         using char_allocator_type = typename std::allocator_traits<allocator_type>:: template rebind_alloc<char_type>;
 
-        using key_type = std::basic_string<char_type,char_traits_type,char_allocator_type>;
+        using key_type = typename implementation_policy::template key_storage<char_type,char_traits_type,char_allocator_type>;
 
 
         using reference = basic_json&;
@@ -521,31 +560,51 @@ namespace jsoncons {
             uint8_t length_:4;
             semantic_tag tag_;
         private:
-            static constexpr size_t capacity = (2*sizeof(uint64_t) - 2*sizeof(uint8_t))/sizeof(char_type);
+            static constexpr std::size_t storage_size = detail::json_storage_size<implementation_policy>::value;
+            static_assert(storage_size >= 2*sizeof(uint64_t) && storage_size % sizeof(uint64_t) == 0 && storage_size <= 128,
+                          "The storage size must be a multiple of 8 from 16 to 128");
+
+            static constexpr size_t capacity = (storage_size - 2*sizeof(uint8_t))/sizeof(char_type);
             char_type data_[capacity];
         public:
             static constexpr size_t max_length = capacity - 1;
+        private:
+            // Lengths that don't fit in length_ are kept as max_length - length in the last
+            // char, which is then the terminator of a string of max_length chars
+            static constexpr bool length_in_header = max_length < 16;
+        public:
 
             short_string_storage(semantic_tag tag, const char_type* p, uint8_t length)
-                : storage_(static_cast<uint8_t>(storage_kind::short_string_value)), length_(length), tag_(tag)
+                : storage_(static_cast<uint8_t>(storage_kind::short_string_value)), length_(length_in_header ? length : 0), tag_(tag)
             {
                 JSONCONS_ASSERT(length <= max_length);
                 std::memcpy(data_,p,length*sizeof(char_type));
                 data_[length] = 0;
+                if (!length_in_header)
+                {
+                    data_[max_length] = static_cast<char_type>(max_length - length);
+                }
             }
 
             short_string_storage(const short_string_storage& val)
                 : storage_(val.storage_), length_(val.length_), tag_(val.tag_)
             {
-                std::memcpy(data_,val.data_,val.length_*sizeof(char_type));
-                data_[length_] = 0;
+                if (length_in_header)
+                {
+                    std::memcpy(data_,val.data_,val.length_*sizeof(char_type));
+                    data_[length_] = 0;
+                }
+                else
+                {
+                    std::memcpy(data_,val.data_,capacity*sizeof(char_type));
+                }
             }
            
             short_string_storage& operator=(const short_string_storage& val) = delete;
 
             uint8_t length() const
             {
-                return length_;
+                return length_in_header ? length_ : static_cast<uint8_t>(max_length - static_cast<std::size_t>(data_[max_length]));
             }
 
             const char_type* data() const
@@ -2655,6 +2714,66 @@ namespace jsoncons {
             }
         }
 
+        // Returns a hash of the value that is consistent with operator==, 
+        // numbers that compare equal hash the same whatever their storage,
+        // and object members contribute independently of their order.
+        std::size_t hash() const noexcept
+        {
+            switch (storage())
+            {
+                case storage_kind::null_value:
+                    return hash_mix(0x9e3779b97f4a7c15ull);
+                case storage_kind::bool_value:
+                    return hash_mix(cast<bool_storage>().value() ? 0x2545f4914f6cdd1dull : 0x27d4eb2f165667c5ull);
+                case storage_kind::int64_value:
+                    return hash_number(static_cast<double>(cast<int64_storage>().value()));
+                case storage_kind::uint64_value:
+                    return hash_number(static_cast<double>(cast<uint64_storage>().value()));
+                case storage_kind::half_value:
+                    return hash_number(binary::decode_half(cast<half_storage>().value()));
+                case storage_kind::double_value:
+                    return hash_number(cast<double_storage>().value());
+                case storage_kind::short_string_value:
+                case storage_kind::long_string_value:
+                    return hash_mix(hash_chars(as_string_view()));
+                case storage_kind::byte_string_value:
+                {
+                    auto bytes = as_byte_string_view();
+                    uint64_t h = 0x84222325cbf29ce4ull;
+                    for (auto b : bytes)
+                    {
+                        h = (h ^ static_cast<uint64_t>(b)) * 0x100000001b3ull;
+                    }
+                    return hash_mix(h);
+                }
+                case storage_kind::array_value:
+                {
+                    uint64_t h = 0x94d049bb133111ebull;
+                    for (const auto& item : cast<array_storage>().value())
+                    {
+                        h = hash_mix(h + static_cast<uint64_t>(item.hash()));
+                    }
+                    return static_cast<std::size_t>(h);
+                }
+                case storage_kind::empty_object_value:
+                    return hash_mix(0xbf58476d1ce4e5b9ull);
+                case storage_kind::object_value:
+                {
+                    uint64_t h = 0;
+                    for (const auto& member : cast<object_storage>().value())
+                    {
+                        h += hash_mix(hash_chars(member.key()) ^ (static_cast<uint64_t>(member.value().hash()) << 1));
+                    }
+                    return hash_mix(h ^ 0xbf58476d1ce4e5b9ull);
+                }
+                case storage_kind::json_const_pointer:
+                    return cast<json_const_pointer_storage>().value()->hash();
+                default:
+                    JSONCONS_UNREACHABLE();
+                    break;
+            }
+        }
+
         void swap(basic_json& other) noexcept
         {
             if (this == &other)
@@ -5407,6 +5526,39 @@ namespace jsoncons {
 
     private:
 
+        static std::size_t hash_mix(uint64_t h) noexcept
+        {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ull;
+            h ^= h >> 33;
+            return static_cast<std::size_t>(h);
+        }
+
+        template <class CharSequence>
+        static uint64_t hash_chars(const CharSequence& s) noexcept
+        {
+            uint64_t h = 0xcbf29ce484222325ull;
+            for (auto c : s)
+            {
+                h = (h ^ static_cast<uint64_t>(static_cast<typename std::make_unsigned<char_type>::type>(c))) * 0x100000001b3ull;
+            }
+            return h;
+        }
+
+        // Numbers of any storage kind that compare equal convert to the same double
+        static std::size_t hash_number(double d) noexcept
+        {
+            if (d == 0.0)
+            {
+                d = 0.0; // -0.0 == 0.0
+            }
+            uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            return hash_mix(bits ^ 0x3c6ef372fe94f82bull);
+        }
+
         void dump_noflush(basic_json_visitor<char_type>& visitor, std::error_code& ec) const
         {
             const ser_context context{};
@@ -5812,4 +5964,17 @@ namespace jsoncons {
 
 } // namespace jsoncons
 
+namespace std {
+
+    template <class CharT,class ImplementationPolicy,class Allocator>
+    struct hash<jsoncons::basic_json<CharT,ImplementationPolicy,Allocator>>
+    {
+        std::size_t operator()(const jsoncons::basic_json<CharT,ImplementationPolicy,Allocator>& val) const noexcept
+        {
+            return val.hash();
+        }
+    };
+
+} // namespace std
+
 #endif
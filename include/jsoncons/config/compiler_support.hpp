@@ -104,6 +104,13 @@
 #define JSONCONS_HAS_FOPEN_S
 #endif
 
+// Define JSONCONS_NO_SSE2 to disable the SSE2 code paths
+#if !defined(JSONCONS_HAS_SSE2) && !defined(JSONCONS_NO_SSE2)
+#  if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define JSONCONS_HAS_SSE2 1
+#  endif
+#endif
+
 #if !defined(JSONCONS_HAS_2017)
 #  if defined(__clang__)
 #   if (__cplusplus >= 201703)
@@ -0,0 +1,427 @@
+// Copyright 2020 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_INTERNED_KEY_HPP
+#define JSONCONS_INTERNED_KEY_HPP
+
+#include <atomic>
+#include <cstring> // std::memcpy
+#include <limits>
+#include <memory> // std::allocator
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility> // std::move
+#include <jsoncons/config/jsoncons_config.hpp>
+#include <jsoncons/more_type_traits.hpp>
+
+namespace jsoncons {
+
+    template <class Key>
+    class basic_key_pool;
+
+    // An immutable, reference counted string. Copies share one buffer, so keys that are
+    // interned in a basic_key_pool are stored once however many objects have them. Keys
+    // that share a buffer compare equal without comparing their characters.
+    //
+    // A key holds no allocator, its buffer is allocated and freed with a default 
+    // constructed Allocator, so Allocator must be stateless.
+
+    template <class CharT,class CharTraits=std::char_traits<CharT>,class Allocator=std::allocator<CharT>>
+    class basic_interned_key
+    {
+        static_assert(type_traits::is_stateless<Allocator>::value,
+                      "basic_interned_key requires a stateless allocator");
+    public:
+        using value_type = CharT;
+        using traits_type = CharTraits;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+        using const_iterator = const CharT*;
+        using iterator = const_iterator;
+        using string_view_type = jsoncons::basic_string_view<CharT,CharTraits>;
+        using pool_type = basic_key_pool<basic_interned_key>;
+        static constexpr size_type npos = size_type(-1);
+
+    private:
+        struct node
+        {
+            std::atomic<std::size_t> count;
+            std::size_t length;
+
+            explicit node(std::size_t n)
+                : count(1), length(n)
+            {
+            }
+
+            CharT* data()
+            {
+                return reinterpret_cast<CharT*>(this + 1);
+            }
+        };
+
+        using node_allocator_type = typename std::allocator_traits<Allocator>:: template rebind_alloc<node>;
+
+        node* node_;
+
+        static std::size_t node_count(std::size_t length)
+        {
+            return 1 + ((length + 1)*sizeof(CharT) + sizeof(node) - 1) / sizeof(node);
+        }
+
+        static node* create(const CharT* s, std::size_t length)
+        {
+            if (length == 0)
+            {
+                return nullptr;
+            }
+            node_allocator_type alloc;
+            node* p = std::allocator_traits<node_allocator_type>::allocate(alloc, node_count(length));
+            ::new(static_cast<void*>(p)) node(length);
+            std::memcpy(p->data(), s, length*sizeof(CharT));
+            p->data()[length] = 0;
+            return p;
+        }
+
+        static void release(node* p)
+        {
+            if (p != nullptr && p->count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                std::size_t n = node_count(p->length);
+                p->~node();
+                node_allocator_type alloc;
+                std::allocator_traits<node_allocator_type>::deallocate(alloc, p, n);
+            }
+        }
+
+        static const CharT* empty_data()
+        {
+            static const CharT s[1] = {0};
+            return s;
+        }
+    public:
+        basic_interned_key() noexcept
+            : node_(nullptr)
+        {
+        }
+
+        explicit basic_interned_key(const allocator_type&) noexcept
+            : node_(nullptr)
+        {
+        }
+
+        basic_interned_key(const CharT* s, size_type length, const allocator_type& = allocator_type())
+            : node_(create(s, length))
+        {
+        }
+
+        basic_interned_key(const CharT* s, const allocator_type& = allocator_type())
+            : node_(create(s, CharTraits::length(s)))
+        {
+        }
+
+        template <class InputIt>
+        basic_interned_key(InputIt first, InputIt last, const allocator_type& = allocator_type())
+            : node_(nullptr)
+        {
+            std::basic_string<CharT,CharTraits> s(first, last);
+            node_ = create(s.data(), s.size());
+        }
+
+        template <class Tr,class Alloc>
+        basic_interned_key(const std::basic_string<CharT,Tr,Alloc>& s, const allocator_type& = allocator_type())
+            : node_(create(s.data(), s.size()))
+        {
+        }
+
+        basic_interned_key(const basic_interned_key& other) noexcept
+            : node_(other.node_)
+        {
+            if (node_ != nullptr)
+            {
+                node_->count.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        basic_interned_key(const basic_interned_key& other, const allocator_type&) noexcept
+            : basic_interned_key(other)
+        {
+        }
+
+        basic_interned_key(basic_interned_key&& other) noexcept
+            : node_(other.node_)
+        {
+            other.node_ = nullptr;
+        }
+
+        basic_interned_key(basic_interned_key&& other, const allocator_type&) noexcept
+            : basic_interned_key(std::move(other))
+        {
+        }
+
+        ~basic_interned_key() noexcept
+        {
+            release(node_);
+        }
+
+        basic_interned_key& operator=(const basic_interned_key& other) noexcept
+        {
+            if (node_ != other.node_)
+            {
+                basic_interned_key temp(other);
+                swap(temp);
+            }
+            return *this;
+        }
+
+        basic_interned_key& operator=(basic_interned_key&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release(node_);
+                node_ = other.node_;
+                other.node_ = nullptr;
+            }
+            return *this;
+        }
+
+        void swap(basic_interned_key& other) noexcept
+        {
+            std::swap(node_, other.node_);
+        }
+
+        allocator_type get_allocator() const
+        {
+            return allocator_type();
+        }
+
+        const CharT* data() const
+        {
+            return node_ != nullptr ? node_->data() : empty_data();
+        }
+
+        const CharT* c_str() const
+        {
+            return data();
+        }
+
+        size_type size() const
+        {
+            return node_ != nullptr ? node_->length : 0;
+        }
+
+        size_type length() const
+        {
+            return size();
+        }
+
+        bool empty() const
+        {
+            return node_ == nullptr;
+        }
+
+        const_iterator begin() const
+        {
+            return data();
+        }
+
+        const_iterator end() const
+        {
+            return data() + size();
+        }
+
+        const CharT& operator[](size_type i) const
+        {
+            return data()[i];
+        }
+
+        operator string_view_type() const
+        {
+            return string_view_type(data(), size());
+        }
+
+        // Number of keys that share this key's buffer
+        std::size_t use_count() const
+        {
+            return node_ != nullptr ? node_->count.load(std::memory_order_relaxed) : 0;
+        }
+
+        int compare(const string_view_type& s) const
+        {
+            if (data() == s.data() && size() == s.size())
+            {
+                return 0;
+            }
+            return string_view_type(data(), size()).compare(s);
+        }
+
+        int compare(const basic_interned_key& other) const
+        {
+            if (node_ == other.node_)
+            {
+                return 0;
+            }
+            return compare(string_view_type(other));
+        }
+
+        friend bool operator==(const basic_interned_key& lhs, const basic_interned_key& rhs)
+        {
+            return lhs.node_ == rhs.node_ || (lhs.size() == rhs.size() && lhs.compare(rhs) == 0);
+        }
+
+        friend bool operator!=(const basic_interned_key& lhs, const basic_interned_key& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator<(const basic_interned_key& lhs, const basic_interned_key& rhs)
+        {
+            return lhs.compare(rhs) < 0;
+        }
+
+        friend bool operator==(const basic_interned_key& lhs, const string_view_type& rhs)
+        {
+            return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+        }
+
+        friend bool operator==(const string_view_type& lhs, const basic_interned_key& rhs)
+        {
+            return rhs == lhs;
+        }
+
+        friend bool operator!=(const basic_interned_key& lhs, const string_view_type& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator!=(const string_view_type& lhs, const basic_interned_key& rhs)
+        {
+            return !(rhs == lhs);
+        }
+
+        friend bool operator==(const basic_interned_key& lhs, const CharT* rhs)
+        {
+            return lhs == string_view_type(rhs);
+        }
+
+        friend bool operator!=(const basic_interned_key& lhs, const CharT* rhs)
+        {
+            return !(lhs == string_view_type(rhs));
+        }
+
+        friend std::basic_ostream<CharT>& operator<<(std::basic_ostream<CharT>& os, const basic_interned_key& key)
+        {
+            os.write(key.data(), key.size());
+            return os;
+        }
+    };
+
+    template <class CharT,class CharTraits,class Allocator>
+    constexpr typename basic_interned_key<CharT,CharTraits,Allocator>::size_type basic_interned_key<CharT,CharTraits,Allocator>::npos;
+
+    // Hands out one basic_interned_key for each distinct string. Not thread safe, a pool
+    // is meant to be used by one decoder at a time.
+
+    template <class Key>
+    class basic_key_pool
+    {
+    public:
+        using key_type = Key;
+        using char_type = typename Key::value_type;
+        using string_view_type = jsoncons::basic_string_view<char_type,typename Key::traits_type>;
+    private:
+        struct hasher
+        {
+            std::size_t operator()(const string_view_type& s) const noexcept
+            {
+                std::size_t h = 14695981039346656037ull & (std::numeric_limits<std::size_t>::max)();
+                for (auto c : s)
+                {
+                    h = (h ^ static_cast<std::size_t>(c)) * static_cast<std::size_t>(1099511628211ull);
+                }
+                return h;
+            }
+        };
+
+        // The views refer to the buffers of the keys they map to
+        std::unordered_map<string_view_type,key_type,hasher> keys_;
+    public:
+        key_type intern(const string_view_type& s)
+        {
+            auto it = keys_.find(s);
+            if (it != keys_.end())
+            {
+                return it->second;
+            }
+            key_type key(s.data(), s.size());
+            keys_.emplace(string_view_type(key.data(), key.size()), key);
+            return key;
+        }
+
+        std::size_t size() const
+        {
+            return keys_.size();
+        }
+
+        void clear()
+        {
+            keys_.clear();
+        }
+    };
+
+namespace detail {
+
+    template <class Key>
+    using key_pool_type_t = typename Key::pool_type;
+
+    // Makes the keys of the values built by json_decoder. Keys that have a pool_type
+    // are looked up in the decoder's pool, other keys are copied.
+
+    template <class Key,class Enable=void>
+    class decoder_key_factory
+    {
+    public:
+        template <class Alloc>
+        Key operator()(const typename Key::value_type* s, std::size_t length, const Alloc& alloc)
+        {
+            return Key(s, length, alloc);
+        }
+    };
+
+    template <class Key>
+    class decoder_key_factory<Key,typename std::enable_if<type_traits::is_detected<key_pool_type_t,Key>::value>::type>
+    {
+        typename Key::pool_type pool_;
+    public:
+        template <class Alloc>
+        Key operator()(const typename Key::value_type* s, std::size_t length, const Alloc&)
+        {
+            return pool_.intern(typename Key::string_view_type(s, length));
+        }
+    };
+
+    // Compares an object member's name with a name that is looked up. Interned keys
+    // compare equal to views of their own buffer without comparing characters.
+
+    template <class Key,class StringView>
+    typename std::enable_if<!type_traits::is_detected<key_pool_type_t,Key>::value,int>::type
+    compare_key(const Key& key, const StringView& name)
+    {
+        return StringView(key).compare(name);
+    }
+
+    template <class Key,class StringView>
+    typename std::enable_if<type_traits::is_detected<key_pool_type_t,Key>::value,int>::type
+    compare_key(const Key& key, const StringView& name)
+    {
+        return key.compare(name);
+    }
+
+} // namespace detail
+
+} // namespace jsoncons
+
+#endif
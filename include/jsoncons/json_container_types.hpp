@@ -21,9 +21,29 @@
 #include <type_traits> // std::enable_if
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/allocator_holder.hpp>
+#include <jsoncons/interned_key.hpp>
 
 namespace jsoncons {
 
+namespace detail {
+
+    // True if j owns a non-empty array or object. Values that merely refer to
+    // another value are not containers, and are not dereferenced.
+    template <class Json>
+    bool is_nonempty_container(const Json& j) noexcept
+    {
+        switch (j.storage())
+        {
+            case storage_kind::array_value:
+            case storage_kind::object_value:
+                return j.size() > 0;
+            default:
+                return false;
+        }
+    }
+
+} // namespace detail
+
     // json_array
 
     template <class Json>
@@ -292,7 +312,7 @@ namespace jsoncons {
                     {
                         for (auto&& item : current.array_range())
                         {
-                            if (item.size() > 0) // non-empty object or array
+                            if (detail::is_nonempty_container(item))
                             {
                                 elements_.push_back(std::move(item));
                             }
@@ -304,7 +324,7 @@ namespace jsoncons {
                     {
                         for (auto&& kv : current.object_range())
                         {
-                            if (kv.value().size() > 0) // non-empty object or array
+                            if (detail::is_nonempty_container(kv.value()))
                             {
                                 elements_.push_back(std::move(kv.value()));
                             }
@@ -715,7 +735,7 @@ namespace jsoncons {
         iterator find(const string_view_type& name) noexcept
         {
             auto it = std::lower_bound(members_.begin(),members_.end(), name, 
-                                       [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                       [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
             auto result = (it != members_.end() && it->key() == name) ? it : members_.end();
             return result;
         }
@@ -724,7 +744,7 @@ namespace jsoncons {
         {
             auto it = std::lower_bound(members_.begin(),members_.end(), 
                                        name, 
-                                       [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});
+                                       [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});
             auto result = (it != members_.end() && it->key() == name) ? it : members_.end();
             return result;
         }
@@ -753,7 +773,7 @@ namespace jsoncons {
         void erase(const string_view_type& name) 
         {
             auto it = std::lower_bound(members_.begin(),members_.end(), name, 
-                                       [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                       [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
             if (it != members_.end() && it->key() == name)
             {
                 members_.erase(it);
@@ -810,7 +830,7 @@ namespace jsoncons {
         {
             bool inserted;
             auto it = std::lower_bound(members_.begin(),members_.end(), name, 
-                                       [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                       [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
             if (it == members_.end())
             {
                 members_.emplace_back(key_type(name.begin(),name.end()), 
@@ -839,7 +859,7 @@ namespace jsoncons {
         {
             bool inserted;
             auto it = std::lower_bound(members_.begin(),members_.end(), name, 
-                                       [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                       [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
             if (it == members_.end())
             {
                 members_.emplace_back(key_type(name.begin(),name.end(), get_allocator()), 
@@ -870,7 +890,7 @@ namespace jsoncons {
         {
             bool inserted;
             auto it = std::lower_bound(members_.begin(),members_.end(), name, 
-                                       [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                       [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
             if (it == members_.end())
             {
                 members_.emplace_back(key_type(name.begin(),name.end()), 
@@ -898,7 +918,7 @@ namespace jsoncons {
         {
             bool inserted;
             auto it = std::lower_bound(members_.begin(),members_.end(), name, 
-                                       [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                       [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
             if (it == members_.end())
             {
                 members_.emplace_back(key_type(name.begin(),name.end(), get_allocator()), 
@@ -929,12 +949,12 @@ namespace jsoncons {
             if (hint != members_.end() && hint->key() <= name)
             {
                 it = std::lower_bound(hint,members_.end(), name, 
-                                      [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                      [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
             }
             else
             {
                 it = std::lower_bound(members_.begin(),members_.end(), name, 
-                                      [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                      [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
             }
 
             if (it == members_.end())
@@ -964,12 +984,12 @@ namespace jsoncons {
             if (hint != members_.end() && hint->key() <= name)
             {
                 it = std::lower_bound(hint,members_.end(), name, 
-                                      [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                      [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
             }
             else
             {
                 it = std::lower_bound(members_.begin(),members_.end(), name, 
-                                      [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                      [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
             }
 
             if (it == members_.end())
@@ -1000,12 +1020,12 @@ namespace jsoncons {
             if (hint != members_.end() && hint->key() <= name)
             {
                 it = std::lower_bound(hint,members_.end(), name, 
-                                      [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                      [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
             }
             else
             {
                 it = std::lower_bound(members_.begin(),members_.end(), name, 
-                                      [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                      [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
             }
 
             if (it == members_.end())
@@ -1035,12 +1055,12 @@ namespace jsoncons {
             if (hint != members_.end() && hint->key() <= name)
             {
                 it = std::lower_bound(hint,members_.end(), name, 
-                                      [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                      [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
             }
             else
             {
                 it = std::lower_bound(members_.begin(),members_.end(), name, 
-                                      [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                      [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
             }
 
             if (it == members_.end())
@@ -1079,7 +1099,7 @@ namespace jsoncons {
             for (; it != end; ++it)
             {
                 auto pos = std::lower_bound(members_.begin(),members_.end(), (*it).key(), 
-                                            [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});   
+                                            [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});   
                 if (pos == members_.end() )
                 {
                     members_.emplace_back(*it);
@@ -1109,12 +1129,12 @@ namespace jsoncons {
                 if (hint != members_.end() && hint->key() <= (*it).key())
                 {
                     pos = std::lower_bound(hint,members_.end(), (*it).key(), 
-                                          [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                          [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
                 }
                 else
                 {
                     pos = std::lower_bound(members_.begin(),members_.end(), (*it).key(), 
-                                          [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                          [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
                 }
                 if (pos == members_.end() )
                 {
@@ -1145,7 +1165,7 @@ namespace jsoncons {
             for (; it != end; ++it)
             {
                 auto pos = std::lower_bound(members_.begin(),members_.end(), (*it).key(), 
-                                            [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});   
+                                            [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});   
                 if (pos == members_.end() )
                 {
                     members_.emplace_back(*it);
@@ -1175,12 +1195,12 @@ namespace jsoncons {
                 if (hint != members_.end() && hint->key() <= (*it).key())
                 {
                     pos = std::lower_bound(hint,members_.end(), (*it).key(), 
-                                          [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                          [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
                 }
                 else
                 {
                     pos = std::lower_bound(members_.begin(),members_.end(), (*it).key(), 
-                                          [](const key_value_type& a, const string_view_type& k) -> bool {return string_view_type(a.key()).compare(k) < 0;});        
+                                          [](const key_value_type& a, const string_view_type& k) -> bool {return detail::compare_key(a.key(), k) < 0;});        
                 }
                 if (pos == members_.end() )
                 {
@@ -1214,7 +1234,7 @@ namespace jsoncons {
 
                 for (auto&& kv : members_)
                 {
-                    if (kv.value().size() > 0)
+                    if (detail::is_nonempty_container(kv.value()))
                     {
                         temp.emplace_back(std::move(kv.value()));
                     }
@@ -1492,6 +1512,14 @@ namespace jsoncons {
             }
         }
 
+        void erase(const_iterator pos) 
+        {
+            if (pos != members_.end())
+            {
+                erase(pos, pos + 1);
+            }
+        }
+
         void erase(const_iterator first, const_iterator last) 
         {
             std::size_t pos1 = first == members_.end() ? members_.size() : first - members_.begin();
@@ -1923,7 +1951,7 @@ namespace jsoncons {
 
                 for (auto&& kv : members_)
                 {
-                    if (kv.value().size() > 0)
+                    if (detail::is_nonempty_container(kv.value()))
                     {
                         temp.emplace_back(std::move(kv.value()));
                     }
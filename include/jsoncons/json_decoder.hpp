@@ -15,6 +15,7 @@
 #include <utility> // std::move
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/json_visitor.hpp>
+#include <jsoncons/interned_key.hpp>
 
 namespace jsoncons {
 
@@ -77,6 +78,7 @@ private:
     Json result_;
 
     key_type name_;
+    detail::decoder_key_factory<key_type> make_key_;
     std::vector<stack_item,stack_item_allocator_type> item_stack_;
     std::vector<structure_info,structure_info_allocator_type> structure_stack_;
     bool is_valid_;
@@ -248,7 +250,7 @@ private:
 
     bool visit_key(const string_view_type& name, const ser_context&, std::error_code&) override
     {
-        name_ = key_type(name.data(),name.length(),result_allocator_);
+        name_ = make_key_(name.data(),name.length(),result_allocator_);
         return true;
     }
 
@@ -16,6 +16,7 @@
 #ifndef JSONCONS_UNICODE_TRAITS_HPP
 #define JSONCONS_UNICODE_TRAITS_HPP
 
+#include <cstdint>
 #include <cstring>
 #include <string>
 #include <iterator>
@@ -25,6 +26,11 @@
 #include <jsoncons/config/compiler_support.hpp>
 #include <jsoncons/more_type_traits.hpp>
 
+
+#if defined(JSONCONS_HAS_SSE2)
+#  include <emmintrin.h>
+#endif
+
 namespace jsoncons { namespace unicode_traits {
 
     enum class encoding_kind {undetected,utf8,utf16le,utf16be,utf32le,utf32be};
@@ -1121,6 +1127,43 @@ namespace jsoncons { namespace unicode_traits {
         return convert_result<CharT>{data,result} ;
     }
 
+    // skip_ascii
+
+    // Returns a pointer to the first byte in [first,last) that is not ASCII, 
+    // examining 16 bytes per step with SSE2 where available and 8 bytes per
+    // step otherwise.
+    template <class CharT>
+    typename std::enable_if<type_traits::is_char8<CharT>::value,const CharT*>::type 
+    skip_ascii(const CharT* first, const CharT* last) noexcept
+    {
+    #if defined(JSONCONS_HAS_SSE2)
+        while (last - first >= 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+            if (_mm_movemask_epi8(chunk) != 0)
+            {
+                break;
+            }
+            first += 16;
+        }
+    #endif
+        while (last - first >= 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, first, sizeof(word));
+            if ((word & 0x8080808080808080ULL) != 0)
+            {
+                break;
+            }
+            first += 8;
+        }
+        while (first != last && static_cast<uint8_t>(*first) < 0x80)
+        {
+            ++first;
+        }
+        return first;
+    }
+
     // validate
 
     template <class CharT>
@@ -1132,6 +1175,14 @@ namespace jsoncons { namespace unicode_traits {
         const CharT* last = data + length;
         while (data != last) 
         {
+            if (static_cast<uint8_t>(*data) < 0x80)
+            {
+                data = skip_ascii(data, last);
+                if (data == last)
+                {
+                    break;
+                }
+            }
             std::size_t len = static_cast<std::size_t>(trailing_bytes_for_utf8[static_cast<uint8_t>(*data)]) + 1;
             if (len > (std::size_t)(last - data))
             {
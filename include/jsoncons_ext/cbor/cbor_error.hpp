@@ -27,7 +27,9 @@ enum class cbor_errc
     stringref_too_large,
     max_nesting_depth_exceeded,
     unknown_type,
-    illegal_chunked_string
+    illegal_chunked_string,
+    invalid_offsets,
+    trailing_data
 };
 
 class cbor_error_category_impl
@@ -66,6 +68,10 @@ public:
                 return "An unknown type was found in the stream";
             case cbor_errc::illegal_chunked_string:
                 return "An illegal type was found while parsing an indefinite length string";
+            case cbor_errc::invalid_offsets:
+                return "Saved offsets are not strictly increasing or not within the buffer";
+            case cbor_errc::trailing_data:
+                return "Unexpected data after the CBOR data item";
             default:
                 return "Unknown CBOR parser error";
         }
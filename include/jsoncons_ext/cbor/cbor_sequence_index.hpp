@@ -0,0 +1,304 @@
+// Copyright 2020 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CBOR_CBOR_SEQUENCE_INDEX_HPP
+#define JSONCONS_CBOR_CBOR_SEQUENCE_INDEX_HPP
+
+#include <vector>
+#include <utility> // std::move
+#include <type_traits> // std::enable_if
+#include <system_error>
+#include <jsoncons/config/jsoncons_config.hpp>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/more_type_traits.hpp>
+#include <jsoncons_ext/cbor/cbor_detail.hpp>
+#include <jsoncons_ext/cbor/cbor_error.hpp>
+#include <jsoncons_ext/cbor/cbor_options.hpp>
+
+namespace jsoncons { namespace cbor {
+
+namespace detail {
+
+// Reads the argument of the header at p, returns a pointer past the header
+inline
+const uint8_t* read_argument(const uint8_t* p, const uint8_t* last,
+                             uint64_t& value, std::error_code& ec)
+{
+    const uint8_t info = *p++ & 0x1f;
+    std::size_t n;
+    switch (info)
+    {
+        case JSONCONS_CBOR_0x00_0x17:
+            value = info;
+            return p;
+        case 0x18:
+            n = 1;
+            break;
+        case 0x19:
+            n = 2;
+            break;
+        case 0x1a:
+            n = 4;
+            break;
+        case 0x1b:
+            n = 8;
+            break;
+        default:
+            ec = cbor_errc::unknown_type;
+            return p;
+    }
+    if (static_cast<std::size_t>(last - p) < n)
+    {
+        ec = cbor_errc::unexpected_eof;
+        return last;
+    }
+    value = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        value = (value << 8) | p[i];
+    }
+    return p + n;
+}
+
+// Returns a pointer one past the end of the data item at p
+inline
+const uint8_t* skip_item(const uint8_t* p, const uint8_t* last,
+                         int depth, int max_nesting_depth, std::error_code& ec)
+{
+    if (p == last)
+    {
+        ec = cbor_errc::unexpected_eof;
+        return p;
+    }
+    if (JSONCONS_UNLIKELY(depth > max_nesting_depth))
+    {
+        ec = cbor_errc::max_nesting_depth_exceeded;
+        return p;
+    }
+    const auto major_type = static_cast<cbor_major_type>(*p >> 5);
+    const uint8_t info = *p & 0x1f;
+
+    if (info == additional_info::indefinite_length)
+    {
+        switch (major_type)
+        {
+            case cbor_major_type::byte_string:
+            case cbor_major_type::text_string:
+            case cbor_major_type::array:
+            case cbor_major_type::map:
+                break;
+            default:
+                ec = cbor_errc::unknown_type;
+                return p;
+        }
+        ++p;
+        while (true)
+        {
+            if (p == last)
+            {
+                ec = cbor_errc::unexpected_eof;
+                return p;
+            }
+            if (*p == 0xff)
+            {
+                return p + 1;
+            }
+            if ((major_type == cbor_major_type::byte_string ||
+                 major_type == cbor_major_type::text_string) &&
+                (static_cast<cbor_major_type>(*p >> 5) != major_type ||
+                 (*p & 0x1f) == additional_info::indefinite_length))
+            {
+                ec = cbor_errc::illegal_chunked_string;
+                return p;
+            }
+            p = skip_item(p, last, depth+1, max_nesting_depth, ec);
+            if (ec)
+            {
+                return p;
+            }
+        }
+    }
+
+    uint64_t value = 0;
+    p = read_argument(p, last, value, ec);
+    if (ec)
+    {
+        return p;
+    }
+    switch (major_type)
+    {
+        case cbor_major_type::byte_string:
+        case cbor_major_type::text_string:
+            if (value > static_cast<uint64_t>(last - p))
+            {
+                ec = cbor_errc::unexpected_eof;
+                return last;
+            }
+            return p + static_cast<std::size_t>(value);
+        case cbor_major_type::array:
+            for (uint64_t i = 0; i < value; ++i)
+            {
+                p = skip_item(p, last, depth+1, max_nesting_depth, ec);
+                if (ec)
+                {
+                    return p;
+                }
+            }
+            return p;
+        case cbor_major_type::map:
+            for (uint64_t i = 0; i < value; ++i)
+            {
+                p = skip_item(p, last, depth+1, max_nesting_depth, ec);
+                if (ec)
+                {
+                    return p;
+                }
+                p = skip_item(p, last, depth+1, max_nesting_depth, ec);
+                if (ec)
+                {
+                    return p;
+                }
+            }
+            return p;
+        case cbor_major_type::semantic_tag:
+            return skip_item(p, last, depth+1, max_nesting_depth, ec);
+        default: // integers, floats and simple values
+            return p;
+    }
+}
+
+} // namespace detail
+
+// An index of the byte offsets of the items in a buffer holding a sequence
+// of concatenated CBOR data items. The index is built in one pass that reads
+// only item headers and skips over string payloads, and is intended to be
+// used with a memory mapped file or another contiguous buffer that outlives it.
+class cbor_sequence_index
+{
+    const uint8_t* data_;
+    std::size_t length_;
+    std::vector<std::size_t> offsets_;
+public:
+    template <class Source>
+    cbor_sequence_index(const Source& source,
+                        const cbor_decode_options& options = cbor_decode_options(),
+                        typename std::enable_if<type_traits::is_byte_sequence<Source>::value,int>::type = 0)
+        : data_(reinterpret_cast<const uint8_t*>(source.data())), length_(source.size())
+    {
+        std::error_code ec;
+        std::size_t position = build(options, ec);
+        if (ec)
+        {
+            JSONCONS_THROW(ser_error(ec, 0, position));
+        }
+    }
+
+    template <class Source>
+    cbor_sequence_index(const Source& source,
+                        const cbor_decode_options& options,
+                        std::error_code& ec,
+                        typename std::enable_if<type_traits::is_byte_sequence<Source>::value,int>::type = 0)
+        : data_(reinterpret_cast<const uint8_t*>(source.data())), length_(source.size())
+    {
+        build(options, ec);
+    }
+
+    // Restores an index from previously saved offsets, which must be strictly
+    // increasing and less than the length of the buffer
+    template <class Source>
+    cbor_sequence_index(const Source& source,
+                        std::vector<std::size_t> offsets,
+                        typename std::enable_if<type_traits::is_byte_sequence<Source>::value,int>::type = 0)
+        : data_(reinterpret_cast<const uint8_t*>(source.data())), length_(source.size()),
+          offsets_(std::move(offsets))
+    {
+        std::error_code ec;
+        std::size_t position = check_offsets(ec);
+        if (ec)
+        {
+            JSONCONS_THROW(ser_error(ec, 0, position));
+        }
+    }
+
+    template <class Source>
+    cbor_sequence_index(const Source& source,
+                        std::vector<std::size_t> offsets,
+                        std::error_code& ec,
+                        typename std::enable_if<type_traits::is_byte_sequence<Source>::value,int>::type = 0)
+        : data_(reinterpret_cast<const uint8_t*>(source.data())), length_(source.size()),
+          offsets_(std::move(offsets))
+    {
+        check_offsets(ec);
+    }
+
+    // The index points into source, so a temporary would leave it dangling
+    template <class Source,class... Args,
+              class=typename std::enable_if<!std::is_lvalue_reference<Source>::value && type_traits::is_byte_sequence<Source>::value>::type>
+    cbor_sequence_index(Source&& source, Args&&... args) = delete;
+
+    std::size_t size() const
+    {
+        return offsets_.size();
+    }
+
+    const std::vector<std::size_t>& offsets() const
+    {
+        return offsets_;
+    }
+
+    std::size_t offset(std::size_t i) const
+    {
+        return offsets_.at(i);
+    }
+
+    // Returns the bytes of the i-th item, suitable as a source for decode_cbor
+    // or cbor_bytes_cursor
+    jsoncons::span<const uint8_t> item(std::size_t i) const
+    {
+        std::size_t first = offsets_.at(i);
+        std::size_t last = i+1 < offsets_.size() ? offsets_[i+1] : length_;
+        return jsoncons::span<const uint8_t>(data_ + first, last - first);
+    }
+
+private:
+    // Returns the first offset that is out of order or out of range
+    std::size_t check_offsets(std::error_code& ec)
+    {
+        for (std::size_t i = 0; i < offsets_.size(); ++i)
+        {
+            if (offsets_[i] >= length_ || (i > 0 && offsets_[i] <= offsets_[i-1]))
+            {
+                std::size_t position = offsets_[i];
+                ec = cbor_errc::invalid_offsets;
+                offsets_.clear();
+                return position;
+            }
+        }
+        return 0;
+    }
+
+    std::size_t build(const cbor_decode_options& options, std::error_code& ec)
+    {
+        const uint8_t* p = data_;
+        const uint8_t* last = data_ + length_;
+        while (p != last)
+        {
+            const uint8_t* start = p;
+            p = detail::skip_item(p, last, 0, options.max_nesting_depth(), ec);
+            if (ec)
+            {
+                offsets_.clear();
+                return static_cast<std::size_t>(p - data_);
+            }
+            offsets_.push_back(static_cast<std::size_t>(start - data_));
+        }
+        return length_;
+    }
+};
+
+}}
+
+#endif
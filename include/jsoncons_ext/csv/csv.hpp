@@ -11,6 +11,7 @@
 #include <jsoncons_ext/csv/csv_reader.hpp>
 #include <jsoncons_ext/csv/csv_encoder.hpp>
 #include <jsoncons_ext/csv/csv_cursor.hpp>
+#include <jsoncons_ext/csv/csv_columns.hpp>
 #include <jsoncons_ext/csv/decode_csv.hpp>
 #include <jsoncons_ext/csv/encode_csv.hpp>
 
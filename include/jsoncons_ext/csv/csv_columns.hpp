@@ -0,0 +1,632 @@
+// Copyright 2020 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CSV_CSV_COLUMNS_HPP
+#define JSONCONS_CSV_CSV_COLUMNS_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map> // std::unordered_map
+#include <utility> // std::move
+#include <limits> // std::numeric_limits
+#include <system_error>
+#include <jsoncons/config/jsoncons_config.hpp>
+#include <jsoncons/json_visitor.hpp>
+#include <jsoncons/sink.hpp>
+#include <jsoncons/detail/write_number.hpp>
+#include <jsoncons_ext/csv/csv_error.hpp>
+
+namespace jsoncons { namespace csv {
+
+enum class csv_column_kind : uint8_t
+{
+    null_t, // no values yet, or only nulls
+    boolean_t,
+    integer_t,
+    float_t,
+    string_t
+};
+
+// A column of CSV values stored in a typed buffer, with a validity bitmap
+// that has bit i (least significant bit first) set if row i is not null.
+// Only the buffer for the column's kind is populated, null rows hold 0, false
+// or an empty string.
+template <class CharT>
+class basic_csv_column
+{
+public:
+    using char_type = CharT;
+    using string_type = std::basic_string<CharT>;
+    using string_view_type = jsoncons::basic_string_view<CharT>;
+private:
+    template <class C>
+    friend class basic_csv_column_decoder;
+
+    string_type name_;
+    csv_column_kind kind_;
+    std::size_t size_;
+    std::vector<uint8_t> validity_;
+    std::vector<uint8_t> booleans_;
+    std::vector<int64_t> integers_;
+    std::vector<double> doubles_;
+    string_type string_data_;
+    std::vector<std::size_t> string_offsets_;
+
+    static string_view_type bool_text(bool val)
+    {
+        static constexpr CharT true_k[] = {'t','r','u','e'};
+        static constexpr CharT false_k[] = {'f','a','l','s','e'};
+        return val ? string_view_type(true_k, 4) : string_view_type(false_k, 5);
+    }
+public:
+    basic_csv_column()
+        : kind_(csv_column_kind::null_t), size_(0)
+    {
+        string_offsets_.push_back(0);
+    }
+
+    explicit basic_csv_column(const string_view_type& name)
+        : name_(name.data(), name.length()), kind_(csv_column_kind::null_t), size_(0)
+    {
+        string_offsets_.push_back(0);
+    }
+
+    const string_type& name() const
+    {
+        return name_;
+    }
+
+    csv_column_kind kind() const
+    {
+        return kind_;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    bool is_null(std::size_t i) const
+    {
+        return (validity_[i / 8] & (1u << (i % 8))) == 0;
+    }
+
+    jsoncons::span<const uint8_t> validity() const
+    {
+        return jsoncons::span<const uint8_t>(validity_.data(), validity_.size());
+    }
+
+    // One byte per row, 0 or 1
+    jsoncons::span<const uint8_t> booleans() const
+    {
+        return jsoncons::span<const uint8_t>(booleans_.data(), booleans_.size());
+    }
+
+    jsoncons::span<const int64_t> integers() const
+    {
+        return jsoncons::span<const int64_t>(integers_.data(), integers_.size());
+    }
+
+    jsoncons::span<const double> doubles() const
+    {
+        return jsoncons::span<const double>(doubles_.data(), doubles_.size());
+    }
+
+    // The characters of all string values, back to back
+    jsoncons::span<const CharT> string_data() const
+    {
+        return jsoncons::span<const CharT>(string_data_.data(), string_data_.size());
+    }
+
+    // size()+1 offsets into string_data(), value i is [offsets[i], offsets[i+1])
+    jsoncons::span<const std::size_t> string_offsets() const
+    {
+        return jsoncons::span<const std::size_t>(string_offsets_.data(), string_offsets_.size());
+    }
+
+    string_view_type string_value(std::size_t i) const
+    {
+        return string_view_type(string_data_.data() + string_offsets_[i],
+                                string_offsets_[i+1] - string_offsets_[i]);
+    }
+
+private:
+    void push_validity(bool valid)
+    {
+        if (size_ % 8 == 0)
+        {
+            validity_.push_back(0);
+        }
+        if (valid)
+        {
+            validity_.back() |= static_cast<uint8_t>(1u << (size_ % 8));
+        }
+        ++size_;
+    }
+
+    void push_null()
+    {
+        switch (kind_)
+        {
+            case csv_column_kind::boolean_t:
+                booleans_.push_back(0);
+                break;
+            case csv_column_kind::integer_t:
+                integers_.push_back(0);
+                break;
+            case csv_column_kind::float_t:
+                doubles_.push_back(0);
+                break;
+            case csv_column_kind::string_t:
+                string_offsets_.push_back(string_data_.size());
+                break;
+            default:
+                break;
+        }
+        push_validity(false);
+    }
+
+    void push_bool(bool val)
+    {
+        if (kind_ == csv_column_kind::null_t)
+        {
+            change_kind(csv_column_kind::boolean_t);
+        }
+        if (kind_ == csv_column_kind::boolean_t)
+        {
+            booleans_.push_back(val ? 1 : 0);
+            push_validity(true);
+        }
+        else
+        {
+            push_text(bool_text(val));
+        }
+    }
+
+    void push_int64(int64_t val)
+    {
+        if (kind_ == csv_column_kind::null_t)
+        {
+            change_kind(csv_column_kind::integer_t);
+        }
+        switch (kind_)
+        {
+            case csv_column_kind::integer_t:
+                integers_.push_back(val);
+                push_validity(true);
+                break;
+            case csv_column_kind::float_t:
+                doubles_.push_back(static_cast<double>(val));
+                push_validity(true);
+                break;
+            default:
+            {
+                string_type s;
+                jsoncons::string_sink<string_type> sink(s);
+                jsoncons::detail::from_integer(val, sink);
+                push_text(s);
+                break;
+            }
+        }
+    }
+
+    void push_double(double val)
+    {
+        if (kind_ == csv_column_kind::null_t || kind_ == csv_column_kind::integer_t)
+        {
+            change_kind(csv_column_kind::float_t);
+        }
+        if (kind_ == csv_column_kind::float_t)
+        {
+            doubles_.push_back(val);
+            push_validity(true);
+        }
+        else
+        {
+            string_type s;
+            jsoncons::string_sink<string_type> sink(s);
+            jsoncons::detail::write_double f{float_chars_format::general,0};
+            f(val, sink);
+            push_text(s);
+        }
+    }
+
+    void push_text(const string_view_type& sv)
+    {
+        if (kind_ != csv_column_kind::string_t)
+        {
+            change_kind(csv_column_kind::string_t);
+        }
+        string_data_.append(sv.data(), sv.length());
+        string_offsets_.push_back(string_data_.size());
+        push_validity(true);
+    }
+
+    // Converts the values held so far to the new kind, only widening
+    // conversions (null to anything, integer to float, anything to string)
+    // are needed
+    void change_kind(csv_column_kind kind)
+    {
+        switch (kind)
+        {
+            case csv_column_kind::boolean_t:
+                booleans_.assign(size_, 0);
+                break;
+            case csv_column_kind::integer_t:
+                integers_.assign(size_, 0);
+                break;
+            case csv_column_kind::float_t:
+                doubles_.reserve(size_);
+                for (std::size_t i = 0; i < size_; ++i)
+                {
+                    doubles_.push_back(kind_ == csv_column_kind::integer_t ? static_cast<double>(integers_[i]) : 0.0);
+                }
+                integers_.clear();
+                integers_.shrink_to_fit();
+                break;
+            case csv_column_kind::string_t:
+            {
+                jsoncons::string_sink<string_type> sink(string_data_);
+                jsoncons::detail::write_double f{float_chars_format::general,0};
+                for (std::size_t i = 0; i < size_; ++i)
+                {
+                    if (!is_null(i))
+                    {
+                        switch (kind_)
+                        {
+                            case csv_column_kind::boolean_t:
+                            {
+                                string_view_type sv = bool_text(booleans_[i] != 0);
+                                string_data_.append(sv.data(), sv.length());
+                                break;
+                            }
+                            case csv_column_kind::integer_t:
+                                jsoncons::detail::from_integer(integers_[i], sink);
+                                break;
+                            case csv_column_kind::float_t:
+                                f(doubles_[i], sink);
+                                break;
+                            default:
+                                break;
+                        }
+                    }
+                    string_offsets_.push_back(string_data_.size());
+                }
+                booleans_.clear();
+                booleans_.shrink_to_fit();
+                integers_.clear();
+                integers_.shrink_to_fit();
+                doubles_.clear();
+                doubles_.shrink_to_fit();
+                break;
+            }
+            default:
+                break;
+        }
+        kind_ = kind;
+    }
+};
+
+template <class CharT>
+class basic_csv_columns
+{
+public:
+    using column_type = basic_csv_column<CharT>;
+private:
+    template <class C>
+    friend class basic_csv_column_decoder;
+
+    std::vector<column_type> columns_;
+    std::size_t row_count_;
+public:
+    basic_csv_columns()
+        : row_count_(0)
+    {
+    }
+
+    std::size_t row_count() const
+    {
+        return row_count_;
+    }
+
+    const std::vector<column_type>& columns() const
+    {
+        return columns_;
+    }
+
+    const column_type& operator[](std::size_t i) const
+    {
+        return columns_[i];
+    }
+
+    // Returns a pointer to the column with the given name, or nullptr
+    const column_type* find(const typename column_type::string_view_type& name) const
+    {
+        for (const auto& column : columns_)
+        {
+            if (name == typename column_type::string_view_type(column.name()))
+            {
+                return &column;
+            }
+        }
+        return nullptr;
+    }
+};
+
+// Decodes CSV into typed column buffers, without creating a basic_json
+// value for each field. Used as the visitor for a basic_csv_reader with
+// the n_objects mapping, where the header names the columns, or with the
+// n_rows mapping and no header, where columns are unnamed.
+// Values are typed by column_types if given, or else by type inference.
+// A column starts out with the kind of its first non-null value, integer
+// columns become float columns on encountering a float, and otherwise
+// columns with mixed kinds become string columns.
+// Multi-valued fields are not supported.
+template <class CharT>
+class basic_csv_column_decoder final : public basic_json_visitor<CharT>
+{
+public:
+    using char_type = CharT;
+    using typename basic_json_visitor<CharT>::string_view_type;
+    using string_type = std::basic_string<CharT>;
+private:
+    basic_csv_columns<CharT> result_;
+    std::unordered_map<string_type,std::size_t> column_index_map_;
+    std::size_t column_index_;
+    int level_;
+    bool is_valid_;
+public:
+    basic_csv_column_decoder()
+        : column_index_(0), level_(0), is_valid_(false)
+    {
+    }
+
+    bool is_valid() const
+    {
+        return is_valid_;
+    }
+
+    basic_csv_columns<CharT> get_result()
+    {
+        JSONCONS_ASSERT(is_valid_);
+        is_valid_ = false;
+        column_index_map_.clear();
+        return std::move(result_);
+    }
+
+    void reset()
+    {
+        result_ = basic_csv_columns<CharT>();
+        column_index_map_.clear();
+        column_index_ = 0;
+        level_ = 0;
+        is_valid_ = false;
+    }
+
+private:
+    void visit_flush() override
+    {
+    }
+
+    bool begin_row(std::error_code& ec)
+    {
+        switch (level_)
+        {
+            case 0:
+                result_ = basic_csv_columns<CharT>();
+                column_index_map_.clear();
+                is_valid_ = false;
+                break;
+            case 1:
+                column_index_ = 0;
+                break;
+            default:
+                ec = csv_errc::invalid_parse_state;
+                return false;
+        }
+        ++level_;
+        return true;
+    }
+
+    bool end_row()
+    {
+        --level_;
+        if (level_ == 1)
+        {
+            // Pad columns that did not get a value in this row
+            ++result_.row_count_;
+            for (auto& column : result_.columns_)
+            {
+                while (column.size() < result_.row_count_)
+                {
+                    column.push_null();
+                }
+            }
+        }
+        else if (level_ == 0)
+        {
+            is_valid_ = true;
+        }
+        return true;
+    }
+
+    bool visit_begin_object(semantic_tag, const ser_context&, std::error_code& ec) override
+    {
+        if (level_ != 1)
+        {
+            ec = csv_errc::invalid_parse_state;
+            return false;
+        }
+        return begin_row(ec);
+    }
+
+    bool visit_end_object(const ser_context&, std::error_code&) override
+    {
+        return end_row();
+    }
+
+    bool visit_begin_array(semantic_tag, const ser_context&, std::error_code& ec) override
+    {
+        return begin_row(ec);
+    }
+
+    bool visit_end_array(const ser_context&, std::error_code&) override
+    {
+        return end_row();
+    }
+
+    bool visit_key(const string_view_type& name, const ser_context&, std::error_code&) override
+    {
+        // Fast path for keys that arrive in column order
+        if (column_index_ < result_.columns_.size() && string_view_type(result_.columns_[column_index_].name()) == name)
+        {
+            return true;
+        }
+        auto it = column_index_map_.find(string_type(name.data(), name.length()));
+        if (it != column_index_map_.end())
+        {
+            column_index_ = it->second;
+        }
+        else
+        {
+            column_index_ = result_.columns_.size();
+            column_index_map_.emplace(string_type(name.data(), name.length()), column_index_);
+            new_column(name);
+        }
+        return true;
+    }
+
+    basic_csv_column<CharT>* current_column(std::error_code& ec)
+    {
+        if (level_ != 2)
+        {
+            ec = csv_errc::invalid_parse_state;
+            return nullptr;
+        }
+        if (column_index_ >= result_.columns_.size())
+        {
+            new_column(string_view_type());
+        }
+        auto& column = result_.columns_[column_index_];
+        // A repeated key, or a null padded in an earlier row
+        if (column.size() > result_.row_count_)
+        {
+            ec = csv_errc::invalid_parse_state;
+            return nullptr;
+        }
+        while (column.size() < result_.row_count_)
+        {
+            column.push_null();
+        }
+        return &column;
+    }
+
+    void new_column(const string_view_type& name)
+    {
+        result_.columns_.emplace_back(name);
+        auto& column = result_.columns_.back();
+        for (std::size_t i = 0; i < result_.row_count_; ++i)
+        {
+            column.push_null();
+        }
+    }
+
+    bool end_value()
+    {
+        ++column_index_;
+        return true;
+    }
+
+    bool visit_null(semantic_tag, const ser_context&, std::error_code& ec) override
+    {
+        auto column = current_column(ec);
+        if (column == nullptr)
+        {
+            return false;
+        }
+        column->push_null();
+        return end_value();
+    }
+
+    bool visit_string(const string_view_type& sv, semantic_tag, const ser_context&, std::error_code& ec) override
+    {
+        auto column = current_column(ec);
+        if (column == nullptr)
+        {
+            return false;
+        }
+        column->push_text(sv);
+        return end_value();
+    }
+
+    bool visit_byte_string(const byte_string_view&, semantic_tag, const ser_context&, std::error_code& ec) override
+    {
+        ec = csv_errc::invalid_parse_state;
+        return false;
+    }
+
+    bool visit_double(double val, semantic_tag, const ser_context&, std::error_code& ec) override
+    {
+        auto column = current_column(ec);
+        if (column == nullptr)
+        {
+            return false;
+        }
+        column->push_double(val);
+        return end_value();
+    }
+
+    bool visit_int64(int64_t val, semantic_tag, const ser_context&, std::error_code& ec) override
+    {
+        auto column = current_column(ec);
+        if (column == nullptr)
+        {
+            return false;
+        }
+        column->push_int64(val);
+        return end_value();
+    }
+
+    bool visit_uint64(uint64_t val, semantic_tag, const ser_context&, std::error_code& ec) override
+    {
+        auto column = current_column(ec);
+        if (column == nullptr)
+        {
+            return false;
+        }
+        if (val <= static_cast<uint64_t>((std::numeric_limits<int64_t>::max)()))
+        {
+            column->push_int64(static_cast<int64_t>(val));
+        }
+        else
+        {
+            column->push_double(static_cast<double>(val));
+        }
+        return end_value();
+    }
+
+    bool visit_bool(bool val, semantic_tag, const ser_context&, std::error_code& ec) override
+    {
+        auto column = current_column(ec);
+        if (column == nullptr)
+        {
+            return false;
+        }
+        column->push_bool(val);
+        return end_value();
+    }
+};
+
+using csv_column = basic_csv_column<char>;
+using csv_columns = basic_csv_columns<char>;
+using csv_column_decoder = basic_csv_column_decoder<char>;
+using wcsv_column = basic_csv_column<wchar_t>;
+using wcsv_columns = basic_csv_columns<wchar_t>;
+using wcsv_column_decoder = basic_csv_column_decoder<wchar_t>;
+
+}}
+
+#endif
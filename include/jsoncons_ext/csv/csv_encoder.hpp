@@ -35,7 +35,7 @@ public:
     using char_allocator_type = typename std::allocator_traits<allocator_type>:: template rebind_alloc<CharT>;
     using string_type = std::basic_string<CharT, std::char_traits<CharT>, char_allocator_type>;
     using string_allocator_type = typename std::allocator_traits<allocator_type>:: template rebind_alloc<string_type>;
-    using string_string_allocator_type = typename std::allocator_traits<allocator_type>:: template rebind_alloc<std::pair<const string_type,string_type>>;
+    using string_size_allocator_type = typename std::allocator_traits<allocator_type>:: template rebind_alloc<std::pair<const string_type,std::size_t>>;
 
 private:
     static const std::array<CharT, 4>& null_k()
@@ -95,8 +95,14 @@ private:
     jsoncons::detail::write_double fp_;
     std::vector<string_type,string_allocator_type> strings_buffer_;
 
-    std::unordered_map<string_type,string_type, std::hash<string_type>,std::equal_to<string_type>,string_string_allocator_type> buffered_line_;
-    string_type name_;
+    // Object rows are assembled in row_buffer_, with the cell for the column
+    // in slot i held in row_buffer_ at cell_ranges_[i] (offset, length)
+    std::unordered_map<string_type,std::size_t, std::hash<string_type>,std::equal_to<string_type>,string_size_allocator_type> column_slots_;
+    string_type row_buffer_;
+    std::vector<std::pair<std::size_t,std::size_t>> cell_ranges_;
+    std::size_t slot_;
+    std::size_t next_slot_;
+    bool in_cell_;
     std::size_t column_index_;
     std::vector<std::size_t> row_counts_;
 
@@ -118,9 +124,19 @@ public:
         alloc_(alloc),
         stack_(),
         fp_(options.float_format(), options.precision()),
+        column_slots_(alloc),
+        row_buffer_(alloc),
+        slot_(0),
+        next_slot_(0),
+        in_cell_(false),
         column_index_(0)
     {
         jsoncons::csv::detail::parse_column_names(options.column_names(), strings_buffer_);
+        for (std::size_t i = 0; i < strings_buffer_.size(); ++i)
+        {
+            column_slots_.emplace(strings_buffer_[i], i);
+        }
+        cell_ranges_.resize(strings_buffer_.size());
     }
 
     ~basic_csv_encoder() noexcept
@@ -175,6 +191,7 @@ private:
         {
             case stack_item_kind::row_mapping:
                 stack_.emplace_back(stack_item_kind::object);
+                next_slot_ = 0;
                 return true;
             default: // error
                 ec = csv_errc::source_error;
@@ -209,14 +226,14 @@ private:
                     {
                         sink_.push_back(options_.field_delimiter());
                     }
-                    auto it = buffered_line_.find(strings_buffer_[i]);
-                    if (it != buffered_line_.end())
+                    if (cell_ranges_[i].second > 0)
                     {
-                        sink_.append(it->second.data(),it->second.length());
-                        it->second.clear();
+                        sink_.append(row_buffer_.data() + cell_ranges_[i].first, cell_ranges_[i].second);
+                        cell_ranges_[i] = std::pair<std::size_t,std::size_t>(0, 0);
                     }
                 }
                 sink_.append(options_.line_delimiter().data(), options_.line_delimiter().length());
+                row_buffer_.clear();
                 break;
             case stack_item_kind::column_mapping:
              {
@@ -329,12 +346,27 @@ private:
         {
             case stack_item_kind::object:
             {
-                name_ = string_type(name);
-                buffered_line_[string_type(name)] = std::basic_string<CharT>();
                 if (stack_[0].count_ == 0 && options_.column_names().size() == 0)
                 {
                     strings_buffer_.emplace_back(name);
+                    column_slots_.emplace(strings_buffer_.back(), strings_buffer_.size()-1);
+                    cell_ranges_.resize(strings_buffer_.size());
+                }
+                // Fast path for keys that arrive in column order
+                if (next_slot_ < strings_buffer_.size() && string_view_type(strings_buffer_[next_slot_]) == name)
+                {
+                    slot_ = next_slot_;
+                }
+                else
+                {
+                    auto it = column_slots_.find(string_type(name.data(), name.length(), alloc_));
+                    slot_ = it != column_slots_.end() ? it->second : strings_buffer_.size();
                 }
+                if (slot_ < strings_buffer_.size())
+                {
+                    cell_ranges_[slot_] = std::pair<std::size_t,std::size_t>(0, 0);
+                }
+                next_slot_ = slot_ + 1;
                 break;
             }
             case stack_item_kind::column_mapping:
@@ -364,18 +396,11 @@ private:
             case stack_item_kind::object:
             case stack_item_kind::object_multi_valued_field:
             {
-                auto it = buffered_line_.find(name_);
-                if (it != buffered_line_.end())
+                if (begin_cell())
                 {
-                    std::basic_string<CharT> s;
-                    jsoncons::string_sink<std::basic_string<CharT>> bo(s);
+                    jsoncons::string_sink<string_type> bo(row_buffer_);
                     write_null_value(bo);
-                    bo.flush();
-                    if (!it->second.empty() && options_.subfield_delimiter() != char_type())
-                    {
-                        it->second.push_back(options_.subfield_delimiter());
-                    }
-                    it->second.append(s);
+                    end_cell();
                 }
                 break;
             }
@@ -413,18 +438,11 @@ private:
             case stack_item_kind::object:
             case stack_item_kind::object_multi_valued_field:
             {
-                auto it = buffered_line_.find(name_);
-                if (it != buffered_line_.end())
+                if (begin_cell())
                 {
-                    std::basic_string<CharT> s;
-                    jsoncons::string_sink<std::basic_string<CharT>> bo(s);
+                    jsoncons::string_sink<string_type> bo(row_buffer_);
                     write_string_value(sv,bo);
-                    bo.flush();
-                    if (!it->second.empty() && options_.subfield_delimiter() != char_type())
-                    {
-                        it->second.push_back(options_.subfield_delimiter());
-                    }
-                    it->second.append(s);
+                    end_cell();
                 }
                 break;
             }
@@ -518,18 +536,11 @@ private:
             case stack_item_kind::object:
             case stack_item_kind::object_multi_valued_field:
             {
-                auto it = buffered_line_.find(name_);
-                if (it != buffered_line_.end())
+                if (begin_cell())
                 {
-                    std::basic_string<CharT> s;
-                    jsoncons::string_sink<std::basic_string<CharT>> bo(s);
+                    jsoncons::string_sink<string_type> bo(row_buffer_);
                     write_double_value(val, context, bo, ec);
-                    bo.flush();
-                    if (!it->second.empty() && options_.subfield_delimiter() != char_type())
-                    {
-                        it->second.push_back(options_.subfield_delimiter());
-                    }
-                    it->second.append(s);
+                    end_cell();
                 }
                 break;
             }
@@ -570,18 +581,11 @@ private:
             case stack_item_kind::object:
             case stack_item_kind::object_multi_valued_field:
             {
-                auto it = buffered_line_.find(name_);
-                if (it != buffered_line_.end())
+                if (begin_cell())
                 {
-                    std::basic_string<CharT> s;
-                    jsoncons::string_sink<std::basic_string<CharT>> bo(s);
+                    jsoncons::string_sink<string_type> bo(row_buffer_);
                     write_int64_value(val,bo);
-                    bo.flush();
-                    if (!it->second.empty() && options_.subfield_delimiter() != char_type())
-                    {
-                        it->second.push_back(options_.subfield_delimiter());
-                    }
-                    it->second.append(s);
+                    end_cell();
                 }
                 break;
             }
@@ -622,18 +626,11 @@ private:
             case stack_item_kind::object:
             case stack_item_kind::object_multi_valued_field:
             {
-                auto it = buffered_line_.find(name_);
-                if (it != buffered_line_.end())
+                if (begin_cell())
                 {
-                    std::basic_string<CharT> s;
-                    jsoncons::string_sink<std::basic_string<CharT>> bo(s);
+                    jsoncons::string_sink<string_type> bo(row_buffer_);
                     write_uint64_value(val, bo);
-                    bo.flush();
-                    if (!it->second.empty() && options_.subfield_delimiter() != char_type())
-                    {
-                        it->second.push_back(options_.subfield_delimiter());
-                    }
-                    it->second.append(s);
+                    end_cell();
                 }
                 break;
             }
@@ -671,18 +668,11 @@ private:
             case stack_item_kind::object:
             case stack_item_kind::object_multi_valued_field:
             {
-                auto it = buffered_line_.find(name_);
-                if (it != buffered_line_.end())
+                if (begin_cell())
                 {
-                    std::basic_string<CharT> s;
-                    jsoncons::string_sink<std::basic_string<CharT>> bo(s);
+                    jsoncons::string_sink<string_type> bo(row_buffer_);
                     write_bool_value(val,bo);
-                    bo.flush();
-                    if (!it->second.empty() && options_.subfield_delimiter() != char_type())
-                    {
-                        it->second.push_back(options_.subfield_delimiter());
-                    }
-                    it->second.append(s);
+                    end_cell();
                 }
                 break;
             }
@@ -712,6 +702,38 @@ private:
         return true;
     }
 
+    // Positions the cell for the current column at the end of row_buffer_, returns
+    // false if the current key is not one of the columns
+    bool begin_cell()
+    {
+        if (slot_ >= cell_ranges_.size())
+        {
+            return false;
+        }
+        if (in_cell_) // nan, inf and neginf written as strings
+        {
+            return true;
+        }
+        auto& range = cell_ranges_[slot_];
+        if (range.second == 0)
+        {
+            range.first = row_buffer_.size();
+        }
+        else if (options_.subfield_delimiter() != char_type())
+        {
+            row_buffer_.push_back(options_.subfield_delimiter());
+        }
+        in_cell_ = true;
+        return true;
+    }
+
+    void end_cell()
+    {
+        auto& range = cell_ranges_[slot_];
+        range.second = row_buffer_.size() - range.first;
+        in_cell_ = false;
+    }
+
     template <class AnyWriter>
     bool string_value(const CharT* s, std::size_t length, AnyWriter& sink)
     {
@@ -0,0 +1,559 @@
+// Copyright 2020 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CSV_CSV_PARALLEL_READER_HPP
+#define JSONCONS_CSV_CSV_PARALLEL_READER_HPP
+
+#include <memory> // std::allocator
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception> // std::exception_ptr
+#include <limits> // std::numeric_limits
+#include <algorithm> // std::min, std::max
+#include <system_error>
+#include <jsoncons/config/jsoncons_config.hpp>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_visitor.hpp>
+#include <jsoncons/unicode_traits.hpp>
+#include <jsoncons_ext/csv/csv_error.hpp>
+#include <jsoncons_ext/csv/csv_options.hpp>
+#include <jsoncons_ext/csv/csv_parser.hpp>
+
+namespace jsoncons { namespace csv {
+
+namespace detail {
+
+    // Records the rows of one chunk as parse events, leaving out the
+    // enclosing array, and the header row repeated at the start of the chunk
+    template <class CharT,class TempAllocator>
+    class chunk_event_recorder : public basic_json_visitor<CharT>
+    {
+    public:
+        using string_view_type = typename basic_json_visitor<CharT>::string_view_type;
+        using parse_event_allocator_type = typename std::allocator_traits<TempAllocator>:: template rebind_alloc<parse_event<CharT,TempAllocator>>;
+        using parse_event_vector_type = std::vector<parse_event<CharT,TempAllocator>, parse_event_allocator_type>;
+    private:
+        TempAllocator alloc_;
+        parse_event_vector_type events_;
+        int level_;
+        std::size_t rows_to_skip_;
+        bool skipping_;
+    public:
+        chunk_event_recorder(std::size_t rows_to_skip, const TempAllocator& alloc)
+            : alloc_(alloc), events_(alloc), level_(0), rows_to_skip_(rows_to_skip), skipping_(false)
+        {
+        }
+
+        chunk_event_recorder(chunk_event_recorder&&) = default;
+
+        const parse_event_vector_type& events() const
+        {
+            return events_;
+        }
+
+    private:
+        bool begin_structure(staj_event_type event_type, semantic_tag tag)
+        {
+            ++level_;
+            if (level_ == 2 && rows_to_skip_ > 0)
+            {
+                --rows_to_skip_;
+                skipping_ = true;
+            }
+            if (level_ > 1 && !skipping_)
+            {
+                events_.emplace_back(event_type, tag, alloc_);
+            }
+            return true;
+        }
+
+        bool end_structure(staj_event_type event_type)
+        {
+            if (level_ > 1 && !skipping_)
+            {
+                events_.emplace_back(event_type, semantic_tag::none, alloc_);
+            }
+            if (level_ == 2)
+            {
+                skipping_ = false;
+            }
+            --level_;
+            return true;
+        }
+
+        template <class T>
+        bool value(T val, semantic_tag tag)
+        {
+            if (level_ > 1 && !skipping_)
+            {
+                events_.emplace_back(val, tag, alloc_);
+            }
+            return true;
+        }
+
+        void visit_flush() override
+        {
+        }
+
+        bool visit_begin_object(semantic_tag tag, const ser_context&, std::error_code&) override
+        {
+            return begin_structure(staj_event_type::begin_object, tag);
+        }
+
+        bool visit_end_object(const ser_context&, std::error_code&) override
+        {
+            return end_structure(staj_event_type::end_object);
+        }
+
+        bool visit_begin_array(semantic_tag tag, const ser_context&, std::error_code&) override
+        {
+            return begin_structure(staj_event_type::begin_array, tag);
+        }
+
+        bool visit_end_array(const ser_context&, std::error_code&) override
+        {
+            return end_structure(staj_event_type::end_array);
+        }
+
+        bool visit_key(const string_view_type& name, const ser_context&, std::error_code&) override
+        {
+            if (level_ > 1 && !skipping_)
+            {
+                events_.emplace_back(staj_event_type::key, name, alloc_);
+            }
+            return true;
+        }
+
+        bool visit_null(semantic_tag tag, const ser_context&, std::error_code&) override
+        {
+            if (level_ > 1 && !skipping_)
+            {
+                events_.emplace_back(staj_event_type::null_value, tag, alloc_);
+            }
+            return true;
+        }
+
+        bool visit_string(const string_view_type& val, semantic_tag tag, const ser_context&, std::error_code&) override
+        {
+            return value(val, tag);
+        }
+
+        bool visit_byte_string(const byte_string_view& val, semantic_tag tag, const ser_context&, std::error_code&) override
+        {
+            return value(val, tag);
+        }
+
+        bool visit_double(double val, semantic_tag tag, const ser_context&, std::error_code&) override
+        {
+            return value(val, tag);
+        }
+
+        bool visit_int64(int64_t val, semantic_tag tag, const ser_context&, std::error_code&) override
+        {
+            return value(val, tag);
+        }
+
+        bool visit_uint64(uint64_t val, semantic_tag tag, const ser_context&, std::error_code&) override
+        {
+            return value(val, tag);
+        }
+
+        bool visit_bool(bool val, semantic_tag tag, const ser_context&, std::error_code&) override
+        {
+            return value(val, tag);
+        }
+    };
+
+} // namespace detail
+
+// Parses a CSV text held in contiguous memory, for example a memory mapped
+// file, on several threads. The input is split into small chunks at record
+// boundaries found with a sequential pass that tracks quote parity. Worker
+// threads parse the chunks with their own basic_csv_parser, with the header
+// lines prepended, and the calling thread sends the rows of each chunk to the
+// visitor as soon as it and all earlier chunks are parsed. At most
+// 2*max_threads parsed chunks wait to be sent. The m_columns mapping and
+// max_lines are not supported in parallel, and such input is parsed on the
+// calling thread.
+template<class CharT,class Allocator=std::allocator<char>>
+class basic_csv_parallel_reader
+{
+public:
+    using char_type = CharT;
+    using string_view_type = jsoncons::basic_string_view<CharT>;
+    using temp_allocator_type = Allocator;
+
+    static constexpr std::size_t min_chunk_length = 65536;
+private:
+    struct chunk
+    {
+        const CharT* data;
+        std::size_t length;
+        std::size_t line; // line number of the first record of the chunk, as counted by the parser
+    };
+
+    struct chunk_result
+    {
+        detail::chunk_event_recorder<CharT,Allocator> recorder;
+        std::error_code ec;
+        std::size_t line;
+        std::size_t column;
+        std::exception_ptr exception;
+
+        chunk_result(std::size_t rows_to_skip, const Allocator& alloc)
+            : recorder(rows_to_skip, alloc), line(0), column(0)
+        {
+        }
+    };
+
+    // Hands out chunks to the workers, and parsed chunks to the calling thread in order
+    struct pipeline
+    {
+        std::mutex mutex;
+        std::condition_variable parsed;
+        std::condition_variable replayed;
+        std::vector<std::unique_ptr<chunk_result>> results;
+        std::size_t next_to_parse;
+        std::size_t next_to_replay;
+        std::size_t max_pending;
+        bool stop;
+
+        pipeline(std::size_t chunk_count, std::size_t max_pending)
+            : results(chunk_count), next_to_parse(0), next_to_replay(0), max_pending(max_pending), stop(false)
+        {
+        }
+    };
+
+    // Stops and joins the workers, also when the visitor throws
+    struct worker_guard
+    {
+        pipeline& state;
+        std::vector<std::thread>& threads;
+
+        ~worker_guard()
+        {
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                state.stop = true;
+            }
+            state.replayed.notify_all();
+            for (auto& t : threads)
+            {
+                t.join();
+            }
+        }
+    };
+
+    basic_json_visitor<CharT>& visitor_;
+    basic_csv_decode_options<CharT> options_;
+    Allocator alloc_;
+    string_view_type input_;
+    std::size_t max_threads_;
+    std::size_t line_;
+    std::size_t column_;
+    std::size_t chunk_count_;
+
+    // Noncopyable and nonmoveable
+    basic_csv_parallel_reader(const basic_csv_parallel_reader&) = delete;
+    basic_csv_parallel_reader& operator=(const basic_csv_parallel_reader&) = delete;
+public:
+    // max_threads 0 means std::thread::hardware_concurrency()
+    basic_csv_parallel_reader(const string_view_type& source,
+                              basic_json_visitor<CharT>& visitor,
+                              const basic_csv_decode_options<CharT>& options = basic_csv_decode_options<CharT>(),
+                              std::size_t max_threads = 0,
+                              const Allocator& alloc = Allocator())
+       : visitor_(visitor),
+         options_(options),
+         alloc_(alloc),
+         input_(source),
+         max_threads_(max_threads != 0 ? max_threads : (std::max)(std::thread::hardware_concurrency(), 1u)),
+         line_(1),
+         column_(1),
+         chunk_count_(0)
+    {
+        auto r = unicode_traits::detect_encoding_from_bom(input_.data(), input_.size());
+        if (!(r.encoding == unicode_traits::encoding_kind::utf8 || r.encoding == unicode_traits::encoding_kind::undetected))
+        {
+            JSONCONS_THROW(ser_error(json_errc::illegal_unicode_character,1,1));
+        }
+        std::size_t offset = (r.ptr - input_.data());
+        input_ = string_view_type(input_.data() + offset, input_.size() - offset);
+    }
+
+    void read()
+    {
+        std::error_code ec;
+        read(ec);
+        if (ec)
+        {
+            JSONCONS_THROW(ser_error(ec,line_,column_));
+        }
+    }
+
+    void read(std::error_code& ec)
+    {
+        std::vector<chunk> chunks;
+        std::size_t header_length = 0;
+        std::size_t header_lines = 0;
+        if (max_threads_ > 1 && options_.mapping() != mapping_kind::m_columns && 
+            options_.max_lines() == (std::numeric_limits<std::size_t>::max)())
+        {
+            split(chunks, header_length, header_lines);
+        }
+        chunk_count_ = (std::max)(chunks.size(), std::size_t(1));
+
+        if (chunks.size() <= 1)
+        {
+            read_sequential(ec);
+            return;
+        }
+
+        std::size_t header_rows = options_.assume_header() && options_.mapping() == mapping_kind::n_rows ? 1 : 0;
+        pipeline state(chunks.size(), 2*max_threads_);
+
+        std::vector<std::thread> threads;
+        worker_guard guard{state, threads};
+        threads.reserve(max_threads_);
+        for (std::size_t k = 0; k < max_threads_; ++k)
+        {
+            threads.emplace_back([this,&chunks,&state,header_length,header_lines,header_rows]()
+            {
+                parse_chunks(chunks, header_length, header_lines, header_rows, state);
+            });
+        }
+
+        bool more = visitor_.begin_array(semantic_tag::none, ser_context(), ec);
+        for (std::size_t i = 0; more && !ec && i < chunks.size(); ++i)
+        {
+            std::unique_ptr<chunk_result> result;
+            {
+                std::unique_lock<std::mutex> lock(state.mutex);
+                state.parsed.wait(lock, [&state,i]() {return state.results[i] != nullptr;});
+                result = std::move(state.results[i]);
+                ++state.next_to_replay;
+            }
+            state.replayed.notify_all();
+
+            if (result->exception)
+            {
+                std::rethrow_exception(result->exception);
+            }
+            if (result->ec)
+            {
+                ec = result->ec;
+                line_ = result->line;
+                column_ = result->column;
+                return;
+            }
+            for (const auto& event : result->recorder.events())
+            {
+                more = event.replay(visitor_, ec);
+                if (!more || ec)
+                {
+                    break;
+                }
+            }
+            if (ec)
+            {
+                // Rows aren't tracked, report the start of the chunk
+                line_ = chunks[i].line;
+                column_ = 1;
+                return;
+            }
+        }
+        if (more && !ec)
+        {
+            visitor_.end_array(ser_context(), ec);
+        }
+        if (!ec)
+        {
+            visitor_.flush();
+        }
+    }
+
+    std::size_t line() const
+    {
+        return line_;
+    }
+
+    std::size_t column() const
+    {
+        return column_;
+    }
+
+    // The number of chunks the input was split into by the last read
+    std::size_t chunk_count() const
+    {
+        return chunk_count_;
+    }
+
+private:
+    void read_sequential(std::error_code& ec)
+    {
+        basic_csv_parser<CharT,Allocator> parser(options_, alloc_);
+        parser.update(input_.data(), input_.size());
+        while (!parser.finished())
+        {
+            parser.parse_some(visitor_, ec);
+            if (ec)
+            {
+                break;
+            }
+        }
+        line_ = parser.line();
+        column_ = parser.column();
+    }
+
+    // Parses chunks in order of index, without getting more than max_pending
+    // chunks ahead of the calling thread
+    void parse_chunks(const std::vector<chunk>& chunks, std::size_t header_length, std::size_t header_lines,
+                      std::size_t header_rows, pipeline& state)
+    {
+        while (true)
+        {
+            std::size_t i;
+            {
+                std::unique_lock<std::mutex> lock(state.mutex);
+                state.replayed.wait(lock, [&state,&chunks]() 
+                {
+                    return state.stop || state.next_to_parse == chunks.size() || 
+                           state.next_to_parse < state.next_to_replay + state.max_pending;
+                });
+                if (state.stop || state.next_to_parse == chunks.size())
+                {
+                    return;
+                }
+                i = state.next_to_parse++;
+            }
+            std::unique_ptr<chunk_result> result(new chunk_result(i == 0 ? 0 : header_rows, alloc_));
+            parse_chunk(chunks[i], i == 0 ? 0 : header_length, i == 0 ? 0 : header_lines, *result);
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                state.results[i] = std::move(result);
+            }
+            state.parsed.notify_all();
+        }
+    }
+
+    void parse_chunk(const chunk& c, std::size_t header_length, std::size_t header_lines, chunk_result& result)
+    {
+        JSONCONS_TRY
+        {
+            basic_csv_parser<CharT,Allocator> parser(options_, alloc_);
+            if (header_length > 0)
+            {
+                parser.update(input_.data(), header_length);
+                parser.parse_some(result.recorder, result.ec);
+            }
+            if (!result.ec)
+            {
+                parser.update(c.data, c.length);
+                while (!parser.finished())
+                {
+                    parser.parse_some(result.recorder, result.ec);
+                    if (result.ec)
+                    {
+                        break;
+                    }
+                }
+            }
+            result.line = c.line + parser.line() - 1 - header_lines;
+            result.column = parser.column();
+        }
+        JSONCONS_CATCH(...)
+        {
+            result.exception = std::current_exception();
+        }
+    }
+
+    // Splits the input into chunks of about min_chunk_length chars that start at
+    // the beginning of a record, and finds the length of the header lines and the
+    // number of lines they take up. A line ends with \n, \r or \r\n.
+    void split(std::vector<chunk>& chunks, std::size_t& header_length, std::size_t& header_lines) const
+    {
+        const CharT quote_char = options_.quote_char();
+        const CharT quote_escape_char = options_.quote_escape_char();
+        const CharT comment_starter = options_.comment_starter();
+        const std::size_t header_line_count = options_.header_lines();
+        const std::size_t length = input_.size();
+        const CharT* data = input_.data();
+
+        std::size_t start = 0;
+        std::size_t start_line = 1;
+        std::size_t line = 1;
+        std::size_t records = 0;
+        bool quoted = false;
+        bool line_start = true;
+        header_length = 0;
+        header_lines = 0;
+
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            CharT c = data[i];
+            if (line_start && !quoted && comment_starter != CharT() && c == comment_starter)
+            {
+                while (i < length && data[i] != '\n' && data[i] != '\r')
+                {
+                    ++i;
+                }
+                if (i + 1 < length && data[i] == '\r' && data[i+1] == '\n')
+                {
+                    ++i;
+                }
+                ++line;
+                continue;
+            }
+            line_start = false;
+            if (quoted)
+            {
+                if (c == quote_escape_char && quote_escape_char != quote_char)
+                {
+                    ++i;
+                }
+                else if (c == quote_char)
+                {
+                    quoted = false;
+                }
+            }
+            else if (c == quote_char)
+            {
+                quoted = true;
+            }
+            else if (c == '\n' || c == '\r')
+            {
+                if (c == '\r' && i + 1 < length && data[i+1] == '\n')
+                {
+                    ++i;
+                }
+                ++line;
+                line_start = true;
+                ++records;
+                if (records == header_line_count)
+                {
+                    header_length = i + 1;
+                    header_lines = line - 1;
+                }
+                if (records > header_line_count && i + 1 - start >= min_chunk_length && i + 1 < length)
+                {
+                    chunks.push_back(chunk{data + start, i + 1 - start, start_line});
+                    start = i + 1;
+                    start_line = line;
+                }
+            }
+        }
+        chunks.push_back(chunk{data + start, length - start, start_line});
+    }
+};
+
+using csv_parallel_reader = basic_csv_parallel_reader<char>;
+using wcsv_parallel_reader = basic_csv_parallel_reader<wchar_t>;
+
+}}
+
+#endif
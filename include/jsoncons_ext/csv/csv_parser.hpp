@@ -14,6 +14,7 @@
 #include <stdexcept>
 #include <system_error>
 #include <cctype>
+#include <jsoncons/config/jsoncons_config.hpp>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/json_visitor.hpp>
 #include <jsoncons/json_reader.hpp>
@@ -23,6 +24,10 @@
 #include <jsoncons_ext/csv/csv_error.hpp>
 #include <jsoncons_ext/csv/csv_options.hpp>
 
+#if defined(JSONCONS_HAS_SSE2)
+#include <emmintrin.h>
+#endif
+
 namespace jsoncons { namespace csv {
 
 enum class csv_mode 
@@ -93,6 +98,96 @@ struct default_csv_parsing
 
 namespace detail {
 
+    // Finds the first of a small set of characters that end a run of plain
+    // field content, so that the run can be appended to the field buffer in
+    // one step rather than a character at a time
+    template <class CharT>
+    class special_char_scanner
+    {
+        static constexpr std::size_t max_chars = 5;
+
+        CharT chars_[max_chars];
+        std::size_t count_;
+    public:
+        special_char_scanner()
+            : count_(0)
+        {
+        }
+
+        void add(CharT c)
+        {
+            for (std::size_t i = 0; i < count_; ++i)
+            {
+                if (chars_[i] == c)
+                {
+                    return;
+                }
+            }
+            if (count_ < max_chars)
+            {
+                chars_[count_++] = c;
+            }
+        }
+
+        const CharT* find(const CharT* first, const CharT* last) const
+        {
+            return find_first_of(first, last);
+        }
+
+    private:
+        bool is_special(CharT c) const
+        {
+            for (std::size_t i = 0; i < count_; ++i)
+            {
+                if (c == chars_[i])
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template <class T>
+        const T* find_first_of(const T* first, const T* last) const
+        {
+            while (first != last && !is_special(*first))
+            {
+                ++first;
+            }
+            return first;
+        }
+
+#if defined(JSONCONS_HAS_SSE2)
+        const char* find_first_of(const char* first, const char* last) const
+        {
+            __m128i specials[max_chars];
+            for (std::size_t i = 0; i < count_; ++i)
+            {
+                specials[i] = _mm_set1_epi8(chars_[i]);
+            }
+            while (last - first >= 16)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+                __m128i matches = _mm_setzero_si128();
+                for (std::size_t i = 0; i < count_; ++i)
+                {
+                    matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, specials[i]));
+                }
+                if (_mm_movemask_epi8(matches) != 0)
+                {
+                    break;
+                }
+                first += 16;
+            }
+            while (first != last && !is_special(*first))
+            {
+                ++first;
+            }
+            return first;
+        }
+#endif
+    };
+
     template <class CharT,class TempAllocator>
     class parse_event
     {
@@ -131,6 +226,14 @@ namespace detail {
         {
         }
 
+        parse_event(staj_event_type event_type, const string_view_type& value, const TempAllocator& alloc)
+            : event_type(event_type), 
+              string_value(value.data(),value.length(),alloc), 
+              byte_string_value(alloc),
+              tag(semantic_tag::none)
+        {
+        }
+
         parse_event(const byte_string_view& value, semantic_tag tag, const TempAllocator& alloc)
             : event_type(staj_event_type::byte_string_value), 
               string_value(alloc),
@@ -181,26 +284,43 @@ namespace detail {
         parse_event& operator=(parse_event&&) = default;
 
         bool replay(basic_json_visitor<CharT>& visitor) const
+        {
+            std::error_code ec;
+            bool more = replay(visitor, ec);
+            if (ec)
+            {
+                JSONCONS_THROW(ser_error(ec));
+            }
+            return more;
+        }
+
+        bool replay(basic_json_visitor<CharT>& visitor, std::error_code& ec) const
         {
             switch (event_type)
             {
                 case staj_event_type::begin_array:
-                    return visitor.begin_array(tag, ser_context());
+                    return visitor.begin_array(tag, ser_context(), ec);
                 case staj_event_type::end_array:
-                    return visitor.end_array(ser_context());
+                    return visitor.end_array(ser_context(), ec);
+                case staj_event_type::begin_object:
+                    return visitor.begin_object(tag, ser_context(), ec);
+                case staj_event_type::end_object:
+                    return visitor.end_object(ser_context(), ec);
+                case staj_event_type::key:
+                    return visitor.key(string_value, ser_context(), ec);
                 case staj_event_type::string_value:
-                    return visitor.string_value(string_value, tag, ser_context());
+                    return visitor.string_value(string_value, tag, ser_context(), ec);
                 case staj_event_type::byte_string_value:
                 case staj_event_type::null_value:
-                    return visitor.null_value(tag, ser_context());
+                    return visitor.null_value(tag, ser_context(), ec);
                 case staj_event_type::bool_value:
-                    return visitor.bool_value(bool_value, tag, ser_context());
+                    return visitor.bool_value(bool_value, tag, ser_context(), ec);
                 case staj_event_type::int64_value:
-                    return visitor.int64_value(int64_value, tag, ser_context());
+                    return visitor.int64_value(int64_value, tag, ser_context(), ec);
                 case staj_event_type::uint64_value:
-                    return visitor.uint64_value(uint64_value, tag, ser_context());
+                    return visitor.uint64_value(uint64_value, tag, ser_context(), ec);
                 case staj_event_type::double_value:
-                    return visitor.double_value(double_value, tag, ser_context());
+                    return visitor.double_value(double_value, tag, ser_context(), ec);
                 default:
                     return false;
             }
@@ -535,6 +655,8 @@ private:
     std::vector<csv_parse_state,csv_parse_state_allocator_type> state_stack_;
     string_type buffer_;
     std::vector<std::pair<string_view_type,double>> string_double_map_;
+    detail::special_char_scanner<CharT> unquoted_scanner_;
+    detail::special_char_scanner<CharT> quoted_scanner_;
 
 public:
     basic_csv_parser(const TempAllocator& alloc = TempAllocator())
@@ -602,6 +724,17 @@ public:
         }
         stack_.push_back(csv_mode::initial);
 
+        unquoted_scanner_.add('\n');
+        unquoted_scanner_.add('\r');
+        unquoted_scanner_.add(options_.field_delimiter());
+        if (options_.subfield_delimiter() != char_type())
+        {
+            unquoted_scanner_.add(options_.subfield_delimiter());
+        }
+        unquoted_scanner_.add(options_.quote_char());
+        quoted_scanner_.add(options_.quote_char());
+        quoted_scanner_.add(options_.quote_escape_char());
+
         jsoncons::csv::detail::parse_column_names(options.column_names(), column_names_);
         jsoncons::csv::detail::parse_column_types(options.column_types(), column_types_);
         jsoncons::csv::detail::parse_column_names(options.column_defaults(), column_defaults_);
@@ -908,7 +1041,12 @@ public:
                         }
                         else
                         {
-                            buffer_.push_back(static_cast<CharT>(curr_char));
+                            const CharT* run_end = quoted_scanner_.find(input_ptr_ + 1, local_input_end);
+                            std::size_t n = static_cast<std::size_t>(run_end - input_ptr_);
+                            buffer_.append(input_ptr_, n);
+                            column_ += n;
+                            input_ptr_ = run_end;
+                            break;
                         }
                     }
                     ++column_;
@@ -1135,9 +1273,11 @@ public:
                             }
                             else
                             {
-                                buffer_.push_back(static_cast<CharT>(curr_char));
-                                ++column_;
-                                ++input_ptr_;
+                                const CharT* run_end = unquoted_scanner_.find(input_ptr_ + 1, local_input_end);
+                                std::size_t n = static_cast<std::size_t>(run_end - input_ptr_);
+                                buffer_.append(input_ptr_, n);
+                                column_ += n;
+                                input_ptr_ = run_end;
                             }
                             break;
                     }
@@ -11,6 +11,7 @@
 #include <vector>
 #include <unordered_map> // std::unordered_map
 #include <memory>
+#include <mutex> // std::mutex
 #include <type_traits> // std::is_const
 #include <limits> // std::numeric_limits
 #include <utility> // std::move
@@ -316,11 +317,51 @@ namespace jmespath {
 
         // dynamic_resources
 
+        // Owns the temporaries created while evaluating an expression. They are
+        // allocated from fixed size blocks, and reset() destroys them but keeps
+        // the blocks, so repeated evaluations with the same resources do not
+        // allocate storage for their intermediate results.
         class dynamic_resources
         {
-            std::vector<std::unique_ptr<Json>> temp_storage_;
+            static constexpr std::size_t block_capacity = 64;
+
+            using storage_type = typename std::aligned_storage<sizeof(Json), alignof(Json)>::type;
+
+            struct block
+            {
+                storage_type slots[block_capacity];
+            };
+
+            std::vector<std::unique_ptr<block>> blocks_;
+            std::size_t size_;
 
         public:
+            dynamic_resources()
+                : size_(0)
+            {
+            }
+
+            dynamic_resources(const dynamic_resources&) = delete;
+            dynamic_resources& operator=(const dynamic_resources&) = delete;
+
+            ~dynamic_resources() noexcept
+            {
+                reset();
+            }
+
+            // Destroys all temporaries, retaining their storage for reuse.
+            // Containers are created before the temporaries they refer to, and
+            // destroying a container inspects its elements, so destroy in
+            // creation order.
+            void reset() noexcept
+            {
+                for (std::size_t i = 0; i < size_; ++i)
+                {
+                    slot(i)->~Json();
+                }
+                size_ = 0;
+            }
+
             reference number_type_name() 
             {
                 static Json number_type_name(string_type({'n','u','m','b','e','r'}));
@@ -384,11 +425,30 @@ namespace jmespath {
             template <typename... Args>
             Json* create_json(Args&& ... args)
             {
-                auto temp = jsoncons::make_unique<Json>(std::forward<Args>(args)...);
-                Json* ptr = temp.get();
-                temp_storage_.emplace_back(std::move(temp));
+                if (size_ == blocks_.size()*block_capacity)
+                {
+                    blocks_.emplace_back(jsoncons::make_unique<block>());
+                }
+                Json* ptr = ::new(static_cast<void*>(slot(size_))) Json(std::forward<Args>(args)...);
+                ++size_;
                 return ptr;
             }
+            // Creates an array that refers to the elements of arr rather than copying them
+            Json* create_array_view(reference arr)
+            {
+                Json* result = create_json(json_array_arg);
+                result->reserve(arr.size());
+                for (reference item : arr.array_range())
+                {
+                    result->emplace_back(json_const_pointer_arg, std::addressof(item));
+                }
+                return result;
+            }
+        private:
+            Json* slot(std::size_t n)
+            {
+                return reinterpret_cast<Json*>(&blocks_[n / block_capacity]->slots[n % block_capacity]);
+            }
         };
 
         static bool is_false(reference ref)
@@ -512,6 +572,18 @@ namespace jmespath {
 
             virtual void add_expression(std::unique_ptr<expression_base>&& expressions) = 0;
 
+            // True for a chain of object member lookups, such as a.b.c
+            virtual bool is_identifier_selector() const
+            {
+                return false;
+            }
+
+            // True if the result does not depend on the value the expression is applied to
+            virtual bool is_constant() const
+            {
+                return false;
+            }
+
             virtual std::string to_string(std::size_t = 0) const
             {
                 return std::string("to_string not implemented");
@@ -1400,7 +1472,7 @@ namespace jmespath {
                     }
                 }
 
-                auto v = resources.create_json(arg0);
+                auto v = resources.create_array_view(arg0);
                 std::stable_sort((v->array_range()).begin(), (v->array_range()).end());
                 return *v;
             }
@@ -1437,7 +1509,7 @@ namespace jmespath {
 
                 const auto& expr = args[1].expression();
 
-                auto v = resources.create_json(arg0);
+                auto v = resources.create_array_view(arg0);
                 std::stable_sort((v->array_range()).begin(), (v->array_range()).end(),
                     [&expr,&resources,&ec](reference lhs, reference rhs) -> bool
                 {
@@ -1529,11 +1601,11 @@ namespace jmespath {
                 }
 
                 auto result = resources.create_json(json_array_arg);
-                result->reserve(args.size());
+                result->reserve(arg0.size());
 
                 for (auto& item : arg0.object_range())
                 {
-                    result->emplace_back(item.value());
+                    result->emplace_back(json_const_pointer_arg, std::addressof(item.value()));
                 }
                 return *result;
             }
@@ -1572,7 +1644,7 @@ namespace jmespath {
                     }
                     case json_type::array_value:
                     {
-                        auto result = resources.create_json(arg0);
+                        auto result = resources.create_array_view(arg0);
                         std::reverse(result->array_range().begin(),result->array_range().end());
                         return *result;
                     }
@@ -1694,7 +1766,7 @@ namespace jmespath {
                 else
                 {
                     auto result = resources.create_json(json_array_arg);
-                    result->push_back(arg0);
+                    result->emplace_back(json_const_pointer_arg, std::addressof(arg0));
                     return *result;
                 }
             }
@@ -2285,6 +2357,86 @@ namespace jmespath {
             return std::addressof(stack.back().value());
         }
 
+        // Rewrites a token list into an equivalent one that is cheaper to evaluate.
+        // Consecutive member lookups are fused into one selector, and operators,
+        // expressions and function calls whose operands are all literals are
+        // replaced by their results. A sub-expression that fails is left as it
+        // is, so the error is reported when the expression is evaluated.
+        static void optimize_tokens(std::vector<token>& tokens)
+        {
+            std::vector<token> result;
+            result.reserve(tokens.size());
+
+            for (auto& tok : tokens)
+            {
+                switch (tok.type())
+                {
+                    case token_kind::expression:
+                    {
+                        if (result.empty())
+                        {
+                            break;
+                        }
+                        token& prev = result.back();
+                        if (prev.is_expression() && prev.expression_->is_identifier_selector() && tok.expression_->is_identifier_selector())
+                        {
+                            static_cast<identifier_selector&>(*prev.expression_).append(std::move(static_cast<identifier_selector&>(*tok.expression_)));
+                            continue;
+                        }
+                        if (prev.type() == token_kind::literal || (prev.is_current_node() && tok.expression_->is_constant()))
+                        {
+                            dynamic_resources resources;
+                            std::error_code ec;
+                            reference val = prev.type() == token_kind::literal ? prev.value_ : resources.null_value();
+                            Json folded = deep_copy(tok.expression_->evaluate(val, resources, ec));
+                            if (!ec)
+                            {
+                                prev = token(literal_arg, std::move(folded));
+                                continue;
+                            }
+                        }
+                        break;
+                    }
+                    case token_kind::unary_operator:
+                    {
+                        if (!result.empty() && result.back().type() == token_kind::literal)
+                        {
+                            dynamic_resources resources;
+                            std::error_code ec;
+                            Json folded = deep_copy(tok.unary_operator_->evaluate(result.back().value_, resources, ec));
+                            if (!ec)
+                            {
+                                result.back() = token(literal_arg, std::move(folded));
+                                continue;
+                            }
+                        }
+                        break;
+                    }
+                    case token_kind::binary_operator:
+                    {
+                        std::size_t n = result.size();
+                        if (n >= 2 && result[n-2].type() == token_kind::literal && result[n-1].type() == token_kind::literal)
+                        {
+                            dynamic_resources resources;
+                            std::error_code ec;
+                            Json folded = deep_copy(tok.binary_operator_->evaluate(result[n-2].value_, result[n-1].value_, resources, ec));
+                            if (!ec)
+                            {
+                                result.pop_back();
+                                result.back() = token(literal_arg, std::move(folded));
+                                continue;
+                            }
+                        }
+                        break;
+                    }
+                    default:
+                        break;
+                }
+                result.emplace_back(std::move(tok));
+            }
+            tokens = std::move(result);
+        }
+
         // Implementations
 
         class or_operator final : public binary_operator
@@ -2538,24 +2690,45 @@ namespace jmespath {
         class identifier_selector final : public selector_base
         {
         private:
-            string_type identifier_;
+            std::vector<string_type> identifiers_;
         public:
             identifier_selector(const string_view_type& name)
-                : identifier_(name)
             {
+                identifiers_.emplace_back(name.data(), name.size());
             }
 
-            reference evaluate(reference val, dynamic_resources& resources, std::error_code&) const override
+            bool is_identifier_selector() const override
             {
-                //std::cout << "(identifier_selector " << identifier_  << " ) " << pretty_print(val) << "\n";
-                if (val.is_object() && val.contains(identifier_))
+                return true;
+            }
+
+            // Appends the lookups of a selector that is applied to the result of this one
+            void append(identifier_selector&& other)
+            {
+                for (auto& id : other.identifiers_)
                 {
-                    return val.at(identifier_);
+                    identifiers_.emplace_back(std::move(id));
                 }
-                else 
+                other.identifiers_.clear();
+            }
+
+            reference evaluate(reference val, dynamic_resources& resources, std::error_code&) const override
+            {
+                pointer ptr = std::addressof(val);
+                for (const auto& id : identifiers_)
                 {
-                    return resources.null_value();
+                    if (!ptr->is_object())
+                    {
+                        return resources.null_value();
+                    }
+                    auto it = ptr->find(id);
+                    if (it == ptr->object_range().end())
+                    {
+                        return resources.null_value();
+                    }
+                    ptr = std::addressof(it->value());
                 }
+                return *ptr;
             }
 
             std::string to_string(std::size_t indent = 0) const override
@@ -2566,7 +2739,14 @@ namespace jmespath {
                     s.push_back(' ');
                 }
                 s.append("identifier_selector ");
-                s.append(identifier_);
+                for (std::size_t i = 0; i < identifiers_.size(); ++i)
+                {
+                    if (i > 0)
+                    {
+                        s.push_back('.');
+                    }
+                    s.append(identifiers_[i].begin(), identifiers_[i].end());
+                }
                 return s;
             }
         };
@@ -2659,6 +2839,10 @@ namespace jmespath {
                 {
                     expressions_.back()->add_expression(std::move(expr));
                 }
+                else if (!expressions_.empty() && expressions_.back()->is_identifier_selector() && expr->is_identifier_selector())
+                {
+                    static_cast<identifier_selector&>(*expressions_.back()).append(std::move(static_cast<identifier_selector&>(*expr)));
+                }
                 else
                 {
                     expressions_.emplace_back(std::move(expr));
@@ -2861,11 +3045,27 @@ namespace jmespath {
 
         class filter_expression final : public projection_base
         {
+            enum class condition_kind {general, expression, comparison};
+
             std::vector<token> token_list_;
+            condition_kind kind_;
         public:
             filter_expression(std::vector<token>&& token_list)
-                : projection_base(11, true), token_list_(std::move(token_list))
+                : projection_base(11, true), token_list_(std::move(token_list)), kind_(condition_kind::general)
             {
+                optimize_tokens(token_list_);
+
+                // Conditions such as [?a.b] and [?a.b == 'lit'] are evaluated
+                // directly rather than through the token interpreter
+                if (token_list_.size() == 2 && token_list_[0].is_current_node() && token_list_[1].is_expression())
+                {
+                    kind_ = condition_kind::expression;
+                }
+                else if (token_list_.size() == 4 && token_list_[0].is_current_node() && token_list_[1].is_expression()
+                         && token_list_[2].type() == token_kind::literal && token_list_[3].type() == token_kind::binary_operator)
+                {
+                    kind_ = condition_kind::comparison;
+                }
             }
 
             reference evaluate(reference val, dynamic_resources& resources, std::error_code& ec) const override
@@ -2878,8 +3078,7 @@ namespace jmespath {
 
                 for (auto& item : val.array_range())
                 {
-                    Json j(json_const_pointer_arg, evaluate_tokens(item, token_list_, resources, ec));
-                    if (is_true(j))
+                    if (is_true(evaluate_condition(item, resources, ec)))
                     {
                         reference jj = this->apply_expressions(item, resources, ec);
                         if (!jj.is_null())
@@ -2907,6 +3106,22 @@ namespace jmespath {
                 }
                 return s;
             }
+        private:
+            reference evaluate_condition(reference item, dynamic_resources& resources, std::error_code& ec) const
+            {
+                switch (kind_)
+                {
+                    case condition_kind::expression:
+                        return token_list_[1].expression_->evaluate(item, resources, ec);
+                    case condition_kind::comparison:
+                    {
+                        reference lhs = token_list_[1].expression_->evaluate(item, resources, ec);
+                        return token_list_[3].binary_operator_->evaluate(lhs, token_list_[2].value_, resources, ec);
+                    }
+                    default:
+                        return *evaluate_tokens(item, token_list_, resources, ec);
+                }
+            }
         };
 
         class flatten_projection final : public projection_base
@@ -2981,6 +3196,10 @@ namespace jmespath {
             multi_select_list(std::vector<std::vector<token>>&& token_lists)
                 : token_lists_(std::move(token_lists))
             {
+                for (auto& list : token_lists_)
+                {
+                    optimize_tokens(list);
+                }
             }
 
             reference evaluate(reference val, dynamic_resources& resources, std::error_code& ec) const override
@@ -3040,6 +3259,10 @@ namespace jmespath {
             multi_select_hash(std::vector<key_tokens>&& key_toks)
                 : key_toks_(std::move(key_toks))
             {
+                for (auto& item : key_toks_)
+                {
+                    optimize_tokens(item.tokens);
+                }
             }
 
             reference evaluate(reference val, dynamic_resources& resources, std::error_code& ec) const override
@@ -3078,6 +3301,25 @@ namespace jmespath {
             function_expression(std::vector<token>&& toks)
                 : toks_(std::move(toks))
             {
+                optimize_tokens(toks_);
+            }
+
+            // A function called with literal arguments only
+            bool is_constant() const override
+            {
+                for (const auto& tok : toks_)
+                {
+                    switch (tok.type())
+                    {
+                        case token_kind::literal:
+                        case token_kind::argument:
+                        case token_kind::function:
+                            break;
+                        default:
+                            return false;
+                    }
+                }
+                return !toks_.empty() && toks_.back().type() == token_kind::function;
             }
 
             reference evaluate(reference val, dynamic_resources& resources, std::error_code& ec) const override
@@ -3247,10 +3489,19 @@ namespace jmespath {
 
         class jmespath_expression
         {
+            // Temporaries retained between evaluations of this expression
+            struct evaluation_cache
+            {
+                std::mutex mutex;
+                dynamic_resources resources;
+            };
+
             static_resources resources_;
             std::vector<token> output_stack_;
+            std::unique_ptr<evaluation_cache> cache_;
         public:
             jmespath_expression()
+                : cache_(jsoncons::make_unique<evaluation_cache>())
             {
             }
 
@@ -3259,14 +3510,17 @@ namespace jmespath {
 
             jmespath_expression(jmespath_expression&& expr)
                 : resources_(std::move(expr.resources_)),
-                  output_stack_(std::move(expr.output_stack_))
+                  output_stack_(std::move(expr.output_stack_)),
+                  cache_(std::move(expr.cache_))
             {
             }
 
             jmespath_expression(static_resources&& resources,
                                 std::vector<token>&& output_stack)
-                : resources_(std::move(resources)), output_stack_(std::move(output_stack))
+                : resources_(std::move(resources)), output_stack_(std::move(output_stack)),
+                  cache_(jsoncons::make_unique<evaluation_cache>())
             {
+                optimize_tokens(output_stack_);
             }
 
             Json evaluate(reference doc)
@@ -3290,6 +3544,20 @@ namespace jmespath {
                 {
                     return Json::null();
                 }
+                if (cache_)
+                {
+                    // Reuse the storage of previous evaluations, unless another
+                    // thread is evaluating this expression right now
+                    std::unique_lock<std::mutex> lock(cache_->mutex, std::try_to_lock);
+                    if (lock.owns_lock())
+                    {
+                        dynamic_resources& dynamic_storage = cache_->resources;
+                        dynamic_storage.reset();
+                        Json result = deep_copy(*evaluate_tokens(doc, output_stack_, dynamic_storage, ec));
+                        dynamic_storage.reset();
+                        return result;
+                    }
+                }
                 dynamic_resources dynamic_storage;
                 return deep_copy(*evaluate_tokens(doc, output_stack_, dynamic_storage, ec));
             }
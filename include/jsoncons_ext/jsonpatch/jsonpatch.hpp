@@ -12,6 +12,7 @@
 #include <memory>
 #include <algorithm> // std::min
 #include <utility> // std::move
+#include <unordered_map> // std::unordered_map
 #include <jsoncons/json.hpp>
 #include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
 #include <jsoncons_ext/jsonpatch/jsonpatch_error.hpp>
@@ -20,53 +21,6 @@ namespace jsoncons { namespace jsonpatch {
 
 namespace detail {
 
-    template<class Json>
-    std::basic_string<typename Json::char_type> normalized_path(const Json& root, const typename Json::string_view_type& location)
-    {
-        using string_type = std::basic_string<typename Json::char_type>;
-        using string_view_type = typename Json::string_view_type;
-
-        std::error_code ec;
-
-        const Json* current = std::addressof(root);
-        if (location.empty())
-        {
-            return string_type();
-        }
-
-        string_type buffer;
-        jsonpointer::json_pointer_iterator<typename string_view_type::iterator> it(location.begin(), location.end());
-        jsonpointer::json_pointer_iterator<typename string_view_type::iterator> end(location.begin(), location.end(), location.end());
-        while (it != end)
-        {
-            buffer = *it;
-            it.increment(ec);
-            if (ec)
-                return string_type(location);
-            if (it != end)
-            {
-                current = jsoncons::jsonpointer::detail::resolve(current, buffer, ec);
-                if (ec)
-                    return string_type(location);
-            }
-        }
-
-        if (current->is_array() && buffer.size() == 1 && buffer[0] == '-')
-        {
-            string_type p = string_type(location.substr(0,location.length()-1));
-            std::string s = std::to_string(current->size());
-            for (auto c : s)
-            {
-                p.push_back(c);
-            }
-            return p;
-        }
-        else
-        {
-            return string_type(location);
-        }
-    }
-
     JSONCONS_STRING_LITERAL(test_literal,'t','e','s','t')
     JSONCONS_STRING_LITERAL(add_literal,'a','d','d')
     JSONCONS_STRING_LITERAL(remove_literal,'r','e','m','o','v','e')
@@ -78,460 +32,1196 @@ namespace detail {
     JSONCONS_STRING_LITERAL(from_literal,'f','r','o','m')
     JSONCONS_STRING_LITERAL(value_literal,'v','a','l','u','e')
 
-    enum class op_type {add,remove,replace};
-    enum class state_type {begin,abort,commit};
-
+    // Applies the operations of a patch in place. Each path is parsed once, and the 
+    // containers along the last path resolved are kept, so that consecutive operations 
+    // on the same parent don't resolve it again. Removed and replaced values are moved 
+    // into the undo log, not copied, and the log is replayed backwards if an operation fails
+    // or throws. Room for an entry is reserved before the target is changed, so recording
+    // a change that has been made doesn't allocate.
     template <class Json>
-    struct operation_unwinder
+    class patch_applier
     {
         using char_type = typename Json::char_type;
         using string_type = std::basic_string<char_type>;
         using string_view_type = typename Json::string_view_type;
+        using path_type = std::vector<string_type>;
+
+        enum class op_type {add,remove,replace,move};
 
         struct entry
         {
             op_type op;
-            string_type path;
+            path_type path;
+            path_type from;
             Json value;
+            bool replaced;
 
-            entry(op_type op, const string_type& path, const Json& value)
-                : op(op), path(path), value(value)
+            entry(op_type op_, path_type&& path_, Json&& value_)
+                : op(op_), path(std::move(path_)), value(std::move(value_)), replaced(false)
             {
             }
 
-            entry(const entry&) = default;
-
-            entry(entry&&) = default;
-
-            entry& operator=(const entry&) = default;
-
-            entry& operator=(entry&&) = default;
+            entry(path_type&& path_, path_type&& from_, Json&& value_, bool replaced_)
+                : op(op_type::move), path(std::move(path_)), from(std::move(from_)), value(std::move(value_)), replaced(replaced_)
+            {
+            }
         };
 
-        Json& target;
-        state_type state;
-        std::vector<entry> stack;
+        Json& root_;
+        bool rollback_;
+        std::vector<entry> undo_;
+        path_type path_;
+        path_type from_;
+        // cached_nodes_[k] is the value at the first k tokens of cached_path_
+        path_type cached_path_;
+        std::vector<Json*> cached_nodes_;
 
-        operation_unwinder(Json& j)
-            : target(j), state(state_type::begin)
+    public:
+        patch_applier(Json& root, bool rollback)
+            : root_(root), rollback_(rollback)
         {
+            cached_nodes_.push_back(std::addressof(root_));
         }
 
-        ~operation_unwinder() noexcept
+        void apply(const Json& patch, std::error_code& ec)
         {
-            std::error_code ec;
-            //std::cout << "state: " << std::boolalpha << (state == state_type::commit) << ", stack size: " << stack.size() << std::endl;
-            if (state != state_type::commit)
+            if (!patch.is_array())
+            {
+                ec = jsonpatch_errc::invalid_patch;
+                return;
+            }
+            JSONCONS_TRY
             {
-                for (auto it = stack.rbegin(); it != stack.rend(); ++it)
+                for (const auto& operation : patch.array_range())
                 {
-                    if (it->op == op_type::add)
+                    apply_operation(operation, ec);
+                    if (ec)
                     {
-                        jsonpointer::add(target,it->path,it->value,ec);
-                        if (ec)
+                        if (rollback_)
                         {
-                            //std::cout << "add: " << it->path << std::endl;
-                            break;
+                            undo();
                         }
+                        return;
                     }
-                    else if (it->op == op_type::remove)
+                }
+            }
+            JSONCONS_CATCH(...)
+            {
+                if (rollback_)
+                {
+                    undo();
+                }
+                JSONCONS_RETHROW;
+            }
+        }
+
+    private:
+
+        static const Json* member(const Json& operation, const string_view_type& name)
+        {
+            auto it = operation.find(name);
+            return it == operation.object_range().end() ? nullptr : std::addressof(it->value());
+        }
+
+        void apply_operation(const Json& operation, std::error_code& ec)
+        {
+            const Json* op = operation.is_object() ? member(operation, op_literal<char_type>()) : nullptr;
+            const Json* path = operation.is_object() ? member(operation, path_literal<char_type>()) : nullptr;
+            if (op == nullptr || path == nullptr || !op->is_string() || !path->is_string())
+            {
+                ec = jsonpatch_errc::invalid_patch;
+                return;
+            }
+            string_view_type name = op->as_string_view();
+
+            if (name == test_literal<char_type>())
+            {
+                const Json* value = member(operation, value_literal<char_type>());
+                if (value == nullptr)
+                {
+                    ec = jsonpatch_errc::invalid_patch;
+                    return;
+                }
+                const Json* current = parse(path->as_string_view(), path_) ? find(path_) : nullptr;
+                if (current == nullptr || *current != *value)
+                {
+                    ec = jsonpatch_errc::test_failed;
+                }
+            }
+            else if (name == add_literal<char_type>())
+            {
+                const Json* value = member(operation, value_literal<char_type>());
+                if (value == nullptr)
+                {
+                    ec = jsonpatch_errc::invalid_patch;
+                    return;
+                }
+                if (!parse(path->as_string_view(), path_) || !add(path_, Json(*value)))
+                {
+                    ec = jsonpatch_errc::add_failed;
+                }
+            }
+            else if (name == remove_literal<char_type>())
+            {
+                Json value;
+                reserve_entry();
+                if (!parse(path->as_string_view(), path_) || !extract(path_, value))
+                {
+                    ec = jsonpatch_errc::remove_failed;
+                    return;
+                }
+                if (rollback_)
+                {
+                    undo_.emplace_back(op_type::add, std::move(path_), std::move(value));
+                }
+            }
+            else if (name == replace_literal<char_type>())
+            {
+                const Json* value = member(operation, value_literal<char_type>());
+                if (value == nullptr)
+                {
+                    ec = jsonpatch_errc::invalid_patch;
+                    return;
+                }
+                Json old;
+                reserve_entry();
+                if (!parse(path->as_string_view(), path_) || !replace(path_, Json(*value), old))
+                {
+                    ec = jsonpatch_errc::replace_failed;
+                    return;
+                }
+                if (rollback_)
+                {
+                    undo_.emplace_back(op_type::replace, std::move(path_), std::move(old));
+                }
+            }
+            else if (name == move_literal<char_type>())
+            {
+                const Json* from = member(operation, from_literal<char_type>());
+                if (from == nullptr || !from->is_string())
+                {
+                    ec = jsonpatch_errc::invalid_patch;
+                    return;
+                }
+                if (!parse(path->as_string_view(), path_) || !parse(from->as_string_view(), from_) || !move(from_, path_))
+                {
+                    ec = jsonpatch_errc::move_failed;
+                }
+            }
+            else if (name == copy_literal<char_type>())
+            {
+                const Json* from = member(operation, from_literal<char_type>());
+                if (from == nullptr || !from->is_string())
+                {
+                    ec = jsonpatch_errc::invalid_patch;
+                    return;
+                }
+                const Json* value = parse(from->as_string_view(), from_) ? find(from_) : nullptr;
+                if (value == nullptr || !parse(path->as_string_view(), path_) || !add(path_, Json(*value)))
+                {
+                    ec = jsonpatch_errc::copy_failed;
+                }
+            }
+            else
+            {
+                ec = jsonpatch_errc::invalid_patch;
+            }
+        }
+
+        bool add(path_type& path, Json&& value)
+        {
+            bool replaced = false;
+            Json old;
+            reserve_entry();
+            if (!insert(path, std::move(value), replaced, old))
+            {
+                return false;
+            }
+            if (rollback_)
+            {
+                if (replaced)
+                {
+                    undo_.emplace_back(op_type::replace, std::move(path), std::move(old));
+                }
+                else
+                {
+                    undo_.emplace_back(op_type::remove, std::move(path), Json());
+                }
+            }
+            return true;
+        }
+
+        bool move(path_type& from, path_type& path)
+        {
+            if (from.size() <= path.size() && std::equal(from.begin(), from.end(), path.begin()))
+            {
+                // A value can't be moved into one of its children, and moving it to where it is does nothing
+                return from.size() == path.size() && find(from) != nullptr;
+            }
+            Json value;
+            reserve_entry();
+            if (!extract(from, value))
+            {
+                return false;
+            }
+            bool replaced = false;
+            Json old;
+            bool inserted = false;
+            JSONCONS_TRY
+            {
+                inserted = insert(path, std::move(value), replaced, old);
+            }
+            JSONCONS_CATCH(...)
+            {
+                // Put it back, it isn't in the undo log yet
+                bool ignored;
+                insert_at(from, std::move(value), ignored, old);
+                JSONCONS_RETHROW;
+            }
+            if (!inserted)
+            {
+                // Put it back, value is unchanged when insert fails
+                bool ignored;
+                insert_at(from, std::move(value), ignored, old);
+                return false;
+            }
+            if (rollback_)
+            {
+                undo_.emplace_back(std::move(path), std::move(from), std::move(old), replaced);
+            }
+            return true;
+        }
+
+        // Makes room for one more entry in the undo log
+        void reserve_entry()
+        {
+            if (rollback_ && undo_.size() == undo_.capacity())
+            {
+                undo_.reserve(2*undo_.size() + 1);
+            }
+        }
+
+        // Replays the undo log backwards
+        void undo()
+        {
+            for (auto it = undo_.rbegin(); it != undo_.rend(); ++it)
+            {
+                Json value;
+                bool replaced;
+                switch (it->op)
+                {
+                    case op_type::add:
+                        insert_at(it->path, std::move(it->value), replaced, value);
+                        break;
+                    case op_type::remove:
+                        extract(it->path, value);
+                        break;
+                    case op_type::replace:
+                        replace(it->path, std::move(it->value), value);
+                        break;
+                    case op_type::move:
                     {
-                        jsonpointer::remove(target,it->path,ec);
-                        if (ec)
+                        if (it->replaced)
                         {
-                            //std::cout << "remove: " << it->path << std::endl;
-                            break;
+                            replace(it->path, std::move(it->value), value);
                         }
+                        else
+                        {
+                            extract(it->path, value);
+                        }
+                        Json old;
+                        insert_at(it->from, std::move(value), replaced, old);
+                        break;
                     }
-                    else if (it->op == op_type::replace)
+                }
+            }
+            undo_.clear();
+        }
+
+        // Parses a JSON Pointer into its unescaped tokens, reusing the strings in path
+        static bool parse(const string_view_type& location, path_type& path)
+        {
+            std::size_t count = 0;
+            auto p = location.begin();
+            auto end = location.end();
+            while (p != end)
+            {
+                if (*p != '/')
+                {
+                    return false;
+                }
+                ++p;
+                if (count == path.size())
+                {
+                    path.emplace_back();
+                }
+                string_type& token = path[count++];
+                token.clear();
+                for (; p != end && *p != '/'; ++p)
+                {
+                    if (*p == '~')
                     {
-                        jsonpointer::replace(target,it->path,it->value,ec);
-                        if (ec)
+                        ++p;
+                        if (p == end || (*p != '0' && *p != '1'))
                         {
-                            //std::cout << "replace: " << it->path << std::endl;
-                            break;
+                            return false;
                         }
+                        token.push_back(*p == '0' ? '~' : '/');
                     }
+                    else
+                    {
+                        token.push_back(*p);
+                    }
+                }
+            }
+            path.resize(count);
+            return true;
+        }
+
+        // Returns the value at the first length tokens of path, starting from the longest 
+        // prefix shared with the last path resolved
+        Json* resolve(const path_type& path, std::size_t length)
+        {
+            std::size_t shared = 0;
+            std::size_t limit = (std::min)(length, cached_path_.size());
+            while (shared < limit && cached_path_[shared] == path[shared])
+            {
+                ++shared;
+            }
+            cached_path_.resize(shared);
+            cached_nodes_.resize(shared + 1);
+
+            Json* current = cached_nodes_.back();
+            for (std::size_t i = shared; i < length; ++i)
+            {
+                std::error_code ec;
+                current = jsonpointer::detail::resolve(current, path[i], false, ec);
+                if (ec)
+                {
+                    return nullptr;
+                }
+                cached_path_.push_back(path[i]);
+                cached_nodes_.push_back(current);
+            }
+            return current;
+        }
+
+        // A change to the children of the value at the first length tokens of path 
+        // may move the values below it
+        void invalidate(const path_type& path, std::size_t length)
+        {
+            std::size_t shared = 0;
+            std::size_t limit = (std::min)(length, cached_path_.size());
+            while (shared < limit && cached_path_[shared] == path[shared])
+            {
+                ++shared;
+            }
+            cached_path_.resize(shared);
+            cached_nodes_.resize(shared + 1);
+        }
+
+        static bool to_index(const string_type& token, std::size_t& index)
+        {
+            auto result = jsoncons::detail::to_integer_decimal<std::size_t>(token.data(), token.length());
+            if (!result)
+            {
+                return false;
+            }
+            index = result.value();
+            return true;
+        }
+
+        Json* find(const path_type& path)
+        {
+            return resolve(path, path.size());
+        }
+
+        // Adds value at path, or replaces the value that is there. A "-" token is 
+        // replaced by the index of the item added.
+        bool insert(path_type& path, Json&& value, bool& replaced, Json& old)
+        {
+            if (!path.empty())
+            {
+                Json* parent = resolve(path, path.size() - 1);
+                if (parent != nullptr && parent->is_array() && path.back().size() == 1 && path.back()[0] == '-')
+                {
+                    path.back().clear();
+                    jsoncons::detail::from_integer(parent->size(), path.back());
                 }
             }
+            return insert_at(path, std::move(value), replaced, old);
+        }
+
+        bool insert_at(const path_type& path, Json&& value, bool& replaced, Json& old)
+        {
+            replaced = false;
+            if (path.empty())
+            {
+                old = std::move(root_);
+                root_ = std::move(value);
+                replaced = true;
+                invalidate(path, 0);
+                return true;
+            }
+            Json* parent = resolve(path, path.size() - 1);
+            if (parent == nullptr)
+            {
+                return false;
+            }
+            const string_type& token = path.back();
+            if (parent->is_array())
+            {
+                std::size_t index;
+                if (!to_index(token, index) || index > parent->size())
+                {
+                    return false;
+                }
+                parent->insert(parent->array_range().begin() + index, std::move(value));
+            }
+            else if (parent->is_object())
+            {
+                auto it = parent->find(token);
+                if (it != parent->object_range().end())
+                {
+                    old = std::move(it->value());
+                    it->value() = std::move(value);
+                    replaced = true;
+                }
+                else
+                {
+                    parent->try_emplace(token, std::move(value));
+                }
+            }
+            else
+            {
+                return false;
+            }
+            invalidate(path, path.size() - 1);
+            return true;
+        }
+
+        // Moves the value at path into value, and removes it
+        bool extract(const path_type& path, Json& value)
+        {
+            if (path.empty())
+            {
+                return false;
+            }
+            Json* parent = resolve(path, path.size() - 1);
+            if (parent == nullptr)
+            {
+                return false;
+            }
+            const string_type& token = path.back();
+            if (parent->is_array())
+            {
+                std::size_t index;
+                if (!to_index(token, index) || index >= parent->size())
+                {
+                    return false;
+                }
+                auto it = parent->array_range().begin() + index;
+                value = std::move(*it);
+                parent->erase(it);
+            }
+            else if (parent->is_object())
+            {
+                auto it = parent->find(token);
+                if (it == parent->object_range().end())
+                {
+                    return false;
+                }
+                value = std::move(it->value());
+                parent->erase(it);
+            }
+            else
+            {
+                return false;
+            }
+            invalidate(path, path.size() - 1);
+            return true;
+        }
+
+        bool replace(const path_type& path, Json&& value, Json& old)
+        {
+            Json* current = find(path);
+            if (current == nullptr)
+            {
+                return false;
+            }
+            old = std::move(*current);
+            *current = std::move(value);
+            invalidate(path, path.size());
+            return true;
         }
     };
 
+    // Computes the operations that turn source into target, and appends them to one result.
+    // The hash of each subtree is computed once, so equal subtrees are recognized without 
+    // comparing them at every level. The items of arrays are aligned by their hashes, with 
+    // the Myers algorithm, so that an insertion or a removal becomes one operation rather 
+    // than a replacement of every item that follows it. Objects and arrays that are removed 
+    // in one place and added in another become a "move", and those added again a "copy".
     template <class Json>
-    Json from_diff(const Json& source, const Json& target, const typename Json::string_view_type& path)
+    class differ
     {
         using char_type = typename Json::char_type;
+        using string_type = std::basic_string<char_type>;
+        using string_view_type = typename Json::string_view_type;
+
+        // Beyond this many insertions and removals, the items of arrays are compared by position
+        static constexpr std::size_t max_edit_distance() {return 1024;}
 
-        Json result = typename Json::array();
+        enum class edit_kind {keep,remove,insert};
 
-        if (source == target)
+        struct edit
+        {
+            edit_kind kind;
+            std::size_t source_index;
+            std::size_t target_index;
+
+            edit(edit_kind k, std::size_t i, std::size_t j)
+                : kind(k), source_index(i), target_index(j)
+            {
+            }
+        };
+
+        Json& result_;
+        string_type path_;
+        std::unordered_map<const Json*,std::size_t> hashes_;
+
+    public:
+        differ(Json& result, const string_view_type& path)
+            : result_(result), path_(path)
         {
-            return result;
         }
 
-        if (source.is_array() && target.is_array())
+        void diff(const Json& source, const Json& target)
         {
-            std::size_t common = (std::min)(source.size(),target.size());
-            for (std::size_t i = 0; i < common; ++i)
+            if (hash(source) == hash(target) && source == target)
             {
-                std::basic_string<char_type> ss(path); 
-                ss.push_back('/');
-                jsoncons::detail::from_integer(i,ss);
-                auto temp_diff = from_diff(source[i],target[i],ss);
-                result.insert(result.array_range().end(),temp_diff.array_range().begin(),temp_diff.array_range().end());
+                return;
             }
-            // Element in source, not in target - remove
-            for (std::size_t i = source.size(); i-- > target.size();)
+            if (source.is_array() && target.is_array())
+            {
+                diff_arrays(source, target);
+            }
+            else if (source.is_object() && target.is_object())
+            {
+                diff_objects(source, target);
+            }
+            else
             {
-                std::basic_string<char_type> ss(path); 
-                ss.push_back('/');
-                jsoncons::detail::from_integer(i,ss);
-                Json val(json_object_arg);
-                val.insert_or_assign(op_literal<char_type>(), remove_literal<char_type>());
-                val.insert_or_assign(path_literal<char_type>(), ss);
-                result.push_back(std::move(val));
-            }
-            // Element in target, not in source - add, 
-            // Fix contributed by Alexander rog13
-            for (std::size_t i = source.size(); i < target.size(); ++i)
-            {
-                const auto& a = target[i];
-                std::basic_string<char_type> ss(path); 
-                ss.push_back('/');
-                jsoncons::detail::from_integer(i,ss);
                 Json val(json_object_arg);
-                val.insert_or_assign(op_literal<char_type>(), add_literal<char_type>());
-                val.insert_or_assign(path_literal<char_type>(), ss);
-                val.insert_or_assign(value_literal<char_type>(), a);
-                result.push_back(std::move(val));
+                val.insert_or_assign(op_literal<char_type>(), replace_literal<char_type>());
+                val.insert_or_assign(path_literal<char_type>(), path_);
+                val.insert_or_assign(value_literal<char_type>(), target);
+                result_.push_back(std::move(val));
             }
         }
-        else if (source.is_object() && target.is_object())
+
+    private:
+
+        static bool is_structure(const Json& val)
+        {
+            return (val.is_array() || val.is_object()) && !val.empty();
+        }
+
+        static std::size_t mix(std::size_t h, std::size_t value)
+        {
+            return h ^ (value + static_cast<std::size_t>(0x9e3779b97f4a7c15ull) + (h << 6) + (h >> 2));
+        }
+
+        // Memoised, so that the hash of each subtree is computed once
+        std::size_t hash(const Json& val)
         {
-            for (const auto& a : source.object_range())
+            if (!(val.is_array() || val.is_object()))
             {
-                std::basic_string<char_type> ss(path);
-                ss.push_back('/'); 
-                jsonpointer::escape(a.key(),ss);
-                auto it = target.find(a.key());
-                if (it != target.object_range().end())
-                {
-                    auto temp_diff = from_diff(a.value(),it->value(),ss);
-                    result.insert(result.array_range().end(),temp_diff.array_range().begin(),temp_diff.array_range().end());
-                }
-                else
+                return val.hash();
+            }
+            auto it = hashes_.find(std::addressof(val));
+            if (it != hashes_.end())
+            {
+                return it->second;
+            }
+            std::size_t h;
+            if (val.is_array())
+            {
+                h = 0x94d049bb;
+                for (const auto& item : val.array_range())
                 {
-                    Json val(json_object_arg);
-                    val.insert_or_assign(op_literal<char_type>(), remove_literal<char_type>());
-                    val.insert_or_assign(path_literal<char_type>(), ss);
-                    result.push_back(std::move(val));
+                    h = mix(h, hash(item));
                 }
             }
-            for (const auto& a : target.object_range())
+            else
             {
-                auto it = source.find(a.key());
-                if (it == source.object_range().end())
+                // Independent of the order of members
+                h = 0xbf58476d;
+                for (const auto& member : val.object_range())
                 {
-                    std::basic_string<char_type> ss(path); 
-                    ss.push_back('/');
-                    jsonpointer::escape(a.key(),ss);
-                    Json val(json_object_arg);
-                    val.insert_or_assign(op_literal<char_type>(), add_literal<char_type>());
-                    val.insert_or_assign(path_literal<char_type>(), ss);
-                    val.insert_or_assign(value_literal<char_type>(), a.value());
-                    result.push_back(std::move(val));
+                    std::size_t key_hash = 0x811c9dc5;
+                    for (auto c : member.key())
+                    {
+                        key_hash = (key_hash ^ static_cast<std::size_t>(c)) * 0x01000193;
+                    }
+                    h += mix(key_hash, hash(member.value()));
                 }
             }
+            hashes_.emplace(std::addressof(val), h);
+            return h;
         }
-        else
+
+        void append_index(std::size_t index)
         {
-            Json val(json_object_arg);
-            val.insert_or_assign(op_literal<char_type>(), replace_literal<char_type>());
-            val.insert_or_assign(path_literal<char_type>(), path);
-            val.insert_or_assign(value_literal<char_type>(), target);
-            result.push_back(std::move(val));
+            path_.push_back('/');
+            jsoncons::detail::from_integer(index, path_);
         }
 
-        return result;
-    }
-}
+        void append_key(const string_view_type& key)
+        {
+            path_.push_back('/');
+            jsonpointer::escape(key, path_);
+        }
 
-template <class Json>
-void apply_patch(Json& target, const Json& patch, std::error_code& patch_ec)
-{
-    using char_type = typename Json::char_type;
-    using string_type = std::basic_string<char_type>;
-    using string_view_type = typename Json::string_view_type;
+        void add_operation(const string_type& path, const Json& value)
+        {
+            Json val(json_object_arg);
+            val.insert_or_assign(op_literal<char_type>(), add_literal<char_type>());
+            val.insert_or_assign(path_literal<char_type>(), path);
+            val.insert_or_assign(value_literal<char_type>(), value);
+            result_.push_back(std::move(val));
+        }
 
-   jsoncons::jsonpatch::detail::operation_unwinder<Json> unwinder(target);
+        void remove_operation(const string_type& path)
+        {
+            Json val(json_object_arg);
+            val.insert_or_assign(op_literal<char_type>(), remove_literal<char_type>());
+            val.insert_or_assign(path_literal<char_type>(), path);
+            result_.push_back(std::move(val));
+        }
 
-    // Validate
-    
-    string_type bad_path;
-    for (const auto& operation : patch.array_range())
-    {
-        unwinder.state =jsoncons::jsonpatch::detail::state_type::begin;
+        void from_operation(const string_view_type& op, const string_type& from, const string_type& path)
+        {
+            Json val(json_object_arg);
+            val.insert_or_assign(op_literal<char_type>(), op);
+            val.insert_or_assign(from_literal<char_type>(), from);
+            val.insert_or_assign(path_literal<char_type>(), path);
+            result_.push_back(std::move(val));
+        }
 
-        if (operation.count(detail::op_literal<char_type>()) != 1 || operation.count(detail::path_literal<char_type>()) != 1)
+        string_type index_path(std::size_t index) const
         {
-            patch_ec = jsonpatch_errc::invalid_patch;
-            unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+            string_type p(path_);
+            p.push_back('/');
+            jsoncons::detail::from_integer(index, p);
+            return p;
         }
-        else
+
+        void diff_objects(const Json& source, const Json& target)
         {
-            string_view_type op = operation.at(detail::op_literal<char_type>()).as_string_view();
-            string_view_type path = operation.at(detail::path_literal<char_type>()).as_string_view();
+            std::size_t length = path_.size();
 
-            if (op ==jsoncons::jsonpatch::detail::test_literal<char_type>())
+            // Removed members that are structures, by hash, which may have been moved
+            std::unordered_multimap<std::size_t,const typename Json::key_value_type*> removed;
+            // Target members that are structures, by hash, which may be copied
+            std::unordered_map<std::size_t,const typename Json::key_value_type*> present;
+
+            for (const auto& member : source.object_range())
             {
-                std::error_code ec;
-                Json val = jsonpointer::get(target,path,ec);
-                if (ec)
+                auto it = target.find(member.key());
+                if (it != target.object_range().end())
+                {
+                    if (is_structure(it->value()))
+                    {
+                        present.emplace(hash(it->value()), std::addressof(*it));
+                    }
+                }
+                else if (is_structure(member.value()))
+                {
+                    removed.emplace(hash(member.value()), std::addressof(member));
+                }
+            }
+
+            std::vector<std::pair<const typename Json::key_value_type*,const typename Json::key_value_type*>> moves;
+            for (const auto& member : target.object_range())
+            {
+                if (is_structure(member.value()) && source.find(member.key()) == source.object_range().end())
+                {
+                    auto range = removed.equal_range(hash(member.value()));
+                    for (auto it = range.first; it != range.second; ++it)
+                    {
+                        if (it->second->value() == member.value())
+                        {
+                            moves.emplace_back(it->second, std::addressof(member));
+                            removed.erase(it);
+                            break;
+                        }
+                    }
+                }
+            }
+            auto move_from = [&moves](const typename Json::key_value_type* to) -> const typename Json::key_value_type*
+            {
+                for (const auto& item : moves)
                 {
-                    patch_ec = jsonpatch_errc::test_failed;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                    if (item.second == to)
+                    {
+                        return item.first;
+                    }
                 }
-                else if (operation.count(detail::value_literal<char_type>()) != 1)
+                return nullptr;
+            };
+            auto is_moved = [&moves](const typename Json::key_value_type* from) -> bool
+            {
+                for (const auto& item : moves)
                 {
-                    patch_ec = jsonpatch_errc::invalid_patch;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                    if (item.first == from)
+                    {
+                        return true;
+                    }
                 }
-                else if (val != operation.at(detail::value_literal<char_type>()))
+                return false;
+            };
+
+            for (const auto& member : source.object_range())
+            {
+                if (target.find(member.key()) == target.object_range().end() && !is_moved(std::addressof(member)))
+                {
+                    append_key(member.key());
+                    remove_operation(path_);
+                    path_.resize(length);
+                }
+            }
+
+            for (const auto& member : source.object_range())
+            {
+                auto it = target.find(member.key());
+                if (it != target.object_range().end())
                 {
-                    patch_ec = jsonpatch_errc::test_failed;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                    append_key(member.key());
+                    diff(member.value(), it->value());
+                    path_.resize(length);
                 }
             }
-            else if (op ==jsoncons::jsonpatch::detail::add_literal<char_type>())
+
+            for (const auto& member : target.object_range())
             {
-                if (operation.count(detail::value_literal<char_type>()) != 1)
+                if (source.find(member.key()) != source.object_range().end())
+                {
+                    continue;
+                }
+                append_key(member.key());
+                auto from = moves.empty() ? nullptr : move_from(std::addressof(member));
+                if (from != nullptr)
                 {
-                    patch_ec = jsonpatch_errc::invalid_patch;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                    string_type from_path(path_.data(), length);
+                    append_to(from_path, from->key());
+                    from_operation(move_literal<char_type>(), from_path, path_);
                 }
                 else
                 {
-                    std::error_code insert_ec;
-                    Json val = operation.at(detail::value_literal<char_type>());
-                    auto npath = jsonpatch::detail::normalized_path(target,path);
-                    jsonpointer::add_if_absent(target,npath,val,insert_ec); // try insert without replace
-                    if (insert_ec) // try a replace
+                    const typename Json::key_value_type* copy = nullptr;
+                    if (is_structure(member.value()))
                     {
-                        std::error_code select_ec;
-                        Json orig_val = jsonpointer::get(target,npath,select_ec);
-                        if (select_ec) // shouldn't happen
+                        auto it = present.find(hash(member.value()));
+                        if (it != present.end() && it->second->value() == member.value())
                         {
-                            patch_ec = jsonpatch_errc::add_failed;
-                            unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                            copy = it->second;
                         }
                         else
                         {
-                            std::error_code replace_ec;
-                            jsonpointer::replace(target,npath,val,replace_ec);
-                            if (replace_ec)
-                            {
-                                patch_ec = jsonpatch_errc::add_failed;
-                                unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                            }
-                            else
-                            {
-                                unwinder.stack.emplace_back(detail::op_type::replace,npath,orig_val);
-                            }
+                            present.emplace(hash(member.value()), std::addressof(member));
                         }
                     }
-                    else // insert without replace succeeded
+                    if (copy != nullptr)
                     {
-                        unwinder.stack.emplace_back(detail::op_type::remove,npath,Json::null());
+                        string_type from_path(path_.data(), length);
+                        append_to(from_path, copy->key());
+                        from_operation(copy_literal<char_type>(), from_path, path_);
+                    }
+                    else
+                    {
+                        add_operation(path_, member.value());
                     }
                 }
+                path_.resize(length);
+            }
+        }
+
+        static void append_to(string_type& path, const string_view_type& key)
+        {
+            path.push_back('/');
+            jsonpointer::escape(key, path);
+        }
+
+        // Aligns the items of two arrays, and returns the edits in order, or false if 
+        // there are more than max_edit_distance insertions and removals
+        bool align(const Json& source, std::size_t source_first, std::size_t n,
+                   const Json& target, std::size_t target_first, std::size_t m,
+                   std::vector<edit>& script)
+        {
+            std::vector<std::size_t> a(n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                a[i] = hash(source[source_first+i]);
             }
-            else if (op ==jsoncons::jsonpatch::detail::remove_literal<char_type>())
+            std::vector<std::size_t> b(m);
+            for (std::size_t j = 0; j < m; ++j)
             {
-                std::error_code ec;
-                Json val = jsonpointer::get(target,path,ec);
-                if (ec)
-                {
-                    patch_ec = jsonpatch_errc::remove_failed;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                }
-                else
+                b[j] = hash(target[target_first+j]);
+            }
+
+            const std::ptrdiff_t max_d = static_cast<std::ptrdiff_t>((std::min)(n + m, max_edit_distance()));
+            const std::ptrdiff_t offset = max_d + 1;
+            const std::ptrdiff_t sn = static_cast<std::ptrdiff_t>(n);
+            const std::ptrdiff_t sm = static_cast<std::ptrdiff_t>(m);
+            std::vector<std::ptrdiff_t> v(static_cast<std::size_t>(2*max_d + 3), 0);
+            // For each d, v[k] for k in [-d-1, d+1] before step d
+            std::vector<std::vector<std::ptrdiff_t>> trace;
+
+            for (std::ptrdiff_t d = 0; d <= max_d; ++d)
+            {
+                trace.emplace_back(v.begin() + (offset - d - 1), v.begin() + (offset + d + 2));
+                for (std::ptrdiff_t k = -d; k <= d; k += 2)
                 {
-                    jsonpointer::remove(target,path,ec);
-                    if (ec)
+                    std::ptrdiff_t x = (k == -d || (k != d && v[offset+k-1] < v[offset+k+1])) ? v[offset+k+1] : v[offset+k-1] + 1;
+                    std::ptrdiff_t y = x - k;
+                    while (x < sn && y < sm && a[x] == b[y])
                     {
-                        patch_ec = jsonpatch_errc::remove_failed;
-                        unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                        ++x;
+                        ++y;
                     }
-                    else
+                    v[offset+k] = x;
+                    if (x >= sn && y >= sm)
                     {
-                        unwinder.stack.emplace_back(detail::op_type::add,string_type(path),val);
+                        backtrack(trace, d, sn, sm, source_first, target_first, script);
+                        return true;
                     }
                 }
             }
-            else if (op ==jsoncons::jsonpatch::detail::replace_literal<char_type>())
+            return false;
+        }
+
+        static void backtrack(const std::vector<std::vector<std::ptrdiff_t>>& trace, std::ptrdiff_t d_end,
+                              std::ptrdiff_t x, std::ptrdiff_t y,
+                              std::size_t source_first, std::size_t target_first,
+                              std::vector<edit>& script)
+        {
+            std::size_t mark = script.size();
+            for (std::ptrdiff_t d = d_end; d >= 0; --d)
             {
-                std::error_code ec;
-                Json val = jsonpointer::get(target,path,ec);
-                if (ec)
+                const auto& v = trace[static_cast<std::size_t>(d)];
+                // v[0] holds k = -d-1
+                auto at = [&v,d](std::ptrdiff_t k) {return v[static_cast<std::size_t>(k + d + 1)];};
+                std::ptrdiff_t k = x - y;
+                std::ptrdiff_t prev_k = (k == -d || (k != d && at(k-1) < at(k+1))) ? k + 1 : k - 1;
+                std::ptrdiff_t prev_x = at(prev_k);
+                std::ptrdiff_t prev_y = prev_x - prev_k;
+                while (x > prev_x && y > prev_y)
                 {
-                    patch_ec = jsonpatch_errc::replace_failed;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                    --x;
+                    --y;
+                    script.emplace_back(edit_kind::keep, source_first + static_cast<std::size_t>(x), target_first + static_cast<std::size_t>(y));
                 }
-                else if (operation.count(detail::value_literal<char_type>()) != 1)
+                if (d > 0)
                 {
-                    patch_ec = jsonpatch_errc::invalid_patch;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                }
-                else
-                {
-                    jsonpointer::replace(target,path,operation.at(detail::value_literal<char_type>()),ec);
-                    if (ec)
+                    if (x == prev_x)
                     {
-                        patch_ec = jsonpatch_errc::replace_failed;
-                        unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                        script.emplace_back(edit_kind::insert, 0, target_first + static_cast<std::size_t>(y - 1));
                     }
                     else
                     {
-                        unwinder.stack.emplace_back(detail::op_type::replace,string_type(path),val);
+                        script.emplace_back(edit_kind::remove, source_first + static_cast<std::size_t>(x - 1), 0);
                     }
                 }
+                x = prev_x;
+                y = prev_y;
             }
-            else if (op ==jsoncons::jsonpatch::detail::move_literal<char_type>())
+            std::reverse(script.begin() + mark, script.end());
+        }
+
+        void diff_arrays(const Json& source, const Json& target)
+        {
+            std::size_t n = source.size();
+            std::size_t m = target.size();
+
+            // Common prefix and suffix
+            std::size_t prefix = 0;
+            while (prefix < n && prefix < m && hash(source[prefix]) == hash(target[prefix]))
             {
-                if (operation.count(detail::from_literal<char_type>()) != 1)
+                ++prefix;
+            }
+            std::size_t suffix = 0;
+            while (suffix < n - prefix && suffix < m - prefix && hash(source[n-1-suffix]) == hash(target[m-1-suffix]))
+            {
+                ++suffix;
+            }
+
+            std::vector<edit> script;
+            for (std::size_t i = 0; i < prefix; ++i)
+            {
+                script.emplace_back(edit_kind::keep, i, i);
+            }
+            std::size_t source_count = n - prefix - suffix;
+            std::size_t target_count = m - prefix - suffix;
+            if (!align(source, prefix, source_count, target, prefix, target_count, script))
+            {
+                // Too different, compare by position
+                std::size_t common = (std::min)(source_count, target_count);
+                for (std::size_t i = 0; i < common; ++i)
                 {
-                    patch_ec = jsonpatch_errc::invalid_patch;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                    script.emplace_back(edit_kind::keep, prefix + i, prefix + i);
                 }
-                else
+                for (std::size_t i = common; i < source_count; ++i)
                 {
-                    string_view_type from = operation.at(detail::from_literal<char_type>()).as_string_view();
-                    std::error_code ec;
-                    Json val = jsonpointer::get(target,from,ec);
-                    if (ec)
+                    script.emplace_back(edit_kind::remove, prefix + i, 0);
+                }
+                for (std::size_t j = common; j < target_count; ++j)
+                {
+                    script.emplace_back(edit_kind::insert, 0, prefix + j);
+                }
+            }
+            for (std::size_t i = 0; i < suffix; ++i)
+            {
+                script.emplace_back(edit_kind::keep, n - suffix + i, m - suffix + i);
+            }
+
+            apply_script(source, target, script);
+        }
+
+        // Emits the operations for the edits. pos is the position, in the array as patched so far, 
+        // at which the next target item goes. Items removed before the place they are moved to are 
+        // left where they are until then ("deferred"), items moved from further on are taken out 
+        // of the source items not yet reached ("taken").
+        void apply_script(const Json& source, const Json& target, const std::vector<edit>& script)
+        {
+            const std::size_t npos = static_cast<std::size_t>(-1);
+            std::size_t n = source.size();
+            std::size_t m = target.size();
+            std::size_t length = path_.size();
+
+            // Pair the removed and inserted structures that are equal, as moves
+            std::vector<std::size_t> move_to(n, npos);
+            std::vector<std::size_t> move_from(m, npos);
+            {
+                std::unordered_multimap<std::size_t,std::size_t> removed;
+                for (const auto& e : script)
+                {
+                    if (e.kind == edit_kind::remove && is_structure(source[e.source_index]))
                     {
-                        patch_ec = jsonpatch_errc::move_failed;
-                        unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                        removed.emplace(hash(source[e.source_index]), e.source_index);
                     }
-                    else 
+                }
+                if (!removed.empty())
+                {
+                    for (const auto& e : script)
                     {
-                        jsonpointer::remove(target,from,ec);
-                        if (ec)
+                        if (e.kind == edit_kind::insert && is_structure(target[e.target_index]))
                         {
-                            patch_ec = jsonpatch_errc::move_failed;
-                            unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                        }
-                        else
-                        {
-                            unwinder.stack.emplace_back(detail::op_type::add,string_type(from),val);
-                            // add
-                            std::error_code insert_ec;
-                            auto npath = jsonpatch::detail::normalized_path(target,path);
-                            jsonpointer::add_if_absent(target,npath,val,insert_ec); // try insert without replace
-                            if (insert_ec) // try a replace
+                            auto range = removed.equal_range(hash(target[e.target_index]));
+                            for (auto it = range.first; it != range.second; ++it)
                             {
-                                std::error_code select_ec;
-                                Json orig_val = jsonpointer::get(target,npath,select_ec);
-                                if (select_ec) // shouldn't happen
-                                {
-                                    patch_ec = jsonpatch_errc::copy_failed;
-                                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                                }
-                                else
+                                if (source[it->second] == target[e.target_index])
                                 {
-                                    std::error_code replace_ec;
-                                    jsonpointer::replace(target, npath, val, replace_ec);
-                                    if (replace_ec)
-                                    {
-                                        patch_ec = jsonpatch_errc::copy_failed;
-                                        unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-
-                                    }
-                                    else
-                                    {
-                                        unwinder.stack.emplace_back(jsoncons::jsonpatch::detail::op_type::replace,npath,orig_val);
-                                    }
-                                    
+                                    move_to[it->second] = e.target_index;
+                                    move_from[e.target_index] = it->second;
+                                    removed.erase(it);
+                                    break;
                                 }
                             }
-                            else
-                            {
-                                unwinder.stack.emplace_back(detail::op_type::remove,npath,Json::null());
-                            }
-                        }           
+                        }
                     }
                 }
             }
-            else if (op ==jsoncons::jsonpatch::detail::copy_literal<char_type>())
+
+            std::size_t pos = 0;
+            std::size_t cursor = 0; // the first source item not yet reached
+            std::vector<std::pair<std::size_t,std::size_t>> deferred; // source index, position
+            std::vector<bool> taken(n, false);
+            // Target structures in place, by hash, which may be copied while nothing is deferred
+            std::unordered_map<std::size_t,std::size_t> placed;
+
+            auto place = [&](std::size_t j)
             {
-                if (operation.count(detail::from_literal<char_type>()) != 1)
+                if (is_structure(target[j]))
                 {
-                    patch_ec = jsonpatch_errc::invalid_patch;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                    placed.emplace(hash(target[j]), j);
                 }
-                else
+            };
+
+            auto remove_item = [&](std::size_t i)
+            {
+                if (!taken[i])
                 {
-                    std::error_code ec;
-                    string_view_type from = operation.at(detail::from_literal<char_type>()).as_string_view();
-                    Json val = jsonpointer::get(target,from,ec);
-                    if (ec)
+                    if (move_to[i] != npos)
                     {
-                        patch_ec = jsonpatch_errc::copy_failed;
-                        unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                        deferred.emplace_back(i, pos);
+                        ++pos;
                     }
                     else
                     {
-                        // add
-                        auto npath = jsonpatch::detail::normalized_path(target,path);
-                        std::error_code insert_ec;
-                        jsonpointer::add_if_absent(target,npath,val,insert_ec); // try insert without replace
-                        if (insert_ec) // Failed, try a replace
+                        remove_operation(index_path(pos));
+                    }
+                }
+                cursor = i + 1;
+            };
+
+            auto insert_item = [&](std::size_t j)
+            {
+                std::size_t i = move_from[j];
+                if (i != npos && i < cursor)
+                {
+                    auto it = std::find_if(deferred.begin(), deferred.end(), 
+                                           [i](const std::pair<std::size_t,std::size_t>& item) {return item.first == i;});
+                    std::size_t p = it->second;
+                    deferred.erase(it);
+                    for (auto& item : deferred)
+                    {
+                        if (item.second > p)
                         {
-                            std::error_code select_ec;
-                            Json orig_val = jsonpointer::get(target,npath, select_ec);
-                            if (select_ec) // shouldn't happen
-                            {
-                                patch_ec = jsonpatch_errc::copy_failed;
-                                unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                            }
-                            else 
-                            {
-                                std::error_code replace_ec;
-                                jsonpointer::replace(target, npath, val,replace_ec);
-                                if (replace_ec)
-                                {
-                                    patch_ec = jsonpatch_errc::copy_failed;
-                                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                                }
-                                else
-                                {
-                                    unwinder.stack.emplace_back(jsoncons::jsonpatch::detail::op_type::replace,npath,orig_val);
-                                }
-                            }
+                            --item.second;
                         }
-                        else
+                    }
+                    from_operation(move_literal<char_type>(), index_path(p), index_path(pos-1));
+                }
+                else if (i != npos)
+                {
+                    std::size_t q = pos;
+                    for (std::size_t k = cursor; k < i; ++k)
+                    {
+                        if (!taken[k])
                         {
-                            unwinder.stack.emplace_back(detail::op_type::remove,npath,Json::null());
+                            ++q;
                         }
                     }
+                    from_operation(move_literal<char_type>(), index_path(q), index_path(pos));
+                    taken[i] = true;
+                    ++pos;
                 }
-            }
-            if (unwinder.state !=jsoncons::jsonpatch::detail::state_type::begin)
+                else
+                {
+                    bool copied = false;
+                    if (deferred.empty() && is_structure(target[j]))
+                    {
+                        auto it = placed.find(hash(target[j]));
+                        if (it != placed.end() && target[it->second] == target[j])
+                        {
+                            from_operation(copy_literal<char_type>(), index_path(it->second), index_path(pos));
+                            copied = true;
+                        }
+                    }
+                    if (!copied)
+                    {
+                        add_operation(index_path(pos), target[j]);
+                    }
+                    ++pos;
+                }
+                place(j);
+            };
+
+            std::size_t e = 0;
+            while (e < script.size())
             {
-                bad_path = string_type(path);
+                if (script[e].kind == edit_kind::keep)
+                {
+                    append_index(pos);
+                    diff(source[script[e].source_index], target[script[e].target_index]);
+                    path_.resize(length);
+                    place(script[e].target_index);
+                    cursor = script[e].source_index + 1;
+                    ++pos;
+                    ++e;
+                    continue;
+                }
+
+                // A run of removals and insertions. Those that aren't moves are paired by 
+                // position, and each pair is diffed in place.
+                std::vector<std::size_t> removals;
+                std::vector<std::size_t> insertions;
+                for (; e < script.size() && script[e].kind != edit_kind::keep; ++e)
+                {
+                    if (script[e].kind == edit_kind::remove)
+                    {
+                        removals.push_back(script[e].source_index);
+                    }
+                    else
+                    {
+                        insertions.push_back(script[e].target_index);
+                    }
+                }
+
+                std::vector<std::size_t> paired_removals;
+                for (auto i : removals)
+                {
+                    if (move_to[i] == npos && !taken[i])
+                    {
+                        paired_removals.push_back(i);
+                    }
+                }
+                std::size_t r = 0;
+                std::size_t paired = 0;
+                for (auto j : insertions)
+                {
+                    if (move_from[j] == npos && paired < paired_removals.size())
+                    {
+                        std::size_t i = paired_removals[paired++];
+                        while (removals[r] != i)
+                        {
+                            remove_item(removals[r++]);
+                        }
+                        ++r;
+                        if (taken[i]) 
+                        {
+                            // Taken by an earlier insertion in this run
+                            insert_item(j);
+                            cursor = i + 1;
+                            continue;
+                        }
+                        append_index(pos);
+                        diff(source[i], target[j]);
+                        path_.resize(length);
+                        place(j);
+                        cursor = i + 1;
+                        ++pos;
+                    }
+                    else
+                    {
+                        insert_item(j);
+                    }
+                }
+                for (; r < removals.size(); ++r)
+                {
+                    remove_item(removals[r]);
+                }
             }
+            JSONCONS_ASSERT(deferred.empty());
         }
-        if (unwinder.state !=jsoncons::jsonpatch::detail::state_type::begin)
-        {
-            break;
-        }
-    }
-    if (unwinder.state ==jsoncons::jsonpatch::detail::state_type::begin)
+    };
+
+    template <class Json>
+    Json from_diff(const Json& source, const Json& target, const typename Json::string_view_type& path)
     {
-        unwinder.state =jsoncons::jsonpatch::detail::state_type::commit;
+        Json result(json_array_arg);
+        differ<Json> d(result, path);
+        d.diff(source, target);
+        return result;
     }
 }
 
+enum class rollback_policy {rollback, no_rollback};
+
+template <class Json>
+void apply_patch(Json& target, const Json& patch, rollback_policy policy, std::error_code& ec)
+{
+    jsoncons::jsonpatch::detail::patch_applier<Json> applier(target, policy == rollback_policy::rollback);
+    applier.apply(patch, ec);
+}
+
+template <class Json>
+void apply_patch(Json& target, const Json& patch, std::error_code& ec)
+{
+    apply_patch(target, patch, rollback_policy::rollback, ec);
+}
+
 template <class Json>
 Json from_diff(const Json& source, const Json& target)
 {
@@ -550,6 +1240,17 @@ void apply_patch(Json& target, const Json& patch)
     }
 }
 
+template <class Json>
+void apply_patch(Json& target, const Json& patch, rollback_policy policy)
+{
+    std::error_code ec;
+    apply_patch(target, patch, policy, ec);
+    if (ec)
+    {
+        JSONCONS_THROW(jsonpatch_error(ec));
+    }
+}
+
 }}
 
 #endif
@@ -0,0 +1,149 @@
+// Copyright 2021 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSONPATH_EXPRESSION_CACHE_HPP
+#define JSONCONS_JSONPATH_EXPRESSION_CACHE_HPP
+
+#include <string> // std::basic_string
+#include <list> // std::list
+#include <unordered_map> // std::unordered_map
+#include <memory> // std::shared_ptr
+#include <mutex> // std::mutex
+#include <utility> // std::move
+#include <system_error>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+
+namespace jsoncons {
+namespace jsonpath {
+
+    // A bounded, thread-safe cache of compiled JSONPath expressions keyed by
+    // path text. The least recently used expression is evicted when the cache
+    // is full. Each cache compiles with one set of custom functions, so
+    // expressions compiled with different function sets live in different caches.
+    template <class Json>
+    class expression_cache
+    {
+    public:
+        using char_type = typename Json::char_type;
+        using string_type = std::basic_string<char_type,std::char_traits<char_type>>;
+        using string_view_type = typename Json::string_view_type;
+        using expression_type = jsonpath_expression<Json>;
+        using expression_pointer = std::shared_ptr<const expression_type>;
+    private:
+        using entry_type = std::pair<string_type,expression_pointer>;
+        using list_type = std::list<entry_type>;
+
+        std::size_t capacity_;
+        custom_functions<Json> functions_;
+        mutable std::mutex mutex_;
+        list_type entries_; // most recently used first
+        std::unordered_map<string_type,typename list_type::iterator> index_;
+    public:
+        explicit expression_cache(std::size_t capacity = 256)
+            : capacity_(capacity == 0 ? 1 : capacity)
+        {
+        }
+
+        expression_cache(std::size_t capacity, const custom_functions<Json>& functions)
+            : capacity_(capacity == 0 ? 1 : capacity), functions_(functions)
+        {
+        }
+
+        expression_cache(const expression_cache&) = delete;
+        expression_cache& operator=(const expression_cache&) = delete;
+
+        // The process-wide cache for expressions without custom functions
+        static expression_cache& instance()
+        {
+            static expression_cache cache;
+            return cache;
+        }
+
+        std::size_t capacity() const
+        {
+            return capacity_;
+        }
+
+        std::size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return entries_.size();
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            index_.clear();
+            entries_.clear();
+        }
+
+        // Returns the cached expression for path, compiling it on a miss.
+        // Expressions that fail to compile are not cached.
+        expression_pointer get(const string_view_type& path)
+        {
+            string_type key(path.data(), path.size());
+            expression_pointer expr = find(key);
+            if (!expr)
+            {
+                // Compile outside the lock, other threads may evaluate or compile meanwhile
+                expr = insert(std::move(key), std::make_shared<expression_type>(expression_type::compile(path, functions_)));
+            }
+            return expr;
+        }
+
+        expression_pointer get(const string_view_type& path, std::error_code& ec)
+        {
+            string_type key(path.data(), path.size());
+            expression_pointer expr = find(key);
+            if (!expr)
+            {
+                auto compiled = std::make_shared<expression_type>(expression_type::compile(path, functions_, ec));
+                if (ec)
+                {
+                    return expression_pointer();
+                }
+                expr = insert(std::move(key), std::move(compiled));
+            }
+            return expr;
+        }
+    private:
+        expression_pointer find(const string_type& key)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_.find(key);
+            if (it == index_.end())
+            {
+                return expression_pointer();
+            }
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return it->second->second;
+        }
+
+        expression_pointer insert(string_type&& key, expression_pointer&& expr)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_.find(key);
+            if (it != index_.end())
+            {
+                // Another thread got there first
+                entries_.splice(entries_.begin(), entries_, it->second);
+                return it->second->second;
+            }
+            entries_.emplace_front(key, std::move(expr));
+            index_.emplace(std::move(key), entries_.begin());
+            if (entries_.size() > capacity_)
+            {
+                index_.erase(entries_.back().first);
+                entries_.pop_back();
+            }
+            return entries_.front().second;
+        }
+    };
+
+} // namespace jsonpath
+} // namespace jsoncons
+
+#endif
@@ -228,7 +228,7 @@ namespace jsoncons { namespace jsonpath {
             }
 
             void evaluate_tail(dynamic_resources<Json,JsonReference>& resources,
-                               const std::vector<path_component_type>& path, 
+                               const path_component_type& path, 
                                reference root,
                                reference val,
                                std::vector<path_node_type>& nodes,
@@ -274,7 +274,7 @@ namespace jsoncons { namespace jsonpath {
             }
 
             void select(dynamic_resources<Json,JsonReference>& resources,
-                        const std::vector<path_component_type>& path, 
+                        const path_component_type& path, 
                         reference root,
                         reference val,
                         std::vector<path_node_type>& nodes,
@@ -291,7 +291,7 @@ namespace jsoncons { namespace jsonpath {
                     auto it = val.find(identifier_);
                     if (it != val.object_range().end())
                     {
-                        this->evaluate_tail(resources, generate_path(path, identifier_, options), 
+                        this->evaluate_tail(resources, generate_path(resources, path, identifier_, options), 
                                                 root, it->value(), nodes, ndtype, options);
                     }
                 }
@@ -303,14 +303,14 @@ namespace jsoncons { namespace jsonpath {
                         std::size_t index = (r.value() >= 0) ? static_cast<std::size_t>(r.value()) : static_cast<std::size_t>(static_cast<int64_t>(val.size()) + r.value());
                         if (index < val.size())
                         {
-                            this->evaluate_tail(resources, generate_path(path, index, options), 
+                            this->evaluate_tail(resources, generate_path(resources, path, index, options), 
                                                 root, val[index], nodes, ndtype, options);
                         }
                     }
                     else if (identifier_ == length_literal<char_type>() && val.size() > 0)
                     {
                         pointer ptr = resources.create_json(val.size());
-                        this->evaluate_tail(resources, generate_path(path, identifier_, options), 
+                        this->evaluate_tail(resources, generate_path(resources, path, identifier_, options), 
                                                 root, *ptr, nodes, ndtype, options);
                     }
                 }
@@ -319,7 +319,7 @@ namespace jsoncons { namespace jsonpath {
                     string_view_type sv = val.as_string_view();
                     std::size_t count = unicode_traits::count_codepoints(sv.data(), sv.size());
                     pointer ptr = resources.create_json(count);
-                    this->evaluate_tail(resources, generate_path(path, identifier_, options), 
+                    this->evaluate_tail(resources, generate_path(resources, path, identifier_, options), 
                                             root, *ptr, nodes, ndtype, options);
                 }
                 //std::cout << "end identifier_selector\n";
@@ -355,7 +355,7 @@ namespace jsoncons { namespace jsonpath {
             }
 
             void select(dynamic_resources<Json,JsonReference>& resources,
-                        const std::vector<path_component_type>& path, 
+                        const path_component_type& path, 
                         reference root,
                         reference,
                         std::vector<path_node_type>& nodes,
@@ -368,14 +368,10 @@ namespace jsoncons { namespace jsonpath {
                 }
                 else
                 {
-                    std::vector<path_node_type> v;
+                    std::size_t start = nodes.size();
                     this->evaluate_tail(resources, path, 
-                                        root, root, v, ndtype, options);
-                    resources.add_to_cache(id_, v, ndtype);
-                    for (auto&& item : v)
-                    {
-                        nodes.push_back(std::move(item));
-                    }
+                                        root, root, nodes, ndtype, options);
+                    resources.add_to_cache(id_, std::vector<path_node_type>(nodes.begin()+start, nodes.end()), ndtype);
                 }
             }
 
@@ -405,7 +401,7 @@ namespace jsoncons { namespace jsonpath {
             }
 
             void select(dynamic_resources<Json,JsonReference>& resources,
-                        const std::vector<path_component_type>& path, 
+                        const path_component_type& path, 
                         reference root,
                         reference current,
                         std::vector<path_node_type>& nodes,
@@ -446,7 +442,7 @@ namespace jsoncons { namespace jsonpath {
             }
 
             void select(dynamic_resources<Json,JsonReference>& resources,
-                        const std::vector<path_component_type>& path, 
+                        const path_component_type& path, 
                         reference root,
                         reference val,
                         std::vector<path_node_type>& nodes,
@@ -461,17 +457,17 @@ namespace jsoncons { namespace jsonpath {
                     {
                         std::size_t index = static_cast<std::size_t>(index_);
                         //std::cout << "path: " << path << ", val: " << val << ", index: " << index << "\n";
-                        //nodes.emplace_back(generate_path(path, index, options),std::addressof(val.at(index)));
+                        //nodes.emplace_back(generate_path(resources, path, index, options),std::addressof(val.at(index)));
                         //nodes.emplace_back(path, std::addressof(val));
-                        this->evaluate_tail(resources, generate_path(path, index, options), 
+                        this->evaluate_tail(resources, generate_path(resources, path, index, options), 
                                                 root, val.at(index), nodes, ndtype, options);
                     }
                     else if ((slen + index_) >= 0 && (slen+index_) < slen)
                     {
                         std::size_t index = static_cast<std::size_t>(slen + index_);
                         //std::cout << "path: " << path << ", val: " << val << ", index: " << index << "\n";
-                        //nodes.emplace_back(generate_path(path, index ,options),std::addressof(val.at(index)));
-                        this->evaluate_tail(resources, generate_path(path, index, options), 
+                        //nodes.emplace_back(generate_path(resources, path, index ,options),std::addressof(val.at(index)));
+                        this->evaluate_tail(resources, generate_path(resources, path, index, options), 
                                                 root, val.at(index), nodes, ndtype, options);
                     }
                 }
@@ -490,7 +486,7 @@ namespace jsoncons { namespace jsonpath {
             }
 
             void select(dynamic_resources<Json,JsonReference>& resources,
-                        const std::vector<path_component_type>& path, 
+                        const path_component_type& path, 
                         reference root,
                         reference val,
                         std::vector<path_node_type>& nodes,
@@ -503,16 +499,20 @@ namespace jsoncons { namespace jsonpath {
                 node_kind tmptype;
                 if (val.is_array())
                 {
-                    for (std::size_t i = 0; i < val.size(); ++i)
+                    for (std::size_t i = 0; i < val.size() && !resources.is_done(); ++i)
                     {
-                        this->evaluate_tail(resources, generate_path(path, i, options), root, val[i], nodes, tmptype, options);
+                        this->evaluate_tail(resources, generate_path(resources, path, i, options), root, val[i], nodes, tmptype, options);
                     }
                 }
                 else if (val.is_object())
                 {
                     for (auto& item : val.object_range())
                     {
-                        this->evaluate_tail(resources, generate_path(path, item.key(), options), root, item.value(), nodes, tmptype, options);
+                        if (resources.is_done())
+                        {
+                            break;
+                        }
+                        this->evaluate_tail(resources, generate_path(resources, path, item.key(), options), root, item.value(), nodes, tmptype, options);
                     }
                 }
                 //std::cout << "end wildcard_selector\n";
@@ -545,7 +545,7 @@ namespace jsoncons { namespace jsonpath {
             }
 
             void select(dynamic_resources<Json,JsonReference>& resources,
-                        const std::vector<path_component_type>& path, 
+                        const path_component_type& path, 
                         reference root,
                         reference val,
                         std::vector<path_node_type>& nodes,
@@ -556,9 +556,9 @@ namespace jsoncons { namespace jsonpath {
                 if (val.is_array())
                 {
                     this->evaluate_tail(resources, path, root, val, nodes, ndtype, options);
-                    for (std::size_t i = 0; i < val.size(); ++i)
+                    for (std::size_t i = 0; i < val.size() && !resources.is_done(); ++i)
                     {
-                        select(resources, generate_path(path, i, options), root, val[i], nodes, ndtype, options);
+                        select(resources, generate_path(resources, path, i, options), root, val[i], nodes, ndtype, options);
                     }
                 }
                 else if (val.is_object())
@@ -566,7 +566,11 @@ namespace jsoncons { namespace jsonpath {
                     this->evaluate_tail(resources, path, root, val, nodes, ndtype, options);
                     for (auto& item : val.object_range())
                     {
-                        select(resources, generate_path(path, item.key(), options), root, item.value(), nodes, ndtype, options);
+                        if (resources.is_done())
+                        {
+                            break;
+                        }
+                        select(resources, generate_path(resources, path, item.key(), options), root, item.value(), nodes, ndtype, options);
                     }
                 }
                 //std::cout << "end wildcard_selector\n";
@@ -601,7 +605,7 @@ namespace jsoncons { namespace jsonpath {
             }
 
             void select(dynamic_resources<Json,JsonReference>& resources,
-                        const std::vector<path_component_type>& path, 
+                        const path_component_type& path, 
                         reference root,
                         reference val, 
                         std::vector<path_node_type>& nodes,
@@ -611,13 +615,17 @@ namespace jsoncons { namespace jsonpath {
                 //std::cout << "union_selector select val: " << val << "\n";
                 ndtype = node_kind::multi;
 
-                auto callback = [&](const std::vector<path_component_type>& p, reference v)
+                auto callback = [&](const path_component_type& p, reference v)
                 {
                     //std::cout << "union select callback: node: " << *node.ptr << "\n";
                     this->evaluate_tail(resources, p, root, v, nodes, ndtype, options);
                 };
                 for (auto& expr : expressions_)
                 {
+                    if (resources.is_done())
+                    {
+                        break;
+                    }
                     expr.evaluate(resources, path, root, val, callback, options);
                 }
             }
@@ -652,10 +660,11 @@ namespace jsoncons { namespace jsonpath {
             filter_expression_selector(expression_tree_type&& expr)
                 : path_selector(), expr_(std::move(expr))
             {
+                expr_.reorder_conjuncts();
             }
 
             void select(dynamic_resources<Json,JsonReference>& resources,
-                        const std::vector<path_component_type>& path, 
+                        const path_component_type& path, 
                         reference root,
                         reference current, 
                         std::vector<path_node_type>& nodes,
@@ -664,7 +673,7 @@ namespace jsoncons { namespace jsonpath {
             {
                 if (current.is_array())
                 {
-                    for (std::size_t i = 0; i < current.size(); ++i)
+                    for (std::size_t i = 0; i < current.size() && !resources.is_done(); ++i)
                     {
                         std::error_code ec;
                         value_type r = expr_.evaluate_single(resources, root, current[i], options, ec);
@@ -679,6 +688,10 @@ namespace jsoncons { namespace jsonpath {
                 {
                     for (auto& member : current.object_range())
                     {
+                        if (resources.is_done())
+                        {
+                            break;
+                        }
                         std::error_code ec;
                         value_type r = expr_.evaluate_single(resources, root, member.value(), options, ec);
                         bool t = ec ? false : detail::is_true(r);
@@ -719,7 +732,7 @@ namespace jsoncons { namespace jsonpath {
             }
 
             void select(dynamic_resources<Json,JsonReference>& resources,
-                        const std::vector<path_component_type>& path, 
+                        const path_component_type& path, 
                         reference root,
                         reference current, 
                         std::vector<path_node_type>& nodes,
@@ -774,7 +787,7 @@ namespace jsoncons { namespace jsonpath {
             }
 
             value_type evaluate_single(dynamic_resources<Json,JsonReference>& resources,
-                                       const std::vector<path_component_type>&, 
+                                       const path_component_type&, 
                                        reference root,
                                        reference current, 
                                        result_options options,
@@ -812,7 +825,7 @@ namespace jsoncons { namespace jsonpath {
             }
 
             void select(dynamic_resources<Json,JsonReference>& resources,
-                        const std::vector<path_component_type>& path, 
+                        const path_component_type& path, 
                         reference root,
                         reference current,
                         std::vector<path_node_type>& nodes,
@@ -837,10 +850,10 @@ namespace jsoncons { namespace jsonpath {
                         {
                             end = current.size();
                         }
-                        for (int64_t i = start; i < end; i += step)
+                        for (int64_t i = start; i < end && !resources.is_done(); i += step)
                         {
                             std::size_t j = static_cast<std::size_t>(i);
-                            this->evaluate_tail(resources, generate_path(path, j, options), root, current[j], nodes, ndtype, options);
+                            this->evaluate_tail(resources, generate_path(resources, path, j, options), root, current[j], nodes, ndtype, options);
                         }
                     }
                     else if (step < 0)
@@ -853,12 +866,12 @@ namespace jsoncons { namespace jsonpath {
                         {
                             end = -1;
                         }
-                        for (int64_t i = start; i > end; i += step)
+                        for (int64_t i = start; i > end && !resources.is_done(); i += step)
                         {
                             std::size_t j = static_cast<std::size_t>(i);
                             if (j < current.size())
                             {
-                                this->evaluate_tail(resources, generate_path(path,j,options), root, current[j], nodes, ndtype, options);
+                                this->evaluate_tail(resources, generate_path(resources, path, j,options), root, current[j], nodes, ndtype, options);
                             }
                         }
                     }
@@ -878,7 +891,7 @@ namespace jsoncons { namespace jsonpath {
             }
 
             void select(dynamic_resources<Json,JsonReference>& resources,
-                        const std::vector<path_component_type>& path, 
+                        const path_component_type& path, 
                         reference root,
                         reference current, 
                         std::vector<path_node_type>& nodes,
@@ -3279,41 +3292,45 @@ namespace jsoncons { namespace jsonpath {
 
         template <class BinaryCallback>
         typename std::enable_if<type_traits::is_binary_function_object<BinaryCallback,const string_type&,reference>::value,void>::type
-        evaluate(reference instance, BinaryCallback callback, result_options options = result_options())
+        evaluate(reference instance, BinaryCallback callback, result_options options = result_options()) const
         {
-            std::vector<path_component_type> path = { path_component_type(root_node_arg) };
-
             jsoncons::jsonpath::detail::dynamic_resources<Json,reference> resources;
-            auto f = [&callback](const std::vector<path_component_type>& path, reference val)
+            auto f = [&callback](const path_component_type& path, reference val)
             {
                 callback(to_string(path), val);
             };
-            expr_.evaluate(resources, path, instance, instance, f, options);
+            expr_.evaluate(resources, resources.root_path(), instance, instance, f, options);
         }
 
-        Json evaluate(reference instance, result_options options = result_options())
+        Json evaluate(reference instance, result_options options = result_options()) const
         {
-            std::vector<path_component_type> path = {path_component_type(root_node_arg)};
-
             if ((options & result_options::path) == result_options::path)
             {
                 jsoncons::jsonpath::detail::dynamic_resources<Json,reference> resources;
 
                 Json result(json_array_arg);
-                auto callback = [&result](const std::vector<path_component_type>& p, reference)
+                auto callback = [&result](const path_component_type& p, reference)
                 {
                     result.emplace_back(to_string(p));
                 };
-                expr_.evaluate(resources, path, instance, instance, callback, options);
+                expr_.evaluate(resources, resources.root_path(), instance, instance, callback, options);
                 return result;
             }
             else
             {
                 jsoncons::jsonpath::detail::dynamic_resources<Json,reference> resources;
-                return expr_.evaluate(resources, path, instance, instance, options);
+                return expr_.evaluate(resources, resources.root_path(), instance, instance, options);
             }
         }
 
+        // Returns at most limit values or normalized paths. Unless sort or nodups
+        // is requested, evaluation stops as soon as limit results have been found.
+        Json evaluate(reference instance, std::size_t limit, result_options options = result_options()) const
+        {
+            jsoncons::jsonpath::detail::dynamic_resources<Json,reference> resources;
+            return expr_.evaluate(resources, resources.root_path(), instance, instance, options, limit);
+        }
+
         static jsonpath_expression compile(const string_view_type& path)
         {
             jsoncons::jsonpath::detail::static_resources<value_type,reference> resources;
@@ -3398,6 +3415,15 @@ namespace jsoncons { namespace jsonpath {
         return expr.evaluate(instance, options);
     }
 
+    template<class Json>
+    Json json_query_first(const Json& instance, 
+                          const typename Json::string_view_type& path, 
+                          result_options options = result_options())
+    {
+        auto expr = make_expression<Json>(path);
+        return expr.evaluate(instance, 1, options);
+    }
+
     template<class Json,class Callback>
     typename std::enable_if<type_traits::is_binary_function_object<Callback,const std::basic_string<typename Json::char_type>&,const Json&>::value,void>::type
     json_query(const Json& instance, 
@@ -3433,18 +3459,16 @@ namespace jsoncons { namespace jsonpath {
         using json_selector_t = typename evaluator_t::path_expression_type;
         using path_component_type = typename evaluator_t::path_component_type;
 
-        std::vector<path_component_type> output_path = { path_component_type(root_node_arg ) };
-
         jsoncons::jsonpath::detail::static_resources<value_type,reference> static_resources;
         evaluator_t e;
         json_selector_t expr = e.compile(static_resources, path);
 
         jsoncons::jsonpath::detail::dynamic_resources<Json,reference> resources;
-        auto callback = [&new_value](const std::vector<path_component_type>&, reference v)
+        auto callback = [&new_value](const path_component_type&, reference v)
         {
             v = std::forward<T>(new_value);
         };
-        expr.evaluate(resources, output_path, instance, instance, callback, options);
+        expr.evaluate(resources, resources.root_path(), instance, instance, callback, options);
     }
 
     template<class Json, class UnaryCallback>
@@ -3458,18 +3482,16 @@ namespace jsoncons { namespace jsonpath {
         using json_selector_t = typename evaluator_t::path_expression_type;
         using path_component_type = typename evaluator_t::path_component_type;
 
-        std::vector<path_component_type> output_path = { path_component_type(root_node_arg) };
-
         jsoncons::jsonpath::detail::static_resources<value_type,reference> static_resources;
         evaluator_t e;
         json_selector_t expr = e.compile(static_resources, path);
 
         jsoncons::jsonpath::detail::dynamic_resources<Json,reference> resources;
-        auto f = [callback](const std::vector<path_component_type>&, reference v)
+        auto f = [callback](const path_component_type&, reference v)
         {
             v = callback(v);
         };
-        expr.evaluate(resources, output_path, instance, instance, f, result_options::nodups);
+        expr.evaluate(resources, resources.root_path(), instance, instance, f, result_options::nodups);
     }
 
     template<class Json, class BinaryCallback>
@@ -3484,19 +3506,17 @@ namespace jsoncons { namespace jsonpath {
         using json_selector_t = typename evaluator_t::path_expression_type;
         using path_component_type = typename evaluator_t::path_component_type;
 
-        std::vector<path_component_type> output_path = { path_component_type(root_node_arg) };
-
         jsoncons::jsonpath::detail::static_resources<value_type,reference> static_resources;
         evaluator_t e;
         json_selector_t expr = e.compile(static_resources, path);
 
         jsoncons::jsonpath::detail::dynamic_resources<Json,reference> resources;
 
-        auto f = [&callback](const std::vector<path_component_type>& path, reference val)
+        auto f = [&callback](const path_component_type& path, reference val)
         {
             callback(to_string(path), val);
         };
-        expr.evaluate(resources, output_path, instance, instance, f, options);
+        expr.evaluate(resources, resources.root_path(), instance, instance, f, options);
     }
 
 } // namespace jsonpath
@@ -14,6 +14,8 @@
 #include <limits> // std::numeric_limits
 #include <set> // std::set
 #include <utility> // std::move
+#include <deque> // std::deque
+#include <memory> // std::addressof
 #if defined(JSONCONS_HAS_STD_REGEX)
 #include <regex>
 #endif
@@ -131,36 +133,44 @@ namespace jsonpath {
     };
     constexpr argument_arg_t argument_arg{};
 
+    // A path component is a node in a parent-linked list of components. Selectors
+    // extend a path by creating a child node that points at its parent, so that
+    // paths share their common prefix and are only materialized as strings on demand.
+    // Identifiers refer to keys in the instance or to identifiers in the expression,
+    // both of which outlive an evaluation.
     template <class CharT>
     class path_component
     {
         enum class component_kind {root,current,identifier,index};
     public:
         using string_type = std::basic_string<CharT>;
+        using string_view_type = jsoncons::basic_string_view<CharT, std::char_traits<CharT>>;
     private:
 
+        const path_component* parent_;
+        std::size_t size_;
         component_kind kind_;
-        string_type identifier_;
+        string_view_type identifier_;
         std::size_t index_;
     public:
         path_component(root_node_arg_t)
-            : kind_(component_kind::root)
+            : parent_(nullptr), size_(1), kind_(component_kind::root), identifier_(root_symbol()), index_(0)
         {
-            identifier_.push_back('$');
         }
         path_component(current_node_arg_t)
-            : kind_(component_kind::current)
+            : parent_(nullptr), size_(1), kind_(component_kind::current), identifier_(current_node_symbol()), index_(0)
         {
-            identifier_.push_back('@');
         }
 
-        path_component(const string_type& identifier)
-            : kind_(component_kind::identifier), identifier_(identifier)
+        path_component(const path_component* parent, const string_view_type& identifier)
+            : parent_(parent), size_(parent == nullptr ? 1 : parent->size_+1), 
+              kind_(component_kind::identifier), identifier_(identifier), index_(0)
         {
         }
 
-        path_component(std::size_t index)
-            : kind_(component_kind::index), index_(index)
+        path_component(const path_component* parent, std::size_t index)
+            : parent_(parent), size_(parent == nullptr ? 1 : parent->size_+1), 
+              kind_(component_kind::index), index_(index)
         {
         }
 
@@ -169,6 +179,17 @@ namespace jsonpath {
         path_component& operator=(const path_component&) = default;
         path_component& operator=(path_component&&) = default;
 
+        const path_component* parent() const
+        {
+            return parent_;
+        }
+
+        // The number of components from the root to this component
+        std::size_t size() const
+        {
+            return size_;
+        }
+
         bool is_identifier() const
         {
             return kind_ == component_kind::identifier || kind_ == component_kind::root || kind_ == component_kind::current;
@@ -179,7 +200,7 @@ namespace jsonpath {
             return kind_ == component_kind::index;
         }
 
-        const string_type& identifier() const
+        string_view_type identifier() const
         {
             return identifier_;
         }
@@ -189,40 +210,40 @@ namespace jsonpath {
             return index_;
         }
 
-        bool operator==(const path_component& other) const
+        // Compares this component with another, ignoring their parents
+        int compare(const path_component& other) const
         {
             if (is_identifier() && other.is_identifier())
             {
-                return identifier_ == other.identifier_;
+                return identifier_.compare(other.identifier_);
             }
             else if (is_index() && other.is_index())
             {
-                return index_ == other.index_;
+                return index_ == other.index_ ? 0 : (index_ < other.index_ ? -1 : 1);
             }
             else
             {
-                return false;
+                return is_index() ? -1 : 1;
             }
         }
 
+        bool operator==(const path_component& other) const
+        {
+            return compare(other) == 0;
+        }
+
         bool operator<(const path_component& other) const
         {
-            if (is_identifier() && other.is_identifier())
-            {
-                return identifier_ < other.identifier_;
-            }
-            else if (is_index() && other.is_index())
-            {
-                return index_ < other.index_;
-            }
-            else
-            {
-                return is_index() ? true : false;
-            }
+            return compare(other) < 0;
         }
 
+        // Appends the normalized path from the root to this component 
         void to_string(string_type& buffer) const
         {
+            if (parent_ != nullptr)
+            {
+                parent_->to_string(buffer);
+            }
             switch (kind_)
             {
                 case component_kind::root:
@@ -234,7 +255,7 @@ namespace jsonpath {
                 case component_kind::identifier:
                     buffer.push_back('[');
                     buffer.push_back('\'');
-                    buffer.append(identifier_);
+                    buffer.append(identifier_.data(), identifier_.size());
                     buffer.push_back('\'');
                     buffer.push_back(']');
                     break;
@@ -245,8 +266,52 @@ namespace jsonpath {
                     break;
             }
         }
+    private:
+        static string_view_type root_symbol()
+        {
+            static const CharT s[] = {'$'};
+            return string_view_type(s, 1);
+        }
+        static string_view_type current_node_symbol()
+        {
+            static const CharT s[] = {'@'};
+            return string_view_type(s, 1);
+        }
     };
 
+    // Compares the paths ending in lhs and rhs component by component from the root,
+    // without materializing them. Shared prefixes are detected by address. 
+    template <class CharT>
+    int compare_paths(const path_component<CharT>& lhs, const path_component<CharT>& rhs)
+    {
+        const path_component<CharT>* p = std::addressof(lhs);
+        const path_component<CharT>* q = std::addressof(rhs);
+        while (p->size() > q->size())
+        {
+            p = p->parent();
+        }
+        while (q->size() > p->size())
+        {
+            q = q->parent();
+        }
+        int result = 0;
+        while (p != q && p != nullptr)
+        {
+            int diff = p->compare(*q);
+            if (diff != 0)
+            {
+                result = diff;
+            }
+            p = p->parent();
+            q = q->parent();
+        }
+        if (result != 0)
+        {
+            return result;
+        }
+        return lhs.size() == rhs.size() ? 0 : (lhs.size() < rhs.size() ? -1 : 1);
+    }
+
     template <class CharT>
     bool operator==(const path_component<CharT>& lhs,const path_component<CharT>& rhs)
     {
@@ -266,13 +331,10 @@ namespace jsonpath {
     }
 
     template <class CharT>
-    std::basic_string<CharT> to_string(const std::vector<path_component<CharT>>& path)
+    std::basic_string<CharT> to_string(const path_component<CharT>& path)
     {
         std::basic_string<CharT> buffer;
-        for (const auto& component : path)
-        {
-            component.to_string(buffer);
-        }
+        path.to_string(buffer);
         return buffer;
     }
 
@@ -2346,37 +2408,18 @@ namespace detail {
         using pointer = typename std::conditional<std::is_const<typename std::remove_reference<JsonReference>::type>::value,typename Json::const_pointer,typename Json::pointer>::type;
         using path_component_type = path_component<char_type>;
 
-        std::vector<path_component_type> path;
+        const path_component_type* path;
         pointer ptr;
 
-        path_node(const std::vector<path_component_type>& p, const pointer& valp)
-            : path(p),ptr(valp)
-        {
-        }
-        path_node(const pointer& valp)
-            : ptr(valp)
+        path_node(const path_component_type& p, const pointer& valp)
+            : path(std::addressof(p)),ptr(valp)
         {
         }
 
-        path_node(std::vector<path_component_type>&& p, pointer&& valp) noexcept
-            : path(std::move(p)),ptr(valp)
-        {
-        }
         path_node(const path_node&) = default;
-
-        path_node(path_node&& other) noexcept
-            : path(std::move(other.path)), ptr(other.ptr)
-        {
-
-        }
+        path_node(path_node&&) = default;
         path_node& operator=(const path_node&) = default;
-
-        path_node& operator=(path_node&& other) noexcept
-        {
-            path.swap(other.path);
-            ptr = other.ptr;
-            return *this;
-        }
+        path_node& operator=(path_node&&) = default;
     };
  
     template <class Json,class JsonReference>
@@ -2385,7 +2428,7 @@ namespace detail {
         bool operator()(const path_node<Json,JsonReference>& a,
                         const path_node<Json,JsonReference>& b) const noexcept
         {
-            return a.path < b.path;
+            return compare_paths(*a.path, *b.path) < 0;
         }
     };
 
@@ -2395,27 +2438,65 @@ namespace detail {
         bool operator()(const path_node<Json,JsonReference>& lhs,
                         const path_node<Json,JsonReference>& rhs) const noexcept
         {
-            if (lhs.path.size() != rhs.path.size())
-            {
-                return false;
-            }
-            for (std::size_t i = 0; i < lhs.path.size(); ++i)
-            {
-                if (lhs.path[i] != rhs.path[i])
-                {
-                    return false;
-                }
-            }
-            return true;
+            return lhs.path == rhs.path || 
+                   (lhs.path->size() == rhs.path->size() && compare_paths(*lhs.path, *rhs.path) == 0);
         }
     };
 
     template <class Json, class JsonReference>
     class dynamic_resources
     {
+    public:
+        using char_type = typename Json::char_type;
+        using path_component_type = path_component<char_type>;
+    private:
         std::vector<std::unique_ptr<Json>> temp_json_values_;
         std::unordered_map<std::size_t,std::pair<std::vector<path_node<Json,JsonReference>>,node_kind>> cache_;
+        path_component_type root_path_;
+        path_component_type current_path_;
+        // Path components created during an evaluation, references remain valid 
+        // until the resources are destroyed
+        std::deque<path_component_type> path_components_;
+        const std::vector<path_node<Json,JsonReference>>* result_;
+        std::size_t result_limit_;
     public:
+        dynamic_resources()
+            : root_path_(root_node_arg), current_path_(current_node_arg), 
+              result_(nullptr), result_limit_(0)
+        {
+        }
+
+        dynamic_resources(const dynamic_resources&) = delete;
+        dynamic_resources& operator=(const dynamic_resources&) = delete;
+
+        const path_component_type& root_path() const
+        {
+            return root_path_;
+        }
+
+        const path_component_type& current_path() const
+        {
+            return current_path_;
+        }
+
+        // Selection may stop once result holds limit nodes
+        void set_result_limit(const std::vector<path_node<Json,JsonReference>>& result, std::size_t limit)
+        {
+            result_ = std::addressof(result);
+            result_limit_ = limit;
+        }
+
+        bool is_done() const
+        {
+            return result_ != nullptr && result_->size() >= result_limit_;
+        }
+
+        template <typename T>
+        const path_component_type& create_path_component(const path_component_type& parent, T&& value)
+        {
+            path_components_.emplace_back(std::addressof(parent), std::forward<T>(value));
+            return path_components_.back();
+        }
 
         bool is_cached(std::size_t id) const
         {
@@ -2499,34 +2580,34 @@ namespace detail {
             return true;
         }
 
-        static std::vector<path_component_type> generate_path(const std::vector<path_component_type>& path, 
-                                                              std::size_t index, 
-                                                              result_options options) 
+        static const path_component_type& generate_path(dynamic_resources<Json,JsonReference>& resources,
+                                                        const path_component_type& path, 
+                                                        std::size_t index, 
+                                                        result_options options) 
         {
             static const result_options require_path = result_options::path | result_options::nodups | result_options::sort;
-            std::vector<path_component_type> s(path);
             if ((options & require_path) != result_options())
             {
-                s.emplace_back(index);
+                return resources.create_path_component(path, index);
             }
-            return s;
+            return path;
         }
 
-        static std::vector<path_component_type> generate_path(const std::vector<path_component_type>& path, 
-                                                              const string_type& identifier, 
-                                                              result_options options) 
+        static const path_component_type& generate_path(dynamic_resources<Json,JsonReference>& resources,
+                                                        const path_component_type& path, 
+                                                        const string_view_type& identifier, 
+                                                        result_options options) 
         {
             static const result_options require_path = result_options::path | result_options::nodups | result_options::sort;
-            std::vector<path_component_type> s(path);
             if ((options & require_path) != result_options())
             {
-                s.emplace_back(identifier);
+                return resources.create_path_component(path, identifier);
             }
-            return s;
+            return path;
         }
 
         virtual void select(dynamic_resources<Json,JsonReference>& resources,
-                            const std::vector<path_component_type>& path, 
+                            const path_component_type& path, 
                             reference root,
                             reference val, 
                             std::vector<path_node_type>& nodes,
@@ -2559,7 +2640,7 @@ namespace detail {
         virtual ~expression_base() noexcept = default;
 
         virtual value_type evaluate_single(dynamic_resources<Json,JsonReference>& resources,
-                                           const std::vector<path_component_type>& path, 
+                                           const path_component_type& path, 
                                            reference root,
                                            reference val, 
                                            result_options options,
@@ -2974,48 +3055,55 @@ namespace detail {
         path_expression& operator=(path_expression&& expr) = default;
 
         Json evaluate(dynamic_resources<Json,JsonReference>& resources, 
-                      const std::vector<path_component_type>& path, 
+                      const path_component_type& path, 
                       reference root,
                       reference instance,
-                      result_options options) const
+                      result_options options,
+                      std::size_t limit = (std::numeric_limits<std::size_t>::max)()) const
         {
             Json result(json_array_arg);
 
             if ((options & result_options::path) == result_options::path)
             {
-                auto callback = [&result](const std::vector<path_component_type>& path, reference)
+                auto callback = [&result](const path_component_type& path, reference)
                 {
                     result.emplace_back(jsoncons::jsonpath::to_string(path));
                 };
-                evaluate(resources, path, root, instance, callback, options);
+                evaluate(resources, path, root, instance, callback, options, limit);
             }
             else
             {
-                auto callback = [&result](const std::vector<path_component_type>&, reference val)
+                auto callback = [&result](const path_component_type&, reference val)
                 {
                     result.push_back(val);
                 };
-                evaluate(resources, path, root, instance, callback, options);
+                evaluate(resources, path, root, instance, callback, options, limit);
             }
 
             return result;
         }
 
+        // Calls callback with at most limit results. Without sort or nodups, selection 
+        // stops as soon as limit results have been found.
         template <class Callback>
-        typename std::enable_if<type_traits::is_binary_function_object<Callback,const std::vector<path_component_type>&,reference>::value,void>::type
+        typename std::enable_if<type_traits::is_binary_function_object<Callback,const path_component_type&,reference>::value,void>::type
         evaluate(dynamic_resources<Json,JsonReference>& resources, 
-                 const std::vector<path_component_type>& ipath, 
+                 const path_component_type& path, 
                  reference root,
                  reference current, 
                  Callback callback,
-                 result_options options) const
+                 result_options options,
+                 std::size_t limit = (std::numeric_limits<std::size_t>::max)()) const
         {
             std::error_code ec;
 
-            std::vector<path_component_type> path(ipath);
-
             std::vector<path_node_type> temp;
             node_kind ndtype = node_kind();
+            if (limit != (std::numeric_limits<std::size_t>::max)() && 
+                (options & (result_options::sort | result_options::nodups)) == result_options())
+            {
+                resources.set_result_limit(temp, limit);
+            }
             selector_->select(resources, path, root, current, temp, ndtype, options);
 
             if (temp.size() > 1 && (options & result_options::sort) == result_options::sort)
@@ -3029,10 +3117,6 @@ namespace detail {
                 {
                     auto last = std::unique(temp.begin(),temp.end(),path_node_equal_type());
                     temp.erase(last,temp.end());
-                    for (auto& node : temp)
-                    {
-                        callback(node.path, *node.ptr);
-                    }
                 }
                 else
                 {
@@ -3046,24 +3130,24 @@ namespace detail {
                     for (auto&& node : temp)
                     {
                         auto it = std::lower_bound(index.begin(),index.end(),node, path_node_less_type());
-                        if (it != index.end() && it->path == node.path) 
+                        if (it != index.end() && path_node_equal_type()(*it, node)) 
                         {
                             temp2.emplace_back(std::move(node));
                             index.erase(it);
                         }
                     }
-                    for (auto& node : temp2)
-                    {
-                        callback(node.path, *node.ptr);
-                    }
+                    temp.swap(temp2);
                 }
             }
-            else
+
+            std::size_t count = 0;
+            for (auto& node : temp)
             {
-                for (auto& node : temp)
+                if (count++ == limit)
                 {
-                    callback(node.path, *node.ptr);
+                    break;
                 }
+                callback(*node.path, *node.ptr);
             }
         }
 
@@ -3105,6 +3189,8 @@ namespace detail {
         using stack_item_type = value_or_pointer<Json,JsonReference>;
     private:
         std::vector<token_type> token_list_;
+        // The operands of a top level chain of && operators, cheapest first
+        std::vector<std::vector<token_type>> conjuncts_;
     public:
 
         expression_tree()
@@ -3112,26 +3198,103 @@ namespace detail {
         }
 
         expression_tree(expression_tree&& expr)
-            : token_list_(std::move(expr.token_list_))
+            : token_list_(std::move(expr.token_list_)), conjuncts_(std::move(expr.conjuncts_))
         {
         }
 
         expression_tree(std::vector<token_type>&& token_stack)
             : token_list_(std::move(token_stack))
         {
+            fold_constants();
         }
 
         expression_tree& operator=(expression_tree&& expr) = default;
 
+        // A filter only needs the truth value of its expression, so the operands
+        // of a top level chain of && operators may be evaluated in order of 
+        // estimated cost, stopping at the first one that is false.
+        void reorder_conjuncts()
+        {
+            std::vector<std::vector<token_type>> conjuncts;
+            if (!split_conjuncts(token_list_, conjuncts))
+            {
+                return;
+            }
+            std::vector<std::pair<std::size_t,std::size_t>> costs; // (cost, position)
+            for (std::size_t i = 0; i < conjuncts.size(); ++i)
+            {
+                costs.emplace_back(estimate_cost(conjuncts[i]), i);
+            }
+            std::stable_sort(costs.begin(), costs.end(), 
+                             [](const std::pair<std::size_t,std::size_t>& a, const std::pair<std::size_t,std::size_t>& b){return a.first < b.first;});
+            for (const auto& item : costs)
+            {
+                conjuncts_.push_back(std::move(conjuncts[item.second]));
+            }
+            token_list_.clear();
+        }
+
         value_type evaluate_single(dynamic_resources<Json,reference>& resources, 
                                    reference root,
                                    reference current,
                                    result_options options,
                                    std::error_code& ec) const
+        {
+            if (conjuncts_.empty())
+            {
+                return evaluate_tokens(token_list_, resources, root, current, options, ec);
+            }
+            value_type val = Json::null();
+            for (const auto& tokens : conjuncts_)
+            {
+                val = evaluate_tokens(tokens, resources, root, current, options, ec);
+                if (ec || !is_true(val))
+                {
+                    break;
+                }
+            }
+            return val;
+        }
+ 
+        std::string to_string(int level) const
+        {
+            std::string s;
+            if (level > 0)
+            {
+                s.append("\n");
+                s.append(level*2, ' ');
+            }
+            s.append("expression ");
+            for (const auto& item : token_list_)
+            {
+                s.append(item.to_string(level+1));
+            }
+            for (std::size_t i = 0; i < conjuncts_.size(); ++i)
+            {
+                for (const auto& item : conjuncts_[i])
+                {
+                    s.append(item.to_string(level+1));
+                }
+                if (i > 0)
+                {
+                    s.append(and_operator<Json,JsonReference>().to_string(level+1));
+                }
+            }
+
+            return s;
+
+        }
+    private:
+        value_type evaluate_tokens(const std::vector<token_type>& tokens,
+                                   dynamic_resources<Json,reference>& resources, 
+                                   reference root,
+                                   reference current,
+                                   result_options options,
+                                   std::error_code& ec) const
         {
             std::vector<stack_item_type> stack;
             std::vector<parameter_type> arg_stack;
-            std::vector<path_component_type> path = {path_component_type(current_node_arg)};
+            const path_component_type& path = resources.current_path();
 
             //std::cout << "EVALUATE TOKENS\n";
             //for (auto& tok : token_list_)
@@ -3140,9 +3303,9 @@ namespace detail {
             //}
             //std::cout << "\n";
 
-            if (!token_list_.empty())
+            if (!tokens.empty())
             {
-                for (auto& tok : token_list_)
+                for (auto& tok : tokens)
                 {
                     //std::cout << "Token: " << tok.to_string() << "\n";
                     switch (tok.type())
@@ -3300,7 +3463,7 @@ namespace detail {
                                         //std::cout << "node: " << node.path << ", " << *node.ptr << "\n";
                                         auto it = std::lower_bound(index.begin(),index.end(),node, path_node_less_type());
 
-                                        if (it != index.end() && it->path == node.path) 
+                                        if (it != index.end() && path_node_equal_type()(*it, node)) 
                                         {
                                             temp2.emplace_back(std::move(node));
                                             index.erase(it);
@@ -3335,25 +3498,184 @@ namespace detail {
             //}
             return stack.empty() ? Json::null() : stack.back().value();
         }
- 
-        std::string to_string(int level) const
+
+        // Replaces operators applied to literals with the literal result
+        void fold_constants()
         {
-            std::string s;
-            if (level > 0)
+            std::vector<token_type> folded;
+            folded.reserve(token_list_.size());
+            for (auto& tok : token_list_)
             {
-                s.append("\n");
-                s.append(level*2, ' ');
+                std::error_code ec;
+                if (tok.type() == token_kind::unary_operator && !folded.empty() && 
+                    folded.back().type() == token_kind::literal)
+                {
+                    Json operand(folded.back().value_);
+                    Json val = tok.unary_operator_->evaluate(operand, ec);
+                    if (!ec)
+                    {
+                        folded.back() = token_type(literal_arg, std::move(val));
+                        continue;
+                    }
+                }
+                else if (tok.type() == token_kind::binary_operator && folded.size() >= 2 && 
+                         folded[folded.size()-2].type() == token_kind::literal && 
+                         folded.back().type() == token_kind::literal)
+                {
+                    Json lhs(folded[folded.size()-2].value_);
+                    Json rhs(folded.back().value_);
+                    Json val = tok.binary_operator_->evaluate(lhs, rhs, ec);
+                    if (!ec)
+                    {
+                        folded.pop_back();
+                        folded.back() = token_type(literal_arg, std::move(val));
+                        continue;
+                    }
+                }
+                folded.push_back(std::move(tok));
             }
-            s.append("expression ");
-            for (const auto& item : token_list_)
+            token_list_.swap(folded);
+        }
+
+        static bool is_operand_start(const token_type& tok, std::size_t depth)
+        {
+            switch (tok.type())
             {
-                s.append(item.to_string(level+1));
+                case token_kind::literal:
+                case token_kind::root_node:
+                case token_kind::current_node:
+                    return true;
+                case token_kind::selector:
+                case token_kind::expression:
+                    return depth == 0;
+                default:
+                    return false;
             }
+        }
 
-            return s;
+        // Collects the operand ranges of a chain of && operators ending at last
+        static bool collect_conjuncts(const std::vector<token_type>& tokens, 
+                                      const std::vector<std::size_t>& depth,
+                                      std::size_t first, std::size_t last,
+                                      std::vector<std::pair<std::size_t,std::size_t>>& ranges)
+        {
+            static const auto and_oper = static_resources<Json,JsonReference>().get_and_operator();
 
+            if (!(last - first >= 3 && tokens[last-1].type() == token_kind::binary_operator && 
+                  tokens[last-1].binary_operator_ == and_oper))
+            {
+                ranges.emplace_back(first, last);
+                return true;
+            }
+            // The right operand starts at the last token where the stack holds just the left operand
+            const std::size_t base = depth[first];
+            std::size_t mid = last - 1;
+            while (mid > first && depth[mid] != base+1)
+            {
+                --mid;
+            }
+            if (mid == first || !is_operand_start(tokens[first], base) || !is_operand_start(tokens[mid], base+1))
+            {
+                return false;
+            }
+            for (std::size_t i = first+1; i <= mid; ++i)
+            {
+                if (depth[i] < base+1)
+                {
+                    return false;
+                }
+            }
+            return collect_conjuncts(tokens, depth, first, mid, ranges) && 
+                   collect_conjuncts(tokens, depth, mid, last-1, ranges);
         }
-    private:
+
+        // Moves the operands of a top level chain of && operators into conjuncts, 
+        // leaves tokens unchanged and returns false if there are fewer than two
+        static bool split_conjuncts(std::vector<token_type>& tokens, std::vector<std::vector<token_type>>& conjuncts)
+        {
+            // Stack depth before each token
+            std::vector<std::size_t> depth(tokens.size()+1);
+            std::size_t d = 0;
+            for (std::size_t i = 0; i < tokens.size(); ++i)
+            {
+                depth[i] = d;
+                switch (tokens[i].type())
+                {
+                    case token_kind::literal:
+                    case token_kind::root_node:
+                    case token_kind::current_node:
+                        ++d;
+                        break;
+                    case token_kind::unary_operator:
+                        if (d == 0)
+                        {
+                            return false;
+                        }
+                        break;
+                    case token_kind::binary_operator:
+                        if (d < 2)
+                        {
+                            return false;
+                        }
+                        --d;
+                        break;
+                    case token_kind::selector:
+                    case token_kind::expression:
+                        if (d == 0)
+                        {
+                            ++d;
+                        }
+                        break;
+                    default: // arguments and functions
+                        return false;
+                }
+            }
+            depth[tokens.size()] = d;
+            if (d != 1)
+            {
+                return false;
+            }
+
+            std::vector<std::pair<std::size_t,std::size_t>> ranges;
+            if (!collect_conjuncts(tokens, depth, 0, tokens.size(), ranges) || ranges.size() < 2)
+            {
+                return false;
+            }
+            for (const auto& range : ranges)
+            {
+                std::vector<token_type> conjunct;
+                for (std::size_t i = range.first; i < range.second; ++i)
+                {
+                    conjunct.push_back(std::move(tokens[i]));
+                }
+                conjuncts.push_back(std::move(conjunct));
+            }
+            return true;
+        }
+
+        static std::size_t estimate_cost(const std::vector<token_type>& tokens)
+        {
+            std::size_t cost = 0;
+            for (const auto& tok : tokens)
+            {
+                switch (tok.type())
+                {
+                    case token_kind::selector:
+                    case token_kind::expression:
+                        cost += 4;
+                        break;
+                    case token_kind::unary_operator: // includes regular expression matching
+                    case token_kind::function:
+                        cost += 8;
+                        break;
+                    default:
+                        cost += 1;
+                        break;
+                }
+            }
+            return cost;
+        }
+
         static stack_item_type nodes_to_stack_item(std::vector<path_node_type>& nodes, node_kind tag)
         {
             if (nodes.empty())
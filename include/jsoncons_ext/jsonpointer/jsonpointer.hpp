@@ -199,13 +199,18 @@ namespace jsoncons { namespace jsonpointer {
         return result;
     }
 
+    namespace detail {
+
+    template <class Json>
+    class pointer_resolver;
+
+    } // namespace detail
+
     // basic_json_pointer
 
     template <class CharT>
     class basic_json_pointer
     {
-    public:
-        std::basic_string<CharT> path_;
     public:
         // Member types
         using char_type = CharT;
@@ -214,6 +219,39 @@ namespace jsoncons { namespace jsonpointer {
         using const_iterator = json_pointer_iterator<typename string_type::const_iterator>;
         using iterator = const_iterator;
 
+    private:
+        template <class Json>
+        friend class detail::pointer_resolver;
+
+        // An unescaped reference token, and its value as an array index if it is one
+        struct token
+        {
+            string_type name;
+            std::size_t index;
+            bool is_index;
+
+            explicit token(string_type&& s)
+                : name(std::move(s)), index(0), is_index(false)
+            {
+                auto result = jsoncons::detail::to_integer_decimal<std::size_t>(name.data(), name.length());
+                if (result)
+                {
+                    index = result.value();
+                    is_index = true;
+                }
+            }
+
+            bool is_append() const
+            {
+                return name.size() == 1 && name[0] == '-';
+            }
+        };
+
+        string_type path_;
+        std::vector<token> tokens_;
+        std::error_code ec_; // set if path_ is not a JSON Pointer
+    public:
+
         // Constructors
         basic_json_pointer()
         {
@@ -221,14 +259,17 @@ namespace jsoncons { namespace jsonpointer {
         explicit basic_json_pointer(const string_type& s)
             : path_(s)
         {
+            parse();
         }
         explicit basic_json_pointer(string_type&& s)
             : path_(std::move(s))
         {
+            parse();
         }
         explicit basic_json_pointer(const CharT* s)
             : path_(s)
         {
+            parse();
         }
 
         basic_json_pointer(const basic_json_pointer&) = default;
@@ -245,12 +286,15 @@ namespace jsoncons { namespace jsonpointer {
         void clear()
         {
             path_.clear();
+            tokens_.clear();
+            ec_ = std::error_code();
         }
 
         basic_json_pointer& operator/=(const string_type& s) 
         {
             path_.push_back('/');
             path_.append(escape_string(s));
+            tokens_.emplace_back(string_type(s));
 
             return *this;
         }
@@ -263,6 +307,7 @@ namespace jsoncons { namespace jsonpointer {
             jsoncons::detail::from_integer(val, s);
             path_.push_back('/');
             path_.append(s);
+            tokens_.emplace_back(std::move(s));
 
             return *this;
         }
@@ -270,6 +315,14 @@ namespace jsoncons { namespace jsonpointer {
         basic_json_pointer& operator+=(const basic_json_pointer& p)
         {
             path_.append(p.path_);
+            if (ec_ || p.ec_)
+            {
+                parse();
+            }
+            else
+            {
+                tokens_.insert(tokens_.end(), p.tokens_.begin(), p.tokens_.end());
+            }
             return *this;
         }
 
@@ -330,6 +383,48 @@ namespace jsoncons { namespace jsonpointer {
             os << p.path_;
             return os;
         }
+
+    private:
+        // Splits path_ into unescaped tokens once, so that they aren't parsed again 
+        // each time the pointer is resolved. A malformed pointer is reported when it's used.
+        void parse()
+        {
+            tokens_.clear();
+            ec_ = std::error_code();
+
+            auto p = path_.begin();
+            auto end = path_.end();
+            while (p != end)
+            {
+                if (*p != '/')
+                {
+                    ec_ = jsonpointer_errc::expected_slash;
+                    tokens_.clear();
+                    return;
+                }
+                ++p;
+                string_type buffer;
+                for (; p != end && *p != '/'; ++p)
+                {
+                    if (*p == '~')
+                    {
+                        ++p;
+                        if (p == end || (*p != '0' && *p != '1'))
+                        {
+                            ec_ = jsonpointer_errc::expected_0_or_1;
+                            tokens_.clear();
+                            return;
+                        }
+                        buffer.push_back(*p == '0' ? '~' : '/');
+                    }
+                    else
+                    {
+                        buffer.push_back(*p);
+                    }
+                }
+                tokens_.emplace_back(std::move(buffer));
+            }
+        }
     };
 
     template <class CharT,class IntegerType>
@@ -382,12 +477,13 @@ namespace jsoncons { namespace jsonpointer {
         }
         else if (current->is_object())
         {
-            if (!current->contains(buffer))
+            auto it = current->find(buffer);
+            if (it == current->object_range().end())
             {
                 ec = jsonpointer_errc::key_not_found;
                 return current;
             }
-            current = std::addressof(current->at(buffer));
+            current = std::addressof(it->value());
         }
         else
         {
@@ -423,31 +519,291 @@ namespace jsoncons { namespace jsonpointer {
         }
         else if (current->is_object())
         {
-            if (!current->contains(buffer))
+            auto it = current->find(buffer);
+            if (it != current->object_range().end())
+            {
+                current = std::addressof(it->value());
+            }
+            else if (create_if_missing)
             {
-                if (create_if_missing)
+                auto r = current->try_emplace(buffer, Json());
+                current = std::addressof(r.first->value());
+            }
+            else
+            {
+                ec = jsonpointer_errc::key_not_found;
+                return current;
+            }
+        }
+        else
+        {
+            ec = jsonpointer_errc::expected_object_or_array;
+            return current;
+        }
+        return current;
+    }
+
+    // Resolves the tokens of a parsed basic_json_pointer, with one lookup per token, 
+    // and the array indices already converted
+    template <class Json>
+    class pointer_resolver
+    {
+        using char_type = typename Json::char_type;
+        using pointer_type = basic_json_pointer<char_type>;
+        using token_type = typename pointer_type::token;
+    public:
+
+        static const token_type& last(const pointer_type& location)
+        {
+            static const token_type empty{std::basic_string<char_type>()};
+            return location.tokens_.empty() ? empty : location.tokens_.back();
+        }
+
+        static std::size_t length(const pointer_type& location)
+        {
+            return location.tokens_.size();
+        }
+
+        static std::size_t parent_length(const pointer_type& location)
+        {
+            return location.tokens_.empty() ? 0 : location.tokens_.size() - 1;
+        }
+
+        // Returns the value at the first length tokens
+        static const Json* resolve(const Json* current, const pointer_type& location, std::size_t length, std::error_code& ec)
+        {
+            if (location.ec_)
+            {
+                ec = location.ec_;
+                return current;
+            }
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                const token_type& t = location.tokens_[i];
+                if (current->is_array())
+                {
+                    if (!t.is_index)
+                    {
+                        ec = t.is_append() ? jsonpointer_errc::index_exceeds_array_size : jsonpointer_errc::invalid_index;
+                        return current;
+                    }
+                    if (t.index >= current->size())
+                    {
+                        ec = jsonpointer_errc::index_exceeds_array_size;
+                        return current;
+                    }
+                    current = std::addressof(current->at(t.index));
+                }
+                else if (current->is_object())
                 {
-                    auto r = current->try_emplace(buffer, Json());
-                    current = std::addressof(r.first->value());
+                    auto it = current->find(t.name);
+                    if (it == current->object_range().end())
+                    {
+                        ec = jsonpointer_errc::key_not_found;
+                        return current;
+                    }
+                    current = std::addressof(it->value());
                 }
                 else
                 {
-                    ec = jsonpointer_errc::key_not_found;
+                    ec = jsonpointer_errc::expected_object_or_array;
                     return current;
                 }
             }
+            return current;
+        }
+
+        static Json* resolve(Json* current, const pointer_type& location, std::size_t length, bool create_if_missing, std::error_code& ec)
+        {
+            if (location.ec_)
+            {
+                ec = location.ec_;
+                return current;
+            }
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                const token_type& t = location.tokens_[i];
+                if (current->is_array())
+                {
+                    if (!t.is_index)
+                    {
+                        ec = t.is_append() ? jsonpointer_errc::index_exceeds_array_size : jsonpointer_errc::invalid_index;
+                        return current;
+                    }
+                    if (t.index >= current->size())
+                    {
+                        ec = jsonpointer_errc::index_exceeds_array_size;
+                        return current;
+                    }
+                    current = std::addressof(current->at(t.index));
+                }
+                else if (current->is_object())
+                {
+                    auto it = current->find(t.name);
+                    if (it != current->object_range().end())
+                    {
+                        current = std::addressof(it->value());
+                    }
+                    else if (create_if_missing)
+                    {
+                        auto r = current->try_emplace(t.name, Json());
+                        current = std::addressof(r.first->value());
+                    }
+                    else
+                    {
+                        ec = jsonpointer_errc::key_not_found;
+                        return current;
+                    }
+                }
+                else
+                {
+                    ec = jsonpointer_errc::expected_object_or_array;
+                    return current;
+                }
+            }
+            return current;
+        }
+
+        template <class T>
+        static void add(Json& root, const pointer_type& location, T&& value, bool create_if_missing, bool replace_existing, std::error_code& ec)
+        {
+            Json* current = resolve(std::addressof(root), location, parent_length(location), create_if_missing, ec);
+            if (ec)
+            {
+                return;
+            }
+            const token_type& t = last(location);
+            if (current->is_array())
+            {
+                if (t.is_append())
+                {
+                    current->emplace_back(std::forward<T>(value));
+                }
+                else if (!t.is_index)
+                {
+                    ec = jsonpointer_errc::invalid_index;
+                }
+                else if (t.index > current->size())
+                {
+                    ec = jsonpointer_errc::index_exceeds_array_size;
+                }
+                else if (t.index == current->size())
+                {
+                    current->emplace_back(std::forward<T>(value));
+                }
+                else
+                {
+                    current->insert(current->array_range().begin()+t.index,std::forward<T>(value));
+                }
+            }
+            else if (current->is_object())
+            {
+                if (replace_existing)
+                {
+                    current->insert_or_assign(t.name,std::forward<T>(value));
+                }
+                else
+                {
+                    auto r = current->try_emplace(t.name,std::forward<T>(value));
+                    if (!r.second)
+                    {
+                        ec = jsonpointer_errc::key_already_exists;
+                    }
+                }
+            }
             else
             {
-                current = std::addressof(current->at(buffer));
+                ec = jsonpointer_errc::expected_object_or_array;
             }
         }
-        else
+
+        static void remove(Json& root, const pointer_type& location, std::error_code& ec)
         {
-            ec = jsonpointer_errc::expected_object_or_array;
-            return current;
+            Json* current = resolve(std::addressof(root), location, parent_length(location), false, ec);
+            if (ec)
+            {
+                return;
+            }
+            const token_type& t = last(location);
+            if (current->is_array())
+            {
+                if (!t.is_index)
+                {
+                    ec = t.is_append() ? jsonpointer_errc::index_exceeds_array_size : jsonpointer_errc::invalid_index;
+                }
+                else if (t.index >= current->size())
+                {
+                    ec = jsonpointer_errc::index_exceeds_array_size;
+                }
+                else
+                {
+                    current->erase(current->array_range().begin()+t.index);
+                }
+            }
+            else if (current->is_object())
+            {
+                auto it = current->find(t.name);
+                if (it == current->object_range().end())
+                {
+                    ec = jsonpointer_errc::key_not_found;
+                }
+                else
+                {
+                    current->erase(it);
+                }
+            }
+            else
+            {
+                ec = jsonpointer_errc::expected_object_or_array;
+            }
         }
-        return current;
-    }
+
+        template <class T>
+        static void replace(Json& root, const pointer_type& location, T&& value, bool create_if_missing, std::error_code& ec)
+        {
+            Json* current = resolve(std::addressof(root), location, parent_length(location), create_if_missing, ec);
+            if (ec)
+            {
+                return;
+            }
+            const token_type& t = last(location);
+            if (current->is_array())
+            {
+                if (!t.is_index)
+                {
+                    ec = t.is_append() ? jsonpointer_errc::index_exceeds_array_size : jsonpointer_errc::invalid_index;
+                }
+                else if (t.index >= current->size())
+                {
+                    ec = jsonpointer_errc::index_exceeds_array_size;
+                }
+                else
+                {
+                    current->at(t.index) = std::forward<T>(value);
+                }
+            }
+            else if (current->is_object())
+            {
+                auto it = current->find(t.name);
+                if (it != current->object_range().end())
+                {
+                    it->value() = std::forward<T>(value);
+                }
+                else if (create_if_missing)
+                {
+                    current->try_emplace(t.name,std::forward<T>(value));
+                }
+                else
+                {
+                    ec = jsonpointer_errc::key_not_found;
+                }
+            }
+            else
+            {
+                ec = jsonpointer_errc::expected_object_or_array;
+            }
+        }
+    };
 
     } // namespace detail
 
@@ -704,16 +1060,12 @@ namespace jsoncons { namespace jsonpointer {
         }
         else if (current->is_object())
         {
-            if (current->contains(buffer))
+            auto r = current->try_emplace(buffer,std::forward<T>(value));
+            if (!r.second)
             {
                 ec = jsonpointer_errc::key_already_exists;
                 return;
             }
-            else
-            {
-                auto r = current->try_emplace(buffer,std::forward<T>(value));
-                current = std::addressof(r.first->value());
-            }
         }
         else
         {
@@ -795,15 +1147,13 @@ namespace jsoncons { namespace jsonpointer {
         }
         else if (current->is_object())
         {
-            if (!current->contains(buffer))
+            auto it2 = current->find(buffer);
+            if (it2 == current->object_range().end())
             {
                 ec = jsonpointer_errc::key_not_found;
                 return;
             }
-            else
-            {
-                current->erase(buffer);
-            }
+            current->erase(it2);
         }
         else
         {
@@ -877,22 +1227,19 @@ namespace jsoncons { namespace jsonpointer {
         }
         else if (current->is_object())
         {
-            if (!current->contains(buffer))
+            auto it2 = current->find(buffer);
+            if (it2 != current->object_range().end())
             {
-                if (create_if_missing)
-                {
-                    current->try_emplace(buffer,std::forward<T>(value));
-                }
-                else
-                {
-                    ec = jsonpointer_errc::key_not_found;
-                    return;
-                }
+                it2->value() = std::forward<T>(value);
+            }
+            else if (create_if_missing)
+            {
+                current->try_emplace(buffer,std::forward<T>(value));
             }
             else
             {
-                auto r = current->insert_or_assign(buffer,std::forward<T>(value));
-                current = std::addressof(r.first->value());
+                ec = jsonpointer_errc::key_not_found;
+                return;
             }
         }
         else
@@ -925,6 +1272,183 @@ namespace jsoncons { namespace jsonpointer {
         }
     }
 
+    // Overloads that take a basic_json_pointer, which is parsed once, rather than a string
+
+    template<class Json>
+    Json& get(Json& root, 
+              const basic_json_pointer<typename Json::char_type>& location, 
+              bool create_if_missing,
+              std::error_code& ec)
+    {
+        using resolver = jsoncons::jsonpointer::detail::pointer_resolver<Json>;
+        return *resolver::resolve(std::addressof(root), location, resolver::length(location), create_if_missing, ec);
+    }
+
+    template<class Json>
+    const Json& get(const Json& root, const basic_json_pointer<typename Json::char_type>& location, std::error_code& ec)
+    {
+        using resolver = jsoncons::jsonpointer::detail::pointer_resolver<Json>;
+        return *resolver::resolve(std::addressof(root), location, resolver::length(location), ec);
+    }
+
+    template<class Json>
+    Json& get(Json& root, 
+              const basic_json_pointer<typename Json::char_type>& location, 
+              std::error_code& ec)
+    {
+        return get(root, location, false, ec);
+    }
+
+    template<class Json>
+    Json& get(Json& root, 
+              const basic_json_pointer<typename Json::char_type>& location,
+              bool create_if_missing = false)
+    {
+        std::error_code ec;
+        Json& j = get(root, location, create_if_missing, ec);
+        if (ec)
+        {
+            JSONCONS_THROW(jsonpointer_error(ec));
+        }
+        return j;
+    }
+
+    template<class Json>
+    const Json& get(const Json& root, const basic_json_pointer<typename Json::char_type>& location)
+    {
+        std::error_code ec;
+        const Json& j = get(root, location, ec);
+        if (ec)
+        {
+            JSONCONS_THROW(jsonpointer_error(ec));
+        }
+        return j;
+    }
+
+    template<class Json>
+    bool contains(const Json& root, const basic_json_pointer<typename Json::char_type>& location)
+    {
+        std::error_code ec;
+        get(root, location, ec);
+        return !ec ? true : false;
+    }
+
+    template<class Json,class T>
+    void add(Json& root, 
+             const basic_json_pointer<typename Json::char_type>& location, 
+             T&& value, 
+             bool create_if_missing,
+             std::error_code& ec)
+    {
+        jsoncons::jsonpointer::detail::pointer_resolver<Json>::add(root, location, std::forward<T>(value), create_if_missing, true, ec);
+    }
+
+    template<class Json,class T>
+    void add(Json& root, 
+             const basic_json_pointer<typename Json::char_type>& location, 
+             T&& value, 
+             std::error_code& ec)
+    {
+        add(root, location, std::forward<T>(value), false, ec);
+    }
+
+    template<class Json,class T>
+    void add(Json& root, 
+             const basic_json_pointer<typename Json::char_type>& location, 
+             T&& value,
+             bool create_if_missing = false)
+    {
+        std::error_code ec;
+        add(root, location, std::forward<T>(value), create_if_missing, ec);
+        if (ec)
+        {
+            JSONCONS_THROW(jsonpointer_error(ec));
+        }
+    }
+
+    template<class Json, class T>
+    void add_if_absent(Json& root, 
+                const basic_json_pointer<typename Json::char_type>& location, 
+                T&& value, 
+                bool create_if_missing,
+                std::error_code& ec)
+    {
+        jsoncons::jsonpointer::detail::pointer_resolver<Json>::add(root, location, std::forward<T>(value), create_if_missing, false, ec);
+    }
+
+    template<class Json, class T>
+    void add_if_absent(Json& root, 
+                const basic_json_pointer<typename Json::char_type>& location, 
+                T&& value, 
+                std::error_code& ec)
+    {
+        add_if_absent(root, location, std::forward<T>(value), false, ec);
+    }
+
+    template<class Json, class T>
+    void add_if_absent(Json& root, 
+                const basic_json_pointer<typename Json::char_type>& location, 
+                T&& value,
+                bool create_if_missing = false)
+    {
+        std::error_code ec;
+        add_if_absent(root, location, std::forward<T>(value), create_if_missing, ec);
+        if (ec)
+        {
+            JSONCONS_THROW(jsonpointer_error(ec));
+        }
+    }
+
+    template<class Json>
+    void remove(Json& root, const basic_json_pointer<typename Json::char_type>& location, std::error_code& ec)
+    {
+        jsoncons::jsonpointer::detail::pointer_resolver<Json>::remove(root, location, ec);
+    }
+
+    template<class Json>
+    void remove(Json& root, const basic_json_pointer<typename Json::char_type>& location)
+    {
+        std::error_code ec;
+        remove(root, location, ec);
+        if (ec)
+        {
+            JSONCONS_THROW(jsonpointer_error(ec));
+        }
+    }
+
+    template<class Json, class T>
+    void replace(Json& root, 
+                 const basic_json_pointer<typename Json::char_type>& location, 
+                 T&& value, 
+                 bool create_if_missing,
+                 std::error_code& ec)
+    {
+        jsoncons::jsonpointer::detail::pointer_resolver<Json>::replace(root, location, std::forward<T>(value), create_if_missing, ec);
+    }
+
+    template<class Json, class T>
+    void replace(Json& root, 
+                 const basic_json_pointer<typename Json::char_type>& location, 
+                 T&& value, 
+                 std::error_code& ec)
+    {
+        replace(root, location, std::forward<T>(value), false, ec);
+    }
+
+    template<class Json, class T>
+    void replace(Json& root, 
+                 const basic_json_pointer<typename Json::char_type>& location, 
+                 T&& value, 
+                 bool create_if_missing = false)
+    {
+        std::error_code ec;
+        replace(root, location, std::forward<T>(value), create_if_missing, ec);
+        if (ec)
+        {
+            JSONCONS_THROW(jsonpointer_error(ec));
+        }
+    }
+
     template <class String,class Result>
     typename std::enable_if<std::is_convertible<typename String::value_type,typename Result::value_type>::value>::type
     escape(const String& s, Result& result)
@@ -832,13 +832,13 @@ namespace jsonschema {
 
     // format checkers
     using format_checker = std::function<void(const std::string& absolute_keyword_location,
-                                              const uri_wrapper& instance_location, 
+                                              const instance_path& instance_location, 
                                               const std::string&, 
                                               error_reporter& reporter)>;
 
     inline
     void rfc3339_date_check(const std::string& absolute_keyword_location,
-                            const uri_wrapper& instance_location, 
+                            const instance_path& instance_location, 
                             const std::string& value,
                             error_reporter& reporter)
     {
@@ -851,7 +851,7 @@ namespace jsonschema {
 
     inline
     void rfc3339_time_check(const std::string& absolute_keyword_location,
-                            const uri_wrapper& instance_location, 
+                            const instance_path& instance_location, 
                             const std::string &value,
                             error_reporter& reporter)
     {
@@ -864,7 +864,7 @@ namespace jsonschema {
 
     inline
     void rfc3339_date_time_check(const std::string& absolute_keyword_location,
-                                 const uri_wrapper& instance_location, 
+                                 const instance_path& instance_location, 
                                  const std::string &value,
                                  error_reporter& reporter)
     {
@@ -877,7 +877,7 @@ namespace jsonschema {
 
     inline
     void email_check(const std::string& absolute_keyword_location,
-                     const uri_wrapper& instance_location, 
+                     const instance_path& instance_location, 
                      const std::string& value,
                      error_reporter& reporter) 
     {
@@ -890,7 +890,7 @@ namespace jsonschema {
 
     inline
     void hostname_check(const std::string& absolute_keyword_location,
-                        const uri_wrapper& instance_location, 
+                        const instance_path& instance_location, 
                         const std::string& value,
                         error_reporter& reporter) 
     {
@@ -903,7 +903,7 @@ namespace jsonschema {
 
     inline
     void ipv4_check(const std::string& absolute_keyword_location,
-                    const uri_wrapper& instance_location, 
+                    const instance_path& instance_location, 
                     const std::string& value,
                     error_reporter& reporter) 
     {
@@ -916,7 +916,7 @@ namespace jsonschema {
 
     inline
     void ipv6_check(const std::string& absolute_keyword_location,
-                    const uri_wrapper& instance_location, 
+                    const instance_path& instance_location, 
                     const std::string& value,
                     error_reporter& reporter) 
     {
@@ -929,7 +929,7 @@ namespace jsonschema {
 
     inline
     void regex_check(const std::string& absolute_keyword_location,
-                     const uri_wrapper& instance_location, 
+                     const instance_path& instance_location, 
                      const std::string& value,
                      error_reporter& reporter) 
     {
@@ -18,6 +18,11 @@
 #include <iostream>
 #include <cassert>
 #include <functional>
+#include <vector>
+#include <thread>
+#include <atomic> // std::atomic
+#include <exception> // std::exception_ptr
+#include <algorithm> // std::min, std::max
 
 namespace jsoncons {
 namespace jsonschema {
@@ -62,11 +67,20 @@ namespace jsonschema {
     template <class Json>
     class json_validator
     {
+        using char_type = typename Json::char_type;
+
+        // Instances of a batch are handed out to threads in blocks of this size
+        static constexpr std::size_t batch_block_size = 64;
+
         std::shared_ptr<json_schema<Json>> root_;
+        std::size_t max_threads_;
 
     public:
-        json_validator(std::shared_ptr<json_schema<Json>> root)
-            : root_(root)
+        // The compiled schema is immutable and shared by the threads of a validation.
+        // max_threads 0 means std::thread::hardware_concurrency()
+        json_validator(std::shared_ptr<json_schema<Json>> root, std::size_t max_threads = 1)
+            : root_(root), 
+              max_threads_(max_threads != 0 ? max_threads : (std::max)(std::thread::hardware_concurrency(), 1u))
         {
         }
 
@@ -82,7 +96,8 @@ namespace jsonschema {
         Json validate(const Json& instance) const
         {
             throwing_error_reporter reporter;
-            uri_wrapper instance_location("#");
+            reporter.max_threads(max_threads_);
+            instance_path instance_location;
             Json patch(json_array_arg);
 
             root_->validate(instance_location, instance, reporter, patch);
@@ -93,7 +108,8 @@ namespace jsonschema {
         bool is_valid(const Json& instance) const
         {
             fail_early_reporter reporter;
-            uri_wrapper instance_location("#");
+            reporter.max_threads(max_threads_);
+            instance_path instance_location;
             Json patch(json_array_arg);
 
             root_->validate(instance_location, instance, reporter, patch);
@@ -105,13 +121,165 @@ namespace jsonschema {
         typename std::enable_if<type_traits::is_unary_function_object_exact<Reporter,void,validation_output>::value,Json>::type
         validate(const Json& instance, const Reporter& reporter) const
         {
-            uri_wrapper instance_location("#");
+            instance_path instance_location;
             Json patch(json_array_arg);
 
             error_reporter_adaptor adaptor(reporter);
+            adaptor.max_threads(max_threads_);
             root_->validate(instance_location, instance, adaptor, patch);
             return patch;
         }
+
+        // Validate each instance in [first, last) against a JSON Schema, on up to max_threads
+        // threads, and return whether each is valid
+        template <class RandomIt>
+        std::vector<bool> is_valid(RandomIt first, RandomIt last) const
+        {
+            std::size_t count = static_cast<std::size_t>(last - first);
+            std::vector<char> valid(count, 0);
+
+            for_each_instance(count, [first,&valid](std::size_t i, const json_schema<Json>& root)
+            {
+                fail_early_reporter reporter;
+                instance_path instance_location;
+                Json patch(json_array_arg);
+
+                root.validate(instance_location, first[i], reporter, patch);
+                valid[i] = reporter.error_count() == 0 ? 1 : 0;
+            });
+
+            return std::vector<bool>(valid.begin(), valid.end());
+        }
+
+        // Validate each instance in [first, last) against a JSON Schema, on up to max_threads
+        // threads, with a provided error reporter that is called with the index of the instance
+        // and the error. The reporter is called on the calling thread, for each instance in 
+        // turn, after all have been validated. Returns the patch for each instance.
+        template <class RandomIt,class Reporter>
+        std::vector<Json> validate(RandomIt first, RandomIt last, const Reporter& reporter) const
+        {
+            std::size_t count = static_cast<std::size_t>(last - first);
+            std::vector<Json> patches(count);
+            std::vector<std::vector<validation_output>> errors(count);
+
+            for_each_instance(count, [first,&patches,&errors](std::size_t i, const json_schema<Json>& root)
+            {
+                collecting_error_reporter local_reporter;
+                instance_path instance_location;
+                Json patch(json_array_arg);
+
+                root.validate(instance_location, first[i], local_reporter, patch);
+                patches[i] = std::move(patch);
+                errors[i] = std::move(local_reporter.errors);
+            });
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                for (const auto& error : errors[i])
+                {
+                    reporter(i, error);
+                }
+            }
+            return patches;
+        }
+
+        // Validate a value read from a cursor, e.g. a json_cursor or cbor_stream_cursor, 
+        // without reading the whole value into memory. Validation begins at the cursor's 
+        // current event. Subtrees are read into memory only where a keyword needs them 
+        // as a whole (uniqueItems, contains, enum, const, allOf/anyOf/oneOf/not, 
+        // if/then/else and dependencies).
+
+        // Validate with a default throwing error reporter
+        Json validate(basic_staj_cursor<char_type>& cursor) const
+        {
+            throwing_error_reporter reporter;
+            instance_path instance_location;
+            Json patch(json_array_arg);
+
+            root_->validate(instance_location, cursor, reporter, patch);
+            return patch;
+        }
+
+        // Stops reading at the first error
+        bool is_valid(basic_staj_cursor<char_type>& cursor) const
+        {
+            fail_early_reporter reporter;
+            instance_path instance_location;
+            Json patch(json_array_arg);
+
+            root_->validate(instance_location, cursor, reporter, patch);
+            return reporter.error_count() == 0;
+        }
+
+        // Validate with a provided error reporter
+        template <class Reporter>
+        typename std::enable_if<type_traits::is_unary_function_object_exact<Reporter,void,validation_output>::value,Json>::type
+        validate(basic_staj_cursor<char_type>& cursor, const Reporter& reporter) const
+        {
+            instance_path instance_location;
+            Json patch(json_array_arg);
+
+            error_reporter_adaptor adaptor(reporter);
+            root_->validate(instance_location, cursor, adaptor, patch);
+            return patch;
+        }
+
+    private:
+
+        // Calls f(i, schema) for each i in [0, count), on up to max_threads threads 
+        template <class F>
+        void for_each_instance(std::size_t count, F f) const
+        {
+            std::size_t thread_count = (std::min)(max_threads_, (count + batch_block_size - 1) / batch_block_size);
+            const json_schema<Json>& root = *root_;
+            std::atomic<std::size_t> next(0);
+            std::vector<std::exception_ptr> exceptions(thread_count);
+
+            auto run = [&root,&f,&next,&exceptions,count](std::size_t thread_index)
+            {
+                JSONCONS_TRY
+                {
+                    std::size_t first;
+                    while ((first = next.fetch_add(batch_block_size)) < count)
+                    {
+                        std::size_t last = (std::min)(first + batch_block_size, count);
+                        for (std::size_t i = first; i < last; ++i)
+                        {
+                            f(i, root);
+                        }
+                    }
+                }
+                JSONCONS_CATCH(...)
+                {
+                    exceptions[thread_index] = std::current_exception();
+                }
+            };
+
+            {
+                std::vector<std::thread> threads;
+                detail::thread_join_guard guard{threads};
+                if (thread_count > 1)
+                {
+                    threads.reserve(thread_count-1);
+                    for (std::size_t i = 1; i < thread_count; ++i)
+                    {
+                        threads.emplace_back(run, i);
+                    }
+                }
+                if (thread_count > 0)
+                {
+                    run(0);
+                }
+            }
+
+            for (auto& e : exceptions)
+            {
+                if (e)
+                {
+                    std::rethrow_exception(e);
+                }
+            }
+        }
     };
 
 } // namespace jsonschema
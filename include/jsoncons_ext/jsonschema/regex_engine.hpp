@@ -0,0 +1,1163 @@
+// Copyright 2020 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSONSCHEMA_REGEX_ENGINE_HPP
+#define JSONCONS_JSONSCHEMA_REGEX_ENGINE_HPP
+
+#include <jsoncons/config/jsoncons_config.hpp>
+#include <jsoncons_ext/jsonschema/jsonschema_error.hpp>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory> // std::shared_ptr
+#include <functional> // std::function
+#include <algorithm> // std::sort, std::upper_bound
+#include <utility> // std::pair
+#if defined(JSONCONS_HAS_STD_REGEX)
+#include <regex>
+#endif
+
+namespace jsoncons {
+namespace jsonschema {
+
+    // A compiled regular expression, as used by the "pattern" and
+    // "patternProperties" keywords. Implementations must allow concurrent calls
+    // to search.
+    class regex_matcher
+    {
+    public:
+        virtual ~regex_matcher() = default;
+
+        // Returns true if the regular expression matches some part of s
+        virtual bool search(const jsoncons::string_view& s) const = 0;
+    };
+
+    using regex_matcher_pointer = std::shared_ptr<const regex_matcher>;
+
+    // Compiles an ECMAScript regular expression. Throws schema_error if the
+    // expression is not valid, and returns a null pointer if it cannot be
+    // checked, in which case the keyword is ignored.
+    using regex_engine = std::function<regex_matcher_pointer(const std::string& pattern)>;
+
+namespace detail {
+
+    // Decodes the UTF-8 sequence at p, ill-formed input decodes to U+FFFD one byte at a time
+    inline
+    uint32_t next_codepoint(const char*& p, const char* last)
+    {
+        auto b0 = static_cast<uint8_t>(*p++);
+        if (b0 < 0x80)
+        {
+            return b0;
+        }
+        std::size_t length = b0 >= 0xF0 ? 3 : (b0 >= 0xE0 ? 2 : (b0 >= 0xC0 ? 1 : 0));
+        if (length == 0 || b0 > 0xF4 || static_cast<std::size_t>(last - p) < length)
+        {
+            return 0xFFFD;
+        }
+        uint32_t cp = b0 & (0x3F >> length);
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            auto b = static_cast<uint8_t>(p[i]);
+            if ((b & 0xC0) != 0x80)
+            {
+                return 0xFFFD;
+            }
+            cp = (cp << 6) | (b & 0x3F);
+        }
+        p += length;
+        return cp;
+    }
+
+    // Matches the subset of ECMAScript regular expressions that can be
+    // recognized by a finite automaton: literals, ".", character classes,
+    // the \d \w \s escapes and their complements, groups, alternation,
+    // greedy and lazy quantifiers, and the ^ and $ anchors. Patterns are
+    // compiled to an NFA and then, when the number of states stays small, to
+    // a DFA over classes of code points, so matching takes time linear in the
+    // length of the input and never backtracks.
+    class automaton_regex : public regex_matcher
+    {
+        static constexpr uint32_t max_codepoint = 0x10FFFF;
+        static constexpr std::size_t max_nfa_states = 10000;
+        static constexpr std::size_t max_dfa_states = 1000;
+
+        using range_type = std::pair<uint32_t,uint32_t>;
+        using range_set = std::vector<range_type>;
+
+        enum class node_kind {empty, chars, line_begin, line_end, concat, alternation, repeat};
+
+        struct node
+        {
+            node_kind kind;
+            range_set ranges;
+            std::vector<node> children;
+            std::size_t min;
+            std::size_t max; // max_repeat when unbounded
+
+            explicit node(node_kind k = node_kind::empty)
+                : kind(k), min(0), max(0)
+            {
+            }
+        };
+
+        static constexpr std::size_t max_repeat = static_cast<std::size_t>(-1);
+
+        enum class state_kind {chars, epsilon, split, line_begin, line_end, match};
+
+        struct nfa_state
+        {
+            state_kind kind;
+            range_set ranges;
+            std::size_t out1;
+            std::size_t out2;
+
+            nfa_state(state_kind k)
+                : kind(k), out1(npos), out2(npos)
+            {
+            }
+        };
+
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        // The pattern parser
+
+        class parser
+        {
+            std::vector<uint32_t> input_;
+            std::size_t pos_;
+            bool supported_;
+        public:
+            parser(const std::string& pattern)
+                : pos_(0), supported_(true)
+            {
+                const char* p = pattern.data();
+                const char* last = p + pattern.size();
+                while (p < last)
+                {
+                    input_.push_back(next_codepoint(p, last));
+                }
+            }
+
+            bool supported() const
+            {
+                return supported_;
+            }
+
+            node parse()
+            {
+                node result = parse_alternation();
+                if (pos_ < input_.size())
+                {
+                    // Only an unbalanced ')' stops the top level alternation
+                    JSONCONS_THROW(schema_error("Unmatched ')' in regular expression"));
+                }
+                return result;
+            }
+        private:
+            bool at_end() const
+            {
+                return pos_ >= input_.size();
+            }
+
+            uint32_t peek(std::size_t offset = 0) const
+            {
+                return pos_ + offset < input_.size() ? input_[pos_ + offset] : 0;
+            }
+
+            node parse_alternation()
+            {
+                node alt(node_kind::alternation);
+                alt.children.push_back(parse_sequence());
+                while (!at_end() && peek() == '|')
+                {
+                    ++pos_;
+                    alt.children.push_back(parse_sequence());
+                }
+                if (alt.children.size() == 1)
+                {
+                    return std::move(alt.children.front());
+                }
+                return alt;
+            }
+
+            node parse_sequence()
+            {
+                node seq(node_kind::concat);
+                while (!at_end() && peek() != '|' && peek() != ')')
+                {
+                    node atom = parse_atom();
+                    parse_quantifier(atom);
+                    seq.children.push_back(std::move(atom));
+                }
+                return seq;
+            }
+
+            node parse_atom()
+            {
+                uint32_t c = input_[pos_++];
+                switch (c)
+                {
+                    case '(':
+                    {
+                        if (peek() == '?')
+                        {
+                            if (peek(1) != ':')
+                            {
+                                // Lookahead and lookbehind assertions, named groups
+                                supported_ = false;
+                            }
+                            pos_ += 2;
+                        }
+                        node group = parse_alternation();
+                        if (at_end() || peek() != ')')
+                        {
+                            JSONCONS_THROW(schema_error("Missing ')' in regular expression"));
+                        }
+                        ++pos_;
+                        return group;
+                    }
+                    case '.':
+                    {
+                        node n(node_kind::chars);
+                        n.ranges = negate({{'\n','\n'},{'\r','\r'},{0x2028,0x2029}});
+                        return n;
+                    }
+                    case '[':
+                        return parse_class();
+                    case '^':
+                        return node(node_kind::line_begin);
+                    case '$':
+                        return node(node_kind::line_end);
+                    case '\\':
+                        return parse_escape();
+                    case '*': case '+': case '?':
+                        JSONCONS_THROW(schema_error("Nothing to repeat in regular expression"));
+                    case '{':
+                        if (is_counted_repetition())
+                        {
+                            JSONCONS_THROW(schema_error("Nothing to repeat in regular expression"));
+                        }
+                        return literal(c);
+                    default:
+                        return literal(c);
+                }
+            }
+
+            static node literal(uint32_t c)
+            {
+                node n(node_kind::chars);
+                n.ranges.emplace_back(c, c);
+                return n;
+            }
+
+            node parse_escape()
+            {
+                if (at_end())
+                {
+                    JSONCONS_THROW(schema_error("Trailing '\\' in regular expression"));
+                }
+                uint32_t c = peek();
+                switch (c)
+                {
+                    case 'b': case 'B':
+                        // Word boundaries
+                        ++pos_;
+                        supported_ = false;
+                        return node();
+                    case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+                        // Back references
+                        ++pos_;
+                        supported_ = false;
+                        return node();
+                    default:
+                    {
+                        node n(node_kind::chars);
+                        n.ranges = parse_escape_ranges(false);
+                        return n;
+                    }
+                }
+            }
+
+            // Parses the escape that follows a '\', in or outside a character class
+            range_set parse_escape_ranges(bool in_class)
+            {
+                uint32_t c = input_[pos_++];
+                switch (c)
+                {
+                    case 'd':
+                        return digit_ranges();
+                    case 'D':
+                        return negate(digit_ranges());
+                    case 'w':
+                        return word_ranges();
+                    case 'W':
+                        return negate(word_ranges());
+                    case 's':
+                        return space_ranges();
+                    case 'S':
+                        return negate(space_ranges());
+                    case 't':
+                        return {{'\t','\t'}};
+                    case 'n':
+                        return {{'\n','\n'}};
+                    case 'r':
+                        return {{'\r','\r'}};
+                    case 'f':
+                        return {{'\f','\f'}};
+                    case 'v':
+                        return {{'\v','\v'}};
+                    case '0':
+                        return {{0,0}};
+                    case 'b':
+                        // Backspace inside a class
+                        return {{'\b','\b'}};
+                    case 'c':
+                    {
+                        uint32_t letter = peek();
+                        if (!at_end() && ((letter >= 'a' && letter <= 'z') || (letter >= 'A' && letter <= 'Z')))
+                        {
+                            ++pos_;
+                            return {{letter % 32, letter % 32}};
+                        }
+                        --pos_;
+                        return {{'\\','\\'}};
+                    }
+                    case 'x':
+                    {
+                        uint32_t cp = 0;
+                        if (read_hex(2, cp))
+                        {
+                            return {{cp,cp}};
+                        }
+                        return {{'x','x'}};
+                    }
+                    case 'u':
+                    {
+                        uint32_t cp = 0;
+                        if (!read_hex(4, cp))
+                        {
+                            return {{'u','u'}};
+                        }
+                        if (cp >= 0xD800 && cp <= 0xDBFF && peek() == '\\' && peek(1) == 'u')
+                        {
+                            std::size_t save = pos_;
+                            pos_ += 2;
+                            uint32_t low = 0;
+                            if (read_hex(4, low) && low >= 0xDC00 && low <= 0xDFFF)
+                            {
+                                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                            }
+                            else
+                            {
+                                pos_ = save;
+                            }
+                        }
+                        return {{cp,cp}};
+                    }
+                    case 'p': case 'P': case 'k':
+                        // Unicode properties, named back references
+                        supported_ = false;
+                        return {{c,c}};
+                    default:
+                        if (!in_class && c >= '1' && c <= '9')
+                        {
+                            supported_ = false;
+                        }
+                        // Identity escape
+                        return {{c,c}};
+                }
+            }
+
+            bool read_hex(std::size_t count, uint32_t& cp)
+            {
+                if (pos_ + count > input_.size())
+                {
+                    return false;
+                }
+                uint32_t value = 0;
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    uint32_t c = input_[pos_ + i];
+                    value *= 16;
+                    if (c >= '0' && c <= '9')
+                    {
+                        value += c - '0';
+                    }
+                    else if (c >= 'a' && c <= 'f')
+                    {
+                        value += c - 'a' + 10;
+                    }
+                    else if (c >= 'A' && c <= 'F')
+                    {
+                        value += c - 'A' + 10;
+                    }
+                    else
+                    {
+                        return false;
+                    }
+                }
+                pos_ += count;
+                cp = value;
+                return true;
+            }
+
+            node parse_class()
+            {
+                node n(node_kind::chars);
+                bool negated = false;
+                if (peek() == '^' && !at_end())
+                {
+                    negated = true;
+                    ++pos_;
+                }
+                range_set ranges;
+                while (true)
+                {
+                    if (at_end())
+                    {
+                        JSONCONS_THROW(schema_error("Missing ']' in regular expression"));
+                    }
+                    if (peek() == ']')
+                    {
+                        // [] matches nothing, [^] matches everything
+                        ++pos_;
+                        break;
+                    }
+
+                    range_set lo = parse_class_atom();
+                    if (peek() == '-' && pos_ + 1 < input_.size() && input_[pos_ + 1] != ']')
+                    {
+                        ++pos_;
+                        range_set hi = parse_class_atom();
+                        if (lo.size() != 1 || hi.size() != 1 || lo[0].first != lo[0].second || hi[0].first != hi[0].second)
+                        {
+                            // A class escape such as \d cannot be the end of a range
+                            ranges.insert(ranges.end(), lo.begin(), lo.end());
+                            ranges.emplace_back('-', '-');
+                            ranges.insert(ranges.end(), hi.begin(), hi.end());
+                        }
+                        else
+                        {
+                            if (lo[0].first > hi[0].first)
+                            {
+                                JSONCONS_THROW(schema_error("Range out of order in character class"));
+                            }
+                            ranges.emplace_back(lo[0].first, hi[0].first);
+                        }
+                    }
+                    else
+                    {
+                        ranges.insert(ranges.end(), lo.begin(), lo.end());
+                    }
+                }
+                n.ranges = normalize(std::move(ranges));
+                if (negated)
+                {
+                    n.ranges = negate(n.ranges);
+                }
+                return n;
+            }
+
+            range_set parse_class_atom()
+            {
+                uint32_t c = input_[pos_++];
+                if (c == '\\')
+                {
+                    if (at_end())
+                    {
+                        JSONCONS_THROW(schema_error("Trailing '\\' in regular expression"));
+                    }
+                    return parse_escape_ranges(true);
+                }
+                return {{c,c}};
+            }
+
+            bool is_counted_repetition() const
+            {
+                std::size_t i = pos_;
+                std::size_t digits = 0;
+                while (i < input_.size() && input_[i] >= '0' && input_[i] <= '9')
+                {
+                    ++i;
+                    ++digits;
+                }
+                if (digits == 0)
+                {
+                    return false;
+                }
+                if (i < input_.size() && input_[i] == ',')
+                {
+                    ++i;
+                    while (i < input_.size() && input_[i] >= '0' && input_[i] <= '9')
+                    {
+                        ++i;
+                    }
+                }
+                return i < input_.size() && input_[i] == '}';
+            }
+
+            std::size_t read_count()
+            {
+                std::size_t value = 0;
+                while (!at_end() && peek() >= '0' && peek() <= '9')
+                {
+                    value = value*10 + (peek() - '0');
+                    if (value > max_nfa_states)
+                    {
+                        value = max_nfa_states + 1;
+                    }
+                    ++pos_;
+                }
+                return value;
+            }
+
+            void parse_quantifier(node& atom)
+            {
+                if (at_end())
+                {
+                    return;
+                }
+                std::size_t min = 0;
+                std::size_t max = 0;
+                switch (peek())
+                {
+                    case '*':
+                        ++pos_;
+                        min = 0; max = max_repeat;
+                        break;
+                    case '+':
+                        ++pos_;
+                        min = 1; max = max_repeat;
+                        break;
+                    case '?':
+                        ++pos_;
+                        min = 0; max = 1;
+                        break;
+                    case '{':
+                        ++pos_;
+                        if (!is_counted_repetition())
+                        {
+                            --pos_;
+                            return;
+                        }
+                        min = read_count();
+                        max = min;
+                        if (peek() == ',')
+                        {
+                            ++pos_;
+                            max = (peek() == '}') ? max_repeat : read_count();
+                        }
+                        ++pos_; // '}'
+                        if (max < min)
+                        {
+                            JSONCONS_THROW(schema_error("Numbers out of order in {} quantifier"));
+                        }
+                        break;
+                    default:
+                        return;
+                }
+                if (!at_end() && peek() == '?')
+                {
+                    // Lazy quantifiers accept the same strings
+                    ++pos_;
+                }
+                if (atom.kind == node_kind::line_begin || atom.kind == node_kind::line_end)
+                {
+                    JSONCONS_THROW(schema_error("Nothing to repeat in regular expression"));
+                }
+                node rep(node_kind::repeat);
+                rep.min = min;
+                rep.max = max;
+                rep.children.push_back(std::move(atom));
+                atom = std::move(rep);
+            }
+        };
+
+        // Sorts and merges overlapping and adjacent ranges
+        static range_set normalize(range_set ranges)
+        {
+            std::sort(ranges.begin(), ranges.end());
+            range_set result;
+            for (const auto& r : ranges)
+            {
+                if (!result.empty() && r.first <= result.back().second + 1)
+                {
+                    if (r.second > result.back().second)
+                    {
+                        result.back().second = r.second;
+                    }
+                }
+                else
+                {
+                    result.push_back(r);
+                }
+            }
+            return result;
+        }
+
+        static range_set negate(const range_set& ranges)
+        {
+            range_set sorted = normalize(ranges);
+            range_set result;
+            uint32_t next = 0;
+            for (const auto& r : sorted)
+            {
+                if (r.first > next)
+                {
+                    result.emplace_back(next, r.first - 1);
+                }
+                next = r.second + 1;
+            }
+            if (next <= max_codepoint)
+            {
+                result.emplace_back(next, static_cast<uint32_t>(max_codepoint));
+            }
+            return result;
+        }
+
+        static range_set digit_ranges()
+        {
+            return {{'0','9'}};
+        }
+
+        static range_set word_ranges()
+        {
+            return {{'0','9'},{'A','Z'},{'_','_'},{'a','z'}};
+        }
+
+        static range_set space_ranges()
+        {
+            return {{'\t','\r'},{' ',' '},{0xA0,0xA0},{0x1680,0x1680},{0x2000,0x200A},
+                    {0x2028,0x2029},{0x202F,0x202F},{0x205F,0x205F},{0x3000,0x3000},{0xFEFF,0xFEFF}};
+        }
+
+        // Automaton
+
+        std::vector<nfa_state> states_;
+        std::size_t start_;
+        bool too_large_;
+
+        // DFA over classes of code points, the empty vector if the DFA would be too large
+        std::vector<uint32_t> class_bounds_; // class i is [class_bounds_[i], class_bounds_[i+1])
+        uint16_t ascii_classes_[128];
+        std::vector<std::size_t> transitions_; // state*class_count + class
+        std::vector<bool> accepting_;
+        std::vector<bool> accepting_at_end_;
+        std::size_t dead_state_;
+    public:
+        // Throws schema_error if the pattern is invalid, returns null if it uses
+        // constructs that need backtracking
+        static std::shared_ptr<automaton_regex> compile(const std::string& pattern)
+        {
+            parser p(pattern);
+            node root = p.parse();
+            if (!p.supported())
+            {
+                return std::shared_ptr<automaton_regex>();
+            }
+            auto re = std::make_shared<automaton_regex>();
+            re->build_nfa(root);
+            if (re->too_large_)
+            {
+                return std::shared_ptr<automaton_regex>();
+            }
+            re->build_dfa();
+            return re;
+        }
+
+        automaton_regex()
+            : start_(0), too_large_(false), dead_state_(npos)
+        {
+        }
+
+        bool search(const jsoncons::string_view& s) const override
+        {
+            const char* p = s.data();
+            const char* last = p + s.size();
+
+            if (!transitions_.empty())
+            {
+                const std::size_t class_count = class_bounds_.size() - 1;
+                std::size_t state = 0;
+                while (p < last)
+                {
+                    if (accepting_[state])
+                    {
+                        return true;
+                    }
+                    if (state == dead_state_)
+                    {
+                        return false;
+                    }
+                    uint32_t cp = next_codepoint(p, last);
+                    state = transitions_[state*class_count + classify(cp)];
+                }
+                return accepting_[state] || accepting_at_end_[state];
+            }
+
+            // Too many DFA states, simulate the NFA
+            std::vector<std::size_t> current;
+            std::vector<std::size_t> next;
+            std::vector<std::size_t> marks(states_.size(), static_cast<std::size_t>(npos));
+            std::size_t generation = 0;
+            add_closure(start_, true, false, current, marks, generation);
+            while (p < last)
+            {
+                if (contains_match(current))
+                {
+                    return true;
+                }
+                uint32_t cp = next_codepoint(p, last);
+                step(current, cp, next, marks, ++generation);
+                current.swap(next);
+            }
+            return accepts_at_end(current, s.empty());
+        }
+    private:
+
+        // NFA construction
+
+        std::size_t new_state(state_kind kind)
+        {
+            if (states_.size() >= max_nfa_states)
+            {
+                too_large_ = true;
+            }
+            states_.emplace_back(kind);
+            return states_.size() - 1;
+        }
+
+        void build_nfa(const node& root)
+        {
+            states_.reserve(64);
+            std::vector<std::pair<std::size_t,int>> outs;
+            std::size_t start = compile_node(root, outs);
+            std::size_t match = new_state(state_kind::match);
+            patch(outs, match);
+            start_ = start;
+        }
+
+        void patch(const std::vector<std::pair<std::size_t,int>>& outs, std::size_t target)
+        {
+            for (const auto& o : outs)
+            {
+                if (o.second == 1)
+                {
+                    states_[o.first].out1 = target;
+                }
+                else
+                {
+                    states_[o.first].out2 = target;
+                }
+            }
+        }
+
+        // Compiles node, returning its start state and appending its dangling transitions to outs
+        std::size_t compile_node(const node& n, std::vector<std::pair<std::size_t,int>>& outs)
+        {
+            if (too_large_)
+            {
+                std::size_t s = new_state(state_kind::epsilon);
+                outs.emplace_back(s, 1);
+                return s;
+            }
+            switch (n.kind)
+            {
+                case node_kind::chars:
+                {
+                    std::size_t s = new_state(state_kind::chars);
+                    states_[s].ranges = normalize(n.ranges);
+                    outs.emplace_back(s, 1);
+                    return s;
+                }
+                case node_kind::line_begin:
+                {
+                    std::size_t s = new_state(state_kind::line_begin);
+                    outs.emplace_back(s, 1);
+                    return s;
+                }
+                case node_kind::line_end:
+                {
+                    std::size_t s = new_state(state_kind::line_end);
+                    outs.emplace_back(s, 1);
+                    return s;
+                }
+                case node_kind::concat:
+                {
+                    if (n.children.empty())
+                    {
+                        std::size_t s = new_state(state_kind::epsilon);
+                        outs.emplace_back(s, 1);
+                        return s;
+                    }
+                    std::vector<std::pair<std::size_t,int>> pending;
+                    std::size_t start = compile_node(n.children[0], pending);
+                    for (std::size_t i = 1; i < n.children.size(); ++i)
+                    {
+                        std::vector<std::pair<std::size_t,int>> child_outs;
+                        std::size_t child = compile_node(n.children[i], child_outs);
+                        patch(pending, child);
+                        pending = std::move(child_outs);
+                    }
+                    outs.insert(outs.end(), pending.begin(), pending.end());
+                    return start;
+                }
+                case node_kind::alternation:
+                {
+                    std::size_t start = npos;
+                    std::size_t prev_split = npos;
+                    for (std::size_t i = 0; i < n.children.size(); ++i)
+                    {
+                        std::size_t child = compile_node(n.children[i], outs);
+                        if (i + 1 < n.children.size())
+                        {
+                            std::size_t split = new_state(state_kind::split);
+                            states_[split].out1 = child;
+                            if (prev_split == npos)
+                            {
+                                start = split;
+                            }
+                            else
+                            {
+                                states_[prev_split].out2 = split;
+                            }
+                            prev_split = split;
+                        }
+                        else if (prev_split == npos)
+                        {
+                            start = child;
+                        }
+                        else
+                        {
+                            states_[prev_split].out2 = child;
+                        }
+                    }
+                    return start;
+                }
+                case node_kind::repeat:
+                {
+                    const node& child = n.children[0];
+                    std::size_t start = npos;
+                    std::vector<std::pair<std::size_t,int>> pending;
+
+                    auto append = [&](std::size_t s, std::vector<std::pair<std::size_t,int>>&& s_outs)
+                    {
+                        if (start == npos)
+                        {
+                            start = s;
+                        }
+                        else
+                        {
+                            patch(pending, s);
+                        }
+                        pending = std::move(s_outs);
+                    };
+
+                    for (std::size_t i = 0; i < n.min && !too_large_; ++i)
+                    {
+                        std::vector<std::pair<std::size_t,int>> child_outs;
+                        std::size_t s = compile_node(child, child_outs);
+                        append(s, std::move(child_outs));
+                    }
+                    if (n.max == max_repeat)
+                    {
+                        std::size_t split = new_state(state_kind::split);
+                        std::vector<std::pair<std::size_t,int>> child_outs;
+                        std::size_t s = compile_node(child, child_outs);
+                        states_[split].out1 = s;
+                        patch(child_outs, split);
+                        std::vector<std::pair<std::size_t,int>> split_outs;
+                        split_outs.emplace_back(split, 2);
+                        append(split, std::move(split_outs));
+                    }
+                    else
+                    {
+                        // Each optional copy may be skipped to the end
+                        std::vector<std::pair<std::size_t,int>> skips;
+                        for (std::size_t i = n.min; i < n.max && !too_large_; ++i)
+                        {
+                            std::size_t split = new_state(state_kind::split);
+                            std::vector<std::pair<std::size_t,int>> child_outs;
+                            std::size_t s = compile_node(child, child_outs);
+                            states_[split].out1 = s;
+                            skips.emplace_back(split, 2);
+                            append(split, std::move(child_outs));
+                        }
+                        pending.insert(pending.end(), skips.begin(), skips.end());
+                    }
+                    if (start == npos)
+                    {
+                        // x{0}
+                        std::size_t s = new_state(state_kind::epsilon);
+                        outs.emplace_back(s, 1);
+                        return s;
+                    }
+                    outs.insert(outs.end(), pending.begin(), pending.end());
+                    return start;
+                }
+                default:
+                {
+                    std::size_t s = new_state(state_kind::epsilon);
+                    outs.emplace_back(s, 1);
+                    return s;
+                }
+            }
+        }
+
+        // Simulation
+
+        // Adds the states reachable from s without consuming input. Only states
+        // that consume input, line_end assertions and the match state are kept.
+        void add_closure(std::size_t s, bool at_begin, bool at_end,
+                         std::vector<std::size_t>& set,
+                         std::vector<std::size_t>& marks, std::size_t generation) const
+        {
+            std::vector<std::size_t> stack;
+            stack.push_back(s);
+            while (!stack.empty())
+            {
+                std::size_t i = stack.back();
+                stack.pop_back();
+                if (i == npos || marks[i] == generation)
+                {
+                    continue;
+                }
+                marks[i] = generation;
+                const nfa_state& state = states_[i];
+                switch (state.kind)
+                {
+                    case state_kind::epsilon:
+                        stack.push_back(state.out1);
+                        break;
+                    case state_kind::split:
+                        stack.push_back(state.out2);
+                        stack.push_back(state.out1);
+                        break;
+                    case state_kind::line_begin:
+                        if (at_begin)
+                        {
+                            stack.push_back(state.out1);
+                        }
+                        break;
+                    case state_kind::line_end:
+                        if (at_end)
+                        {
+                            stack.push_back(state.out1);
+                        }
+                        else
+                        {
+                            set.push_back(i);
+                        }
+                        break;
+                    default:
+                        set.push_back(i);
+                        break;
+                }
+            }
+        }
+
+        static bool contains(const range_set& ranges, uint32_t cp)
+        {
+            auto it = std::upper_bound(ranges.begin(), ranges.end(), range_type(cp, static_cast<uint32_t>(max_codepoint)));
+            return it != ranges.begin() && (it-1)->first <= cp && cp <= (it-1)->second;
+        }
+
+        // Consumes cp, then allows a new match to start at the next position
+        void step(const std::vector<std::size_t>& current, uint32_t cp,
+                  std::vector<std::size_t>& next,
+                  std::vector<std::size_t>& marks, std::size_t generation) const
+        {
+            next.clear();
+            for (std::size_t i : current)
+            {
+                const nfa_state& state = states_[i];
+                if (state.kind == state_kind::chars && contains(state.ranges, cp))
+                {
+                    add_closure(state.out1, false, false, next, marks, generation);
+                }
+            }
+            add_closure(start_, false, false, next, marks, generation);
+        }
+
+        bool contains_match(const std::vector<std::size_t>& set) const
+        {
+            for (std::size_t i : set)
+            {
+                if (states_[i].kind == state_kind::match)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool accepts_at_end(const std::vector<std::size_t>& set, bool at_begin) const
+        {
+            std::vector<std::size_t> marks(states_.size(), static_cast<std::size_t>(npos));
+            std::vector<std::size_t> closure;
+            for (std::size_t i : set)
+            {
+                if (states_[i].kind == state_kind::line_end)
+                {
+                    add_closure(states_[i].out1, at_begin, true, closure, marks, 0);
+                }
+                else if (states_[i].kind == state_kind::match)
+                {
+                    return true;
+                }
+            }
+            return contains_match(closure);
+        }
+
+        // DFA construction
+
+        std::size_t classify(uint32_t cp) const
+        {
+            if (cp < 128)
+            {
+                return ascii_classes_[cp];
+            }
+            auto it = std::upper_bound(class_bounds_.begin(), class_bounds_.end(), cp);
+            return static_cast<std::size_t>(it - class_bounds_.begin()) - 1;
+        }
+
+        void build_dfa()
+        {
+            // Partition the code points into classes that no range splits
+            std::vector<uint32_t> bounds;
+            bounds.push_back(0);
+            bounds.push_back(max_codepoint + 1);
+            for (const auto& state : states_)
+            {
+                for (const auto& r : state.ranges)
+                {
+                    bounds.push_back(r.first);
+                    bounds.push_back(r.second + 1);
+                }
+            }
+            std::sort(bounds.begin(), bounds.end());
+            bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+            class_bounds_ = std::move(bounds);
+            const std::size_t class_count = class_bounds_.size() - 1;
+            for (uint32_t c = 0; c < 128; ++c)
+            {
+                auto it = std::upper_bound(class_bounds_.begin(), class_bounds_.end(), c);
+                ascii_classes_[c] = static_cast<uint16_t>((it - class_bounds_.begin()) - 1);
+            }
+
+            std::vector<std::vector<std::size_t>> dfa_states;
+            std::map<std::vector<std::size_t>,std::size_t> index;
+            std::vector<std::size_t> marks(states_.size(), static_cast<std::size_t>(npos));
+            std::size_t generation = 0;
+
+            std::vector<std::size_t> initial;
+            add_closure(start_, true, false, initial, marks, generation);
+            std::sort(initial.begin(), initial.end());
+            // The initial state is not indexed, it is the only state where ^ can match
+            dfa_states.push_back(std::move(initial));
+
+            std::vector<std::size_t> transitions;
+            std::vector<std::size_t> next;
+            for (std::size_t d = 0; d < dfa_states.size(); ++d)
+            {
+                if (dfa_states.size() > max_dfa_states || class_count > 0xFFFF)
+                {
+                    // Fall back to simulating the NFA
+                    return;
+                }
+                for (std::size_t c = 0; c < class_count; ++c)
+                {
+                    step(dfa_states[d], class_bounds_[c], next, marks, ++generation);
+                    std::sort(next.begin(), next.end());
+                    auto it = index.find(next);
+                    if (it == index.end())
+                    {
+                        it = index.emplace(next, dfa_states.size()).first;
+                        dfa_states.push_back(next);
+                    }
+                    transitions.push_back(it->second);
+                }
+            }
+
+            accepting_.resize(dfa_states.size());
+            accepting_at_end_.resize(dfa_states.size());
+            for (std::size_t d = 0; d < dfa_states.size(); ++d)
+            {
+                accepting_[d] = contains_match(dfa_states[d]);
+                accepting_at_end_[d] = accepts_at_end(dfa_states[d], d == 0);
+                // A state that loops to itself on every input without ever accepting cannot match
+                if (dead_state_ == npos && !accepting_[d] && !accepting_at_end_[d])
+                {
+                    bool loops = true;
+                    for (std::size_t c = 0; c < class_count && loops; ++c)
+                    {
+                        loops = transitions[d*class_count + c] == d;
+                    }
+                    if (loops)
+                    {
+                        dead_state_ = d;
+                    }
+                }
+            }
+            transitions_ = std::move(transitions);
+        }
+    };
+
+#if defined(JSONCONS_HAS_STD_REGEX)
+
+    class std_regex : public regex_matcher
+    {
+        std::regex regex_;
+    public:
+        std_regex(const std::string& pattern)
+        {
+            try
+            {
+                regex_ = std::regex(pattern, std::regex::ECMAScript);
+            }
+            catch (const std::regex_error& e)
+            {
+                JSONCONS_THROW(schema_error("Invalid regular expression \"" + pattern + "\": " + e.what()));
+            }
+        }
+
+        bool search(const jsoncons::string_view& s) const override
+        {
+            return std::regex_search(s.begin(), s.end(), regex_);
+        }
+    };
+
+#endif
+
+} // namespace detail
+
+    // The built-in engine. Patterns that a finite automaton can recognize are
+    // matched in linear time, others (back references, lookaround, word
+    // boundaries) fall back to std::regex where it is available. Without
+    // std::regex such patterns are rejected, rather than ignored.
+    inline
+    regex_engine default_regex_engine()
+    {
+        return [](const std::string& pattern) -> regex_matcher_pointer
+        {
+            regex_matcher_pointer matcher = detail::automaton_regex::compile(pattern);
+            if (!matcher)
+            {
+    #if defined(JSONCONS_HAS_STD_REGEX)
+                matcher = std::make_shared<detail::std_regex>(pattern);
+    #else
+                JSONCONS_THROW(schema_error("Unsupported regular expression '" + pattern + "'"));
+    #endif
+            }
+            return matcher;
+        };
+    }
+
+} // namespace jsonschema
+} // namespace jsoncons
+
+#endif // JSONCONS_JSONSCHEMA_REGEX_ENGINE_HPP
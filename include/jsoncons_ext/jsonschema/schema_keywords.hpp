@@ -13,18 +13,41 @@
 #include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
 #include <jsoncons_ext/jsonschema/subschema.hpp>
 #include <jsoncons_ext/jsonschema/format_checkers.hpp>
+#include <jsoncons_ext/jsonschema/regex_engine.hpp>
 #include <cassert>
 #include <set>
 #include <sstream>
 #include <iostream>
 #include <cassert>
-#if defined(JSONCONS_HAS_STD_REGEX)
-#include <regex>
-#endif
+#include <algorithm> // std::stable_sort
+#include <iterator> // std::make_move_iterator
+#include <vector>
+#include <thread> // std::thread
+#include <exception> // std::exception_ptr
+#include <unordered_set> // std::unordered_set
 
 namespace jsoncons {
 namespace jsonschema {
 
+namespace detail {
+
+    // Joins the threads that have been started, also when starting another one
+    // throws, so that none is destroyed while joinable or outlives the locals it uses
+    struct thread_join_guard
+    {
+        std::vector<std::thread>& threads;
+
+        ~thread_join_guard()
+        {
+            for (auto& t : threads)
+            {
+                t.join();
+            }
+        }
+    };
+
+} // namespace detail
+
     template <class Json>
     class schema_builder
     {
@@ -78,12 +101,21 @@ namespace jsonschema {
 
         virtual schema_pointer make_type_keyword(const Json& schema,
                                                 const std::vector<uri_wrapper>& uris) = 0;
+
+        // Returns the compiled form of a "pattern" or "patternProperties" regular expression,
+        // or null if it cannot be checked
+        virtual regex_matcher_pointer make_regex(const std::string& pattern) = 0;
     };
 
     struct collecting_error_reporter : public error_reporter
     {
         std::vector<validation_output> errors;
 
+        collecting_error_reporter(bool fail_early = false)
+            : error_reporter(fail_early)
+        {
+        }
+
     private:
         void do_error(const validation_output& o) override
         {
@@ -92,7 +124,7 @@ namespace jsonschema {
     };
 
     template <class Json>
-    void update_patch(Json& patch, const uri_wrapper& instance_location, Json&& default_value)
+    void update_patch(Json& patch, const instance_path& instance_location, Json&& default_value)
     {
         Json j;
         j.try_emplace("op", "add"); 
@@ -102,11 +134,55 @@ namespace jsonschema {
         patch.push_back(std::move(j));
     }
 
+    // Rough estimate, made at load time, of how much work validating against a
+    // schema takes. When validation stops at the first error, sibling subschemas 
+    // are evaluated cheapest first, so that a failing type or const check is found
+    // before a pattern or a deep subschema. Otherwise they are evaluated in the
+    // order they are declared, which fixes the order of the errors and of the 
+    // defaults that are patched.
+    template <class Json>
+    std::size_t estimate_cost(const Json& sch)
+    {
+        std::size_t cost = 1;
+        if (sch.is_array())
+        {
+            for (const auto& item : sch.array_range())
+            {
+                cost += estimate_cost(item);
+            }
+        }
+        else if (sch.is_object())
+        {
+            for (const auto& member : sch.object_range())
+            {
+                const auto& key = member.key();
+                if (key == "enum" || key == "const" || key == "default" || key == "examples" || key == "definitions")
+                {
+                    continue; // instance data, or not evaluated
+                }
+                if (key == "$ref")
+                {
+                    cost += 64; // the target isn't known yet
+                }
+                else if (key == "pattern" || key == "patternProperties" || key == "format")
+                {
+                    cost += 16;
+                }
+                else if (key == "uniqueItems" || key == "contentEncoding")
+                {
+                    cost += 8;
+                }
+                cost += estimate_cost(member.value());
+            }
+        }
+        return cost;
+    }
+
     // string schema_keyword
 
     template <class Json>
-    void content_media_type_check(const uri_wrapper& instance_location, const Json&, 
-                                  const std::string& content_media_type, const std::string& content,
+    void content_media_type_check(const instance_path& instance_location, const Json&, 
+                                  const std::string& content_media_type, const jsoncons::string_view& content,
                                   error_reporter& reporter)
     {
         if (content_media_type == "application/Json")
@@ -146,11 +222,9 @@ namespace jsonschema {
         jsoncons::optional<std::size_t> min_length_;
         std::string absolute_min_length_location_;
 
-    #if defined(JSONCONS_HAS_STD_REGEX)
-        jsoncons::optional<std::regex> pattern_;
+        regex_matcher_pointer pattern_;
         std::string pattern_string_;
         std::string absolute_pattern_location_;
-    #endif
 
         format_checker format_check_;
         std::string absolute_format_location_;
@@ -161,11 +235,9 @@ namespace jsonschema {
         std::string absolute_content_media_type_location_;
 
     public:
-        string_keyword(const Json& sch, const std::vector<uri_wrapper>& uris)
+        string_keyword(schema_builder<Json>* builder, const Json& sch, const std::vector<uri_wrapper>& uris)
             : schema_keyword<Json>((!uris.empty() && uris.back().is_absolute()) ? uris.back().string() : ""), max_length_(), min_length_(), 
-    #if defined(JSONCONS_HAS_STD_REGEX)
               pattern_(),
-    #endif
               content_encoding_(), content_media_type_()
         {
             auto it = sch.find("maxLength");
@@ -198,15 +270,13 @@ namespace jsonschema {
                 absolute_content_media_type_location_ = make_absolute_keyword_location(uris, "contentMediaType");
             }
 
-    #if defined(JSONCONS_HAS_STD_REGEX)
             it = sch.find("pattern");
             if (it != sch.object_range().end()) 
             {
                 pattern_string_ = it->value().template as<std::string>();
-                pattern_ = std::regex(it->value().template as<std::string>(),std::regex::ECMAScript);
+                pattern_ = builder->make_regex(pattern_string_);
                 absolute_pattern_location_ = make_absolute_keyword_location(uris, "pattern");
             }
-    #endif
 
             it = sch.find("format");
             if (it != sch.object_range().end()) 
@@ -254,18 +324,21 @@ namespace jsonschema {
 
     private:
 
-        void do_validate(const uri_wrapper& instance_location, 
+        void do_validate(const instance_path& instance_location, 
                          const Json& instance, 
                          error_reporter& reporter,
                          Json&) const override
         {
-            std::string content;
+            // Strings are checked in place, only decoded or converted content is copied
+            std::string buffer;
+            jsoncons::string_view content;
             if (content_encoding_)
             {
                 if (*content_encoding_ == "base64")
                 {
                     auto s = instance.template as<jsoncons::string_view>();
-                    auto retval = jsoncons::decode_base64(s.begin(), s.end(), content);
+                    auto retval = jsoncons::decode_base64(s.begin(), s.end(), buffer);
+                    content = buffer;
                     if (retval.ec != jsoncons::conv_errc::success)
                     {
                         reporter.error(validation_output(instance_location.string(), "Content is not a base64 string", "contentEncoding", absolute_content_encoding_location_));
@@ -284,9 +357,14 @@ namespace jsonschema {
                     }
                 }
             }
+            else if (instance.type() == json_type::string_value)
+            {
+                content = instance.as_string_view();
+            }
             else
             {
-                content = instance.template as<std::string>();
+                buffer = instance.template as<std::string>();
+                content = buffer;
             }
 
             if (content_media_type_) 
@@ -335,10 +413,9 @@ namespace jsonschema {
                 }
             }
 
-    #if defined(JSONCONS_HAS_STD_REGEX)
             if (pattern_)
             {
-                if (!std::regex_search(content, *pattern_))
+                if (!pattern_->search(content))
                 {
                     std::string message("String \"");
                     message.append(instance.template as<std::string>());
@@ -353,11 +430,9 @@ namespace jsonschema {
                 }
             }
 
-    #endif
-
             if (format_check_ != nullptr) 
             {
-                format_check_(absolute_format_location_, instance_location, content, reporter);
+                format_check_(absolute_format_location_, instance_location, std::string(content), reporter);
                 if (reporter.error_count() > 0 && reporter.fail_early())
                 {
                     return;
@@ -386,12 +461,13 @@ namespace jsonschema {
 
     private:
 
-        void do_validate(const uri_wrapper& instance_location, 
+        void do_validate(const instance_path& instance_location, 
                          const Json& instance, 
                          error_reporter& reporter, 
                          Json& patch) const final
         {
-            collecting_error_reporter local_reporter;
+            // Only whether there is an error matters
+            collecting_error_reporter local_reporter(true);
             rule_->validate(instance_location, instance, local_reporter, patch);
 
             if (local_reporter.errors.empty())
@@ -400,7 +476,7 @@ namespace jsonschema {
             }
         }
 
-        jsoncons::optional<Json> get_default_value(const uri_wrapper& instance_location, 
+        jsoncons::optional<Json> get_default_value(const instance_path& instance_location, 
                                                    const Json& instance, 
                                                    error_reporter& reporter) const override
         {
@@ -418,7 +494,7 @@ namespace jsonschema {
         }
 
         static bool is_complete(const Json&, 
-                                const uri_wrapper& instance_location, 
+                                const instance_path& instance_location, 
                                 error_reporter& reporter, 
                                 const collecting_error_reporter& local_reporter, 
                                 std::size_t)
@@ -439,7 +515,7 @@ namespace jsonschema {
         }
 
         static bool is_complete(const Json&, 
-                                const uri_wrapper&, 
+                                const instance_path&, 
                                 error_reporter&, 
                                 const collecting_error_reporter&, 
                                 std::size_t count)
@@ -458,7 +534,7 @@ namespace jsonschema {
         }
 
         static bool is_complete(const Json&, 
-                                const uri_wrapper& instance_location, 
+                                const instance_path& instance_location, 
                                 error_reporter& reporter, 
                                 const collecting_error_reporter&, 
                                 std::size_t count)
@@ -479,6 +555,7 @@ namespace jsonschema {
         using schema_pointer = typename schema_keyword<Json>::schema_pointer;
 
         std::vector<schema_pointer> subschemas_;
+        std::vector<schema_pointer> subschemas_by_cost_;
 
     public:
         combining_keyword(schema_builder<Json>* builder,
@@ -486,10 +563,25 @@ namespace jsonschema {
                        const std::vector<uri_wrapper>& uris)
             : schema_keyword<Json>((!uris.empty() && uris.back().is_absolute()) ? uris.back().string() : "")
         {
+            std::vector<std::pair<std::size_t,schema_pointer>> ordered;
             size_t c = 0;
             for (const auto& subsch : sch.array_range())
             {
-                subschemas_.push_back(builder->build(subsch, uris, {Criterion::key(), std::to_string(c++)}));
+                ordered.emplace_back(estimate_cost(subsch), builder->build(subsch, uris, {Criterion::key(), std::to_string(c++)}));
+                subschemas_.push_back(ordered.back().second);
+            }
+
+            // Whether the instance is valid doesn't depend on the order, so when stopping 
+            // at the first error allOf can fail and anyOf succeed on the cheapest subschema 
+            // that decides it
+            std::stable_sort(ordered.begin(), ordered.end(),
+                             [](const std::pair<std::size_t,schema_pointer>& a, const std::pair<std::size_t,schema_pointer>& b)
+                             {
+                                 return a.first < b.first;
+                             });
+            for (auto& item : ordered)
+            {
+                subschemas_by_cost_.push_back(item.second);
             }
 
             // Validate value of allOf, anyOf, and oneOf "MUST be a non-empty array"
@@ -497,7 +589,7 @@ namespace jsonschema {
 
     private:
 
-        void do_validate(const uri_wrapper& instance_location, 
+        void do_validate(const instance_path& instance_location, 
                          const Json& instance, 
                          error_reporter& reporter, 
                          Json& patch) const final
@@ -505,12 +597,17 @@ namespace jsonschema {
             size_t count = 0;
 
             collecting_error_reporter local_reporter;
-            for (auto& s : subschemas_) 
+            for (auto& s : reporter.fail_early() ? subschemas_by_cost_ : subschemas_) 
             {
-                std::size_t mark = local_reporter.errors.size();
-                s->validate(instance_location, instance, local_reporter, patch);
-                if (mark == local_reporter.errors.size())
+                // When stopping at the first error, each subschema stops at its own first error
+                collecting_error_reporter subschema_reporter(reporter.fail_early());
+                s->validate(instance_location, instance, subschema_reporter, patch);
+                if (subschema_reporter.errors.empty())
                     count++;
+                else
+                    local_reporter.errors.insert(local_reporter.errors.end(), 
+                                                 std::make_move_iterator(subschema_reporter.errors.begin()), 
+                                                 std::make_move_iterator(subschema_reporter.errors.end()));
 
                 if (Criterion::is_complete(instance, instance_location, reporter, local_reporter, count))
                     return;
@@ -589,7 +686,7 @@ namespace jsonschema {
 
     private:
 
-        void do_validate(const uri_wrapper& instance_location, 
+        void do_validate(const instance_path& instance_location, 
                          const Json& instance, 
                          error_reporter& reporter, 
                          Json&) const override
@@ -686,7 +783,7 @@ namespace jsonschema {
         {
         }
     private:
-        void do_validate(const uri_wrapper& instance_location, const Json& instance, error_reporter& reporter, Json&) const override
+        void do_validate(const instance_path& instance_location, const Json& instance, error_reporter& reporter, Json&) const override
         {
             if (!instance.is_null())
             {
@@ -706,7 +803,7 @@ namespace jsonschema {
         {
         }
     private:
-        void do_validate(const uri_wrapper&, const Json&, error_reporter&, Json&) const override
+        void do_validate(const instance_path&, const Json&, error_reporter&, Json&) const override
         {
         }
 
@@ -723,9 +820,14 @@ namespace jsonschema {
         {
         }
     private:
-        void do_validate(const uri_wrapper&, const Json&, error_reporter&, Json&) const override
+        void do_validate(const instance_path&, const Json&, error_reporter&, Json&) const override
         {
         }
+
+        void do_validate_stream(const instance_path&, typename schema_keyword<Json>::cursor_type& cursor, error_reporter&, Json&) const override
+        {
+            skip_instance(cursor);
+        }
     };
 
     template <class Json>
@@ -739,10 +841,19 @@ namespace jsonschema {
         {
         }
     private:
-        void do_validate(const uri_wrapper& instance_location, const Json&, error_reporter& reporter, Json&) const override
+        void do_validate(const instance_path& instance_location, const Json&, error_reporter& reporter, Json&) const override
         {
             reporter.error(validation_output(instance_location.string(), "False schema always fails", "false", this->absolute_keyword_location()));
         }
+
+        void do_validate_stream(const instance_path& instance_location, typename schema_keyword<Json>::cursor_type& cursor, error_reporter& reporter, Json&) const override
+        {
+            reporter.error(validation_output(instance_location.string(), "False schema always fails", "false", this->absolute_keyword_location()));
+            if (!reporter.fail_early())
+            {
+                skip_instance(cursor);
+            }
+        }
     };
 
     template <class Json>
@@ -763,9 +874,14 @@ namespace jsonschema {
         required_keyword(required_keyword&&) = default;
         required_keyword& operator=(const required_keyword&) = delete;
         required_keyword& operator=(required_keyword&&) = default;
+
+        bool is_required(const std::string& key) const
+        {
+            return std::find(items_.begin(), items_.end(), key) != items_.end();
+        }
     private:
 
-        void do_validate(const uri_wrapper& instance_location, const Json& instance, error_reporter& reporter, Json&) const override final
+        void do_validate(const instance_path& instance_location, const Json& instance, error_reporter& reporter, Json&) const override final
         {
             for (const auto& key : items_)
             {
@@ -793,9 +909,7 @@ namespace jsonschema {
         jsoncons::optional<required_keyword<Json>> required_;
 
         std::map<std::string, schema_pointer> properties_;
-    #if defined(JSONCONS_HAS_STD_REGEX)
-        std::vector<std::pair<std::regex, schema_pointer>> pattern_properties_;
-    #endif
+        std::vector<std::pair<regex_matcher_pointer, schema_pointer>> pattern_properties_;
         schema_pointer additional_properties_;
 
         std::map<std::string, schema_pointer> dependencies_;
@@ -843,17 +957,15 @@ namespace jsonschema {
                             builder->build(prop.value(), uris, {"properties", prop.key()})));
             }
 
-    #if defined(JSONCONS_HAS_STD_REGEX)
             it = sch.find("patternProperties");
             if (it != sch.object_range().end()) 
             {
                 for (const auto& prop : it->value().object_range())
                     pattern_properties_.emplace_back(
                         std::make_pair(
-                            std::regex(prop.key(), std::regex::ECMAScript),
+                            builder->make_regex(prop.key()),
                             builder->build(prop.value(), uris, {prop.key()})));
             }
-    #endif
 
             it = sch.find("additionalProperties");
             if (it != sch.object_range().end()) 
@@ -894,7 +1006,7 @@ namespace jsonschema {
         }
     private:
 
-        void do_validate(const uri_wrapper& instance_location, 
+        void do_validate(const instance_path& instance_location, 
                          const Json& instance, 
                          error_reporter& reporter, 
                          Json& patch) const override
@@ -922,7 +1034,13 @@ namespace jsonschema {
             }
 
             if (required_)
+            {
                 required_->validate(instance_location, instance, reporter, patch);
+                if (reporter.error_count() > 0 && reporter.fail_early())
+                {
+                    return;
+                }
+            }
 
             for (const auto& property : instance.object_range()) 
             {
@@ -938,22 +1056,30 @@ namespace jsonschema {
                     a_prop_or_pattern_matched = true;
                     properties_it->second->validate(instance_location.append(property.key()), property.value(), reporter, patch);
                 }
-
-    #if defined(JSONCONS_HAS_STD_REGEX)
+                if (reporter.error_count() > 0 && reporter.fail_early())
+                {
+                    return;
+                }
 
                 // check all matching "patternProperties"
                 for (auto& schema_pp : pattern_properties_)
-                    if (std::regex_search(property.key(), schema_pp.first)) 
+                {
+                    if (schema_pp.first && schema_pp.first->search(property.key())) 
                     {
                         a_prop_or_pattern_matched = true;
                         schema_pp.second->validate(instance_location.append(property.key()), property.value(), reporter, patch);
                     }
-    #endif
+                }
+
+                if (reporter.error_count() > 0 && reporter.fail_early())
+                {
+                    return;
+                }
 
                 // finally, check "additionalProperties" 
                 if (!a_prop_or_pattern_matched && additional_properties_) 
                 {
-                    collecting_error_reporter local_reporter;
+                    collecting_error_reporter local_reporter(true);
                     additional_properties_->validate(instance_location.append(property.key()), property.value(), local_reporter, patch);
                     if (!local_reporter.errors.empty())
                     {
@@ -986,7 +1112,140 @@ namespace jsonschema {
             {
                 auto prop = instance.find(dep.first);
                 if (prop != instance.object_range().end()) // if dependency-property is present in instance
+                {
                     dep.second->validate(instance_location.append(dep.first), instance, reporter, patch); // validate
+                    if (reporter.error_count() > 0 && reporter.fail_early())
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+
+        void do_validate_stream(const instance_path& instance_location, 
+                                typename schema_keyword<Json>::cursor_type& cursor, 
+                                error_reporter& reporter, 
+                                Json& patch) const override
+        {
+            // "dependencies" apply subschemas to the object as a whole
+            if (!dependencies_.empty())
+            {
+                Json instance = read_instance<Json>(cursor);
+                do_validate(instance_location, instance, reporter, patch);
+                return;
+            }
+
+            std::size_t count = 0;
+            // The members named in "properties" or "required" that are present
+            Json present(json_object_arg);
+            std::vector<schema_pointer> matched;
+
+            cursor.next();
+            while (!cursor.done() && cursor.current().event_type() != staj_event_type::end_object)
+            {
+                auto key = cursor.current().template get<std::string>();
+                ++count;
+
+                if (property_names_)
+                {
+                    property_names_->validate(instance_location, Json(key), reporter, patch);
+                    if (reporter.error_count() > 0 && reporter.fail_early())
+                    {
+                        return;
+                    }
+                }
+
+                auto properties_it = properties_.find(key);
+                if (properties_it != properties_.end() || (required_ && required_->is_required(key)))
+                {
+                    present.try_emplace(key, null_type());
+                }
+
+                matched.clear();
+                if (properties_it != properties_.end()) 
+                {
+                    matched.push_back(properties_it->second);
+                }
+                for (auto& schema_pp : pattern_properties_)
+                {
+                    if (schema_pp.first && schema_pp.first->search(key)) 
+                    {
+                        matched.push_back(schema_pp.second);
+                    }
+                }
+
+                cursor.next();
+                if (matched.size() == 1)
+                {
+                    matched[0]->validate(instance_location.append(key), cursor, reporter, patch);
+                }
+                else if (!matched.empty())
+                {
+                    // Several subschemas apply, read the value once
+                    Json value = read_instance<Json>(cursor);
+                    for (auto sch : matched)
+                    {
+                        sch->validate(instance_location.append(key), value, reporter, patch);
+                    }
+                }
+                else if (additional_properties_) 
+                {
+                    // The value must be read through even if the outer reporter does not stop early
+                    collecting_error_reporter local_reporter(reporter.fail_early());
+                    additional_properties_->validate(instance_location.append(key), cursor, local_reporter, patch);
+                    if (!local_reporter.errors.empty())
+                    {
+                        reporter.error(validation_output(instance_location.string(), "Additional property \"" + key + "\" found but was invalid.", "additionalProperties", additional_properties_->absolute_keyword_location()));
+                    }
+                }
+                else
+                {
+                    skip_instance(cursor);
+                }
+                if (reporter.error_count() > 0 && reporter.fail_early())
+                {
+                    return;
+                }
+                cursor.next();
+            }
+
+            if (max_properties_ && count > *max_properties_)
+            {
+                std::string message("Maximum properties: " + std::to_string(*max_properties_));
+                message.append(", found: " + std::to_string(count));
+                reporter.error(validation_output(instance_location.string(), std::move(message), "maxProperties", absolute_max_properties_location_));
+                if (reporter.fail_early())
+                {
+                    return;
+                }
+            }
+
+            if (min_properties_ && count < *min_properties_)
+            {
+                std::string message("Minimum properties: " + std::to_string(*min_properties_));
+                message.append(", found: " + std::to_string(count));
+                reporter.error(validation_output(instance_location.string(), std::move(message), "minProperties", absolute_min_properties_location_));
+                if (reporter.fail_early())
+                {
+                    return;
+                }
+            }
+
+            if (required_)
+            {
+                required_->validate(instance_location, present, reporter, patch);
+            }
+
+            for (auto const& prop : properties_) 
+            {
+                if (present.find(prop.first) == present.object_range().end()) 
+                { 
+                    auto default_value = prop.second->get_default_value(instance_location, present, reporter);
+                    if (default_value) 
+                    { 
+                        update_patch(patch, instance_location.append(prop.first), std::move(*default_value));
+                    }
+                }
             }
         }
     };
@@ -998,6 +1257,21 @@ namespace jsonschema {
     {
         using schema_pointer = typename schema_keyword<Json>::schema_pointer;
 
+        // Fewer items than this per thread are validated on the calling thread
+        static constexpr std::size_t min_items_per_thread = 256;
+
+        struct chunk_result
+        {
+            collecting_error_reporter reporter;
+            Json patch;
+            std::exception_ptr exception;
+
+            chunk_result(bool fail_early)
+                : reporter(fail_early), patch(json_array_arg)
+            {
+            }
+        };
+
         jsoncons::optional<std::size_t> max_items_;
         std::string absolute_max_items_location_;
         jsoncons::optional<std::size_t> min_items_;
@@ -1078,7 +1352,7 @@ namespace jsonschema {
         }
     private:
 
-        void do_validate(const uri_wrapper& instance_location, 
+        void do_validate(const instance_path& instance_location, 
                          const Json& instance, 
                          error_reporter& reporter, 
                          Json& patch) const override
@@ -1124,11 +1398,23 @@ namespace jsonschema {
             }
 
             size_t index = 0;
-            if (items_schema_)
+            if (items_schema_ && reporter.max_threads() > 1 && instance.size() >= 2*min_items_per_thread)
+            {
+                validate_items_parallel(instance_location, instance, reporter, patch);
+                if (reporter.error_count() > 0 && reporter.fail_early())
+                {
+                    return;
+                }
+            }
+            else if (items_schema_)
             {
                 for (const auto& i : instance.array_range()) 
                 {
                     items_schema_->validate(instance_location.append(index), i, reporter, patch);
+                    if (reporter.error_count() > 0 && reporter.fail_early())
+                    {
+                        return;
+                    }
                     index++;
                 }
             }
@@ -1150,6 +1436,10 @@ namespace jsonschema {
                         break;
 
                     item_validator->validate(instance_location.append(index), i, reporter, patch);
+                    if (reporter.error_count() > 0 && reporter.fail_early())
+                    {
+                        return;
+                    }
                 }
             }
 
@@ -1159,13 +1449,16 @@ namespace jsonschema {
                 collecting_error_reporter local_reporter;
                 for (const auto& item : instance.array_range()) 
                 {
-                    std::size_t mark = local_reporter.errors.size();
-                    contains_->validate(instance_location, item, local_reporter, patch);
-                    if (mark == local_reporter.errors.size()) 
+                    collecting_error_reporter item_reporter(reporter.fail_early());
+                    contains_->validate(instance_location, item, item_reporter, patch);
+                    if (item_reporter.errors.empty()) 
                     {
                         contained = true;
                         break;
                     }
+                    local_reporter.errors.insert(local_reporter.errors.end(), 
+                                                 std::make_move_iterator(item_reporter.errors.begin()), 
+                                                 std::make_move_iterator(item_reporter.errors.end()));
                 }
                 if (!contained)
                 {
@@ -1178,17 +1471,219 @@ namespace jsonschema {
             }
         }
 
+        // Splits the items into contiguous chunks, one per thread, and reports the 
+        // errors and defaults of each chunk in order, as validating them in turn would. 
+        // The items themselves are validated on a single thread each.
+        void validate_items_parallel(const instance_path& instance_location, 
+                                     const Json& instance, 
+                                     error_reporter& reporter, 
+                                     Json& patch) const
+        {
+            std::size_t size = instance.size();
+            std::size_t chunk_count = (std::min)(reporter.max_threads(), size / min_items_per_thread);
+            std::size_t chunk_size = (size + chunk_count - 1) / chunk_count;
+
+            std::vector<chunk_result> results;
+            results.reserve(chunk_count);
+            for (std::size_t i = 0; i < chunk_count; ++i)
+            {
+                results.emplace_back(reporter.fail_early());
+            }
+
+            auto validate_chunk = [this,&instance_location,&instance,&results,chunk_size,size](std::size_t i)
+            {
+                chunk_result& result = results[i];
+                JSONCONS_TRY
+                {
+                    std::size_t last = (std::min)((i+1)*chunk_size, size);
+                    for (std::size_t index = i*chunk_size; index < last; ++index)
+                    {
+                        items_schema_->validate(instance_location.append(index), instance.at(index), result.reporter, result.patch);
+                        if (result.reporter.error_count() > 0 && result.reporter.fail_early())
+                        {
+                            break;
+                        }
+                    }
+                }
+                JSONCONS_CATCH(...)
+                {
+                    result.exception = std::current_exception();
+                }
+            };
+
+            {
+                std::vector<std::thread> threads;
+                detail::thread_join_guard guard{threads};
+                threads.reserve(chunk_count-1);
+                for (std::size_t i = 1; i < chunk_count; ++i)
+                {
+                    threads.emplace_back(validate_chunk, i);
+                }
+                validate_chunk(0);
+            }
+
+            for (auto& result : results)
+            {
+                if (result.exception)
+                {
+                    std::rethrow_exception(result.exception);
+                }
+                for (auto& item : result.patch.array_range())
+                {
+                    patch.push_back(std::move(item));
+                }
+                for (const auto& error : result.reporter.errors)
+                {
+                    reporter.error(error);
+                    if (reporter.fail_early())
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+
+        void do_validate_stream(const instance_path& instance_location, 
+                                typename schema_keyword<Json>::cursor_type& cursor, 
+                                error_reporter& reporter, 
+                                Json& patch) const override
+        {
+            // "uniqueItems" needs all the items
+            if (unique_items_)
+            {
+                Json instance = read_instance<Json>(cursor);
+                do_validate(instance_location, instance, reporter, patch);
+                return;
+            }
+
+            std::size_t index = 0;
+            bool contained = false;
+            collecting_error_reporter contains_reporter;
+            auto item = items_.cbegin();
+
+            cursor.next();
+            while (!cursor.done() && cursor.current().event_type() != staj_event_type::end_array)
+            {
+                schema_pointer item_validator = items_schema_;
+                if (!item_validator)
+                {
+                    if (item == items_.cend())
+                    {
+                        item_validator = additional_items_;
+                    }
+                    else 
+                    {
+                        item_validator = *item;
+                        ++item;
+                    }
+                }
+
+                if (contains_ && !contained)
+                {
+                    // Until an item matches "contains", each item is read once and checked against both
+                    Json value = read_instance<Json>(cursor);
+                    if (item_validator)
+                    {
+                        item_validator->validate(instance_location.append(index), value, reporter, patch);
+                    }
+                    collecting_error_reporter item_reporter(reporter.fail_early());
+                    contains_->validate(instance_location, value, item_reporter, patch);
+                    if (item_reporter.errors.empty()) 
+                    {
+                        contained = true;
+                    }
+                    else
+                    {
+                        contains_reporter.errors.insert(contains_reporter.errors.end(), 
+                                                        std::make_move_iterator(item_reporter.errors.begin()), 
+                                                        std::make_move_iterator(item_reporter.errors.end()));
+                    }
+                }
+                else if (item_validator)
+                {
+                    item_validator->validate(instance_location.append(index), cursor, reporter, patch);
+                }
+                else
+                {
+                    skip_instance(cursor);
+                }
+                if (reporter.error_count() > 0 && reporter.fail_early())
+                {
+                    return;
+                }
+                ++index;
+                cursor.next();
+            }
+
+            if (max_items_ && index > *max_items_)
+            {
+                std::string message("Expected maximum item count: " + std::to_string(*max_items_));
+                message.append(", found: " + std::to_string(index));
+                reporter.error(validation_output(instance_location.string(), std::move(message), "maxItems", absolute_max_items_location_));
+                if (reporter.fail_early())
+                {
+                    return;
+                }
+            }
+
+            if (min_items_ && index < *min_items_)
+            {
+                std::string message("Expected minimum item count: " + std::to_string(*min_items_));
+                message.append(", found: " + std::to_string(index));
+                reporter.error(validation_output(instance_location.string(), std::move(message), "minItems", absolute_min_items_location_));
+                if (reporter.fail_early())
+                {
+                    return;
+                }
+            }
+
+            if (contains_ && !contained)
+            {
+                reporter.error(validation_output(instance_location.string(), "Expected at least one array item to match \"contains\" schema", "contains", this->absolute_keyword_location(), contains_reporter.errors));
+            }
+        }
+
+        struct item_hash
+        {
+            std::size_t operator()(const Json* p) const noexcept
+            {
+                return p->hash();
+            }
+        };
+
+        struct item_equal
+        {
+            bool operator()(const Json* a, const Json* b) const noexcept
+            {
+                return *a == *b;
+            }
+        };
+
         static bool array_has_unique_items(const Json& a) 
         {
-            for (auto it = a.array_range().begin(); it != a.array_range().end(); ++it) 
+            // Pairwise comparison is cheaper than hashing for short arrays
+            if (a.size() <= 16)
             {
-                for (auto jt = it+1; jt != a.array_range().end(); ++jt) 
+                for (auto it = a.array_range().begin(); it != a.array_range().end(); ++it) 
                 {
-                    if (*it == *jt) 
+                    for (auto jt = it+1; jt != a.array_range().end(); ++jt) 
                     {
-                        return false; // contains duplicates 
+                        if (*it == *jt) 
+                        {
+                            return false; // contains duplicates 
+                        }
                     }
                 }
+                return true; // elements are unique
+            }
+
+            std::unordered_set<const Json*,item_hash,item_equal> seen(a.size());
+            for (const auto& item : a.array_range()) 
+            {
+                if (!seen.insert(std::addressof(item)).second)
+                {
+                    return false; // contains duplicates 
+                }
             }
             return true; // elements are unique
         }
@@ -1229,14 +1724,15 @@ namespace jsonschema {
             }
         }
     private:
-        void do_validate(const uri_wrapper& instance_location, 
+        void do_validate(const instance_path& instance_location, 
                          const Json& instance, 
                          error_reporter& reporter, 
                          Json& patch) const final
         {
             if (if_) 
             {
-                collecting_error_reporter local_reporter;
+                // Only whether there is an error matters
+                collecting_error_reporter local_reporter(true);
 
                 if_->validate(instance_location, instance, local_reporter, patch);
                 if (local_reporter.errors.empty()) 
@@ -1261,26 +1757,51 @@ namespace jsonschema {
         using schema_pointer = typename schema_keyword<Json>::schema_pointer;
 
         Json enum_;
+        // Maps the hash of each enum value to its position, empty for short enums
+        std::unordered_multimap<std::size_t,std::size_t> index_;
 
     public:
         enum_keyword(const Json& sch,
                   const std::vector<uri_wrapper>& uris)
             : schema_keyword<Json>((!uris.empty() && uris.back().is_absolute()) ? uris.back().string() : ""), enum_(sch)
         {
+            if (enum_.is_array() && enum_.size() > 8)
+            {
+                index_.reserve(enum_.size());
+                for (std::size_t i = 0; i < enum_.size(); ++i)
+                {
+                    index_.emplace(enum_[i].hash(), i);
+                }
+            }
         }
     private:
-        void do_validate(const uri_wrapper& instance_location, 
+        void do_validate(const instance_path& instance_location, 
                          const Json& instance, 
                          error_reporter& reporter,
                          Json&) const final
         {
             bool in_range = false;
-            for (const auto& item : enum_.array_range())
+            if (!index_.empty())
             {
-                if (item == instance) 
+                auto range = index_.equal_range(instance.hash());
+                for (auto it = range.first; it != range.second; ++it)
                 {
-                    in_range = true;
-                    break;
+                    if (enum_[it->second] == instance) 
+                    {
+                        in_range = true;
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                for (const auto& item : enum_.array_range())
+                {
+                    if (item == instance) 
+                    {
+                        in_range = true;
+                        break;
+                    }
                 }
             }
 
@@ -1310,7 +1831,7 @@ namespace jsonschema {
         {
         }
     private:
-        void do_validate(const uri_wrapper& instance_location, 
+        void do_validate(const instance_path& instance_location, 
                          const Json& instance, 
                          error_reporter& reporter,
                          Json&) const final
@@ -1330,6 +1851,7 @@ namespace jsonschema {
         jsoncons::optional<enum_keyword<Json>> enum_;
         jsoncons::optional<const_keyword<Json>> const_;
         std::vector<schema_pointer> combined_;
+        std::vector<schema_pointer> combined_by_cost_;
         jsoncons::optional<conditional_keyword<Json>> conditional_;
         std::vector<std::string> expected_types_;
 
@@ -1404,28 +1926,45 @@ namespace jsonschema {
                 const_ = const_keyword<Json>(it->value(), uris);
             }
 
+            std::vector<std::pair<std::size_t,schema_pointer>> combined;
+
             it = sch.find("not");
             if (it != sch.object_range().end()) 
             {
-                combined_.push_back(builder->make_not_keyword(it->value(), uris));
+                combined.emplace_back(estimate_cost(it->value()), builder->make_not_keyword(it->value(), uris));
+                combined_.push_back(combined.back().second);
             }
 
             it = sch.find("allOf");
             if (it != sch.object_range().end()) 
             {
-                combined_.push_back(builder->make_all_of_keyword(it->value(), uris));
+                combined.emplace_back(estimate_cost(it->value()), builder->make_all_of_keyword(it->value(), uris));
+                combined_.push_back(combined.back().second);
             }
 
             it = sch.find("anyOf");
             if (it != sch.object_range().end()) 
             {
-                combined_.push_back(builder->make_any_of_keyword(it->value(), uris));
+                combined.emplace_back(estimate_cost(it->value()), builder->make_any_of_keyword(it->value(), uris));
+                combined_.push_back(combined.back().second);
             }
 
             it = sch.find("oneOf");
             if (it != sch.object_range().end()) 
             {
-                combined_.push_back(builder->make_one_of_keyword(it->value(), uris));
+                // Every subschema of oneOf is evaluated for a valid instance
+                combined.emplace_back(2*estimate_cost(it->value()), builder->make_one_of_keyword(it->value(), uris));
+                combined_.push_back(combined.back().second);
+            }
+
+            std::stable_sort(combined.begin(), combined.end(),
+                             [](const std::pair<std::size_t,schema_pointer>& a, const std::pair<std::size_t,schema_pointer>& b)
+                             {
+                                 return a.first < b.first;
+                             });
+            for (auto& item : combined)
+            {
+                combined_by_cost_.push_back(item.second);
             }
 
             it = sch.find("if");
@@ -1436,59 +1975,65 @@ namespace jsonschema {
         }
     private:
 
-        void do_validate(const uri_wrapper& instance_location, 
+        void do_validate(const instance_path& instance_location, 
                          const Json& instance, 
                          error_reporter& reporter, 
                          Json& patch) const override final
         {
             auto type = type_mapping_[(uint8_t) instance.type()];
-
-            if (type)
-                type->validate(instance_location, instance, reporter, patch);
-            else
+            if (reporter.fail_early())
             {
-                std::ostringstream ss;
-                ss << "Expected ";
-                for (std::size_t i = 0; i < expected_types_.size(); ++i)
+                // Cheap checks first: the type, then const and enum, then the keywords 
+                // for the type, which may have patterns and subschemas
+                if (!type)
                 {
-                        if (i > 0)
-                        { 
-                            ss << ", ";
-                            if (i+1 == expected_types_.size())
-                            { 
-                                ss << "or ";
-                            }
-                        }
-                        ss << expected_types_[i];
+                    report_unexpected_type(instance_location, instance.type(), reporter);
+                    return;
                 }
-                ss << ", found " << instance.type();
 
-                reporter.error(validation_output(instance_location.string(), ss.str(), "type", this->absolute_keyword_location()));
-                if (reporter.fail_early())
-                {
-                    return;
+                if (const_)
+                { 
+                    const_->validate(instance_location, instance, reporter, patch);
+                    if (reporter.error_count() > 0)
+                    {
+                        return;
+                    }
                 }
-            }
 
-            if (enum_)
-            { 
-                enum_->validate(instance_location, instance, reporter, patch);
-                if (reporter.error_count() > 0 && reporter.fail_early())
+                if (enum_)
+                { 
+                    enum_->validate(instance_location, instance, reporter, patch);
+                    if (reporter.error_count() > 0)
+                    {
+                        return;
+                    }
+                }
+
+                type->validate(instance_location, instance, reporter, patch);
+                if (reporter.error_count() > 0)
                 {
                     return;
                 }
             }
+            else
+            {
+                if (type)
+                    type->validate(instance_location, instance, reporter, patch);
+                else
+                    report_unexpected_type(instance_location, instance.type(), reporter);
 
-            if (const_)
-            { 
-                const_->validate(instance_location, instance, reporter, patch);
-                if (reporter.error_count() > 0 && reporter.fail_early())
-                {
-                    return;
+                if (enum_)
+                { 
+                    enum_->validate(instance_location, instance, reporter, patch);
+                }
+
+                if (const_)
+                { 
+                    const_->validate(instance_location, instance, reporter, patch);
                 }
             }
 
-            for (const auto& l : combined_)
+            for (const auto& l : reporter.fail_early() ? combined_by_cost_ : combined_)
             {
                 l->validate(instance_location, instance, reporter, patch);
                 if (reporter.error_count() > 0 && reporter.fail_early())
@@ -1508,7 +2053,62 @@ namespace jsonschema {
             }
         }
 
-        jsoncons::optional<Json> get_default_value(const uri_wrapper&, 
+        void do_validate_stream(const instance_path& instance_location, 
+                                typename schema_keyword<Json>::cursor_type& cursor, 
+                                error_reporter& reporter, 
+                                Json& patch) const override final
+        {
+            // Objects and arrays are checked as they are read, unless a keyword 
+            // needs the whole value
+            auto event_type = cursor.current().event_type();
+            if ((event_type != staj_event_type::begin_object && event_type != staj_event_type::begin_array) ||
+                enum_ || const_ || !combined_.empty() || conditional_)
+            {
+                Json instance = read_instance<Json>(cursor);
+                do_validate(instance_location, instance, reporter, patch);
+                return;
+            }
+
+            json_type instance_type = event_type == staj_event_type::begin_object ? json_type::object_value : json_type::array_value;
+            auto type = type_mapping_[(uint8_t) instance_type];
+            if (type)
+            {
+                type->validate(instance_location, cursor, reporter, patch);
+            }
+            else
+            {
+                report_unexpected_type(instance_location, instance_type, reporter);
+                if (!reporter.fail_early())
+                {
+                    skip_instance(cursor);
+                }
+            }
+        }
+
+        void report_unexpected_type(const instance_path& instance_location, 
+                                    json_type instance_type, 
+                                    error_reporter& reporter) const
+        {
+            std::ostringstream ss;
+            ss << "Expected ";
+            for (std::size_t i = 0; i < expected_types_.size(); ++i)
+            {
+                    if (i > 0)
+                    { 
+                        ss << ", ";
+                        if (i+1 == expected_types_.size())
+                        { 
+                            ss << "or ";
+                        }
+                    }
+                    ss << expected_types_[i];
+            }
+            ss << ", found " << instance_type;
+
+            reporter.error(validation_output(instance_location.string(), ss.str(), "type", this->absolute_keyword_location()));
+        }
+
+        jsoncons::optional<Json> get_default_value(const instance_path&, 
                                                    const Json&,
                                                    error_reporter&) const override
         {
@@ -18,10 +18,8 @@
 #include <set>
 #include <sstream>
 #include <iostream>
-#include <cassert>
-#if defined(JSONCONS_HAS_STD_REGEX)
-#include <regex>
-#endif
+#include <mutex> // std::mutex
+#include <memory> // std::addressof
 
 namespace jsoncons {
 namespace jsonschema {
@@ -44,7 +42,7 @@ namespace jsonschema {
 
     private:
 
-        void do_validate(const uri_wrapper& instance_location, 
+        void do_validate(const instance_path& instance_location, 
                          const Json& instance, 
                          error_reporter& reporter, 
                          Json& patch) const override
@@ -58,7 +56,22 @@ namespace jsonschema {
             referred_schema_->validate(instance_location, instance, reporter, patch);
         }
 
-        jsoncons::optional<Json> get_default_value(const uri_wrapper& instance_location, 
+        void do_validate_stream(const instance_path& instance_location, 
+                                typename schema_keyword<Json>::cursor_type& cursor, 
+                                error_reporter& reporter, 
+                                Json& patch) const override
+        {
+            if (!referred_schema_)
+            {
+                reporter.error(validation_output(instance_location.string(), "Unresolved schema reference " + this->absolute_keyword_location(), "", this->absolute_keyword_location()));
+                skip_instance(cursor);
+                return;
+            }
+
+            referred_schema_->validate(instance_location, cursor, reporter, patch);
+        }
+
+        jsoncons::optional<Json> get_default_value(const instance_path& instance_location, 
                                                    const Json& instance, 
                                                    error_reporter& reporter) const override
         {
@@ -84,10 +97,13 @@ namespace jsonschema {
 
         std::vector<std::unique_ptr<schema_keyword<Json>>> subschemas_;
         schema_pointer root_;
+        // Schemas from a schema_cache that this schema refers to
+        std::vector<std::shared_ptr<json_schema<Json>>> dependencies_;
     public:
         json_schema(std::vector<std::unique_ptr<schema_keyword<Json>>>&& subschemas,
-                    schema_pointer root)
-            : subschemas_(std::move(subschemas)), root_(root)
+                    schema_pointer root,
+                    std::vector<std::shared_ptr<json_schema<Json>>>&& dependencies = std::vector<std::shared_ptr<json_schema<Json>>>())
+            : subschemas_(std::move(subschemas)), root_(root), dependencies_(std::move(dependencies))
         {
             if (root_ == nullptr)
                 JSONCONS_THROW(schema_error("There is no root schema to validate an instance against"));
@@ -98,7 +114,7 @@ namespace jsonschema {
         json_schema& operator=(const json_schema&) = delete;
         json_schema& operator=(json_schema&&) = default;
     
-        void validate(const uri_wrapper& instance_location, 
+        void validate(const instance_path& instance_location, 
                       const Json& instance, 
                       error_reporter& reporter, 
                       Json& patch) const 
@@ -106,6 +122,15 @@ namespace jsonschema {
             JSONCONS_ASSERT(root_ != nullptr);
             root_->validate(instance_location, instance, reporter, patch);
         }
+
+        void validate(const instance_path& instance_location, 
+                      basic_staj_cursor<typename Json::char_type>& cursor, 
+                      error_reporter& reporter, 
+                      Json& patch) const 
+        {
+            JSONCONS_ASSERT(root_ != nullptr);
+            root_->validate(instance_location, cursor, reporter, patch);
+        }
     };
 
     template <class Json>
@@ -122,6 +147,69 @@ namespace jsonschema {
         }
     };
 
+    // A cache of compiled external schema documents, keyed by absolute URI, that may be 
+    // shared by schema_loaders on any thread. A document referenced by "$ref" from several 
+    // schemas is resolved and built once. The compiled keywords depend on the regex_engine,
+    // so the cache owns it, and every schema loaded through the cache uses it.
+    template <class Json>
+    class schema_cache
+    {
+    public:
+        using schema_pointer = typename schema_keyword<Json>::schema_pointer;
+
+        struct entry
+        {
+            std::shared_ptr<json_schema<Json>> schema;
+            // The subschemas of the document, by base URI and fragment
+            std::map<std::string, std::map<std::string, schema_pointer>> schemas;
+            // Values that are not subschemas, but may be referenced by JSON Pointer
+            std::map<std::string, std::map<std::string, Json>> unprocessed_keywords;
+        };
+    private:
+        regex_engine engine_;
+        mutable std::mutex mutex_;
+        std::map<std::string, std::shared_ptr<const entry>> entries_;
+    public:
+        explicit schema_cache(regex_engine engine = default_regex_engine())
+            : engine_(std::move(engine))
+        {
+        }
+        schema_cache(const schema_cache&) = delete;
+        schema_cache& operator=(const schema_cache&) = delete;
+
+        const regex_engine& engine() const
+        {
+            return engine_;
+        }
+
+        std::shared_ptr<const entry> find(const std::string& uri) const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(uri);
+            return it != entries_.end() ? it->second : std::shared_ptr<const entry>();
+        }
+
+        // Returns the cached entry, which is the one inserted first if two threads 
+        // loaded the same document
+        std::shared_ptr<const entry> insert(const std::string& uri, std::shared_ptr<const entry> e)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return entries_.emplace(uri, std::move(e)).first->second;
+        }
+
+        std::size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return entries_.size();
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            entries_.clear();
+        }
+    };
+
     template <class Json>
     class schema_loader : public schema_builder<Json>
     {
@@ -135,18 +223,34 @@ namespace jsonschema {
         };
 
         uri_resolver<Json> resolver_;
+        regex_engine regex_engine_;
         schema_pointer root_;
 
+        // Compiled patterns, shared by all keywords that use the same pattern
+        std::map<std::string, regex_matcher_pointer> regexes_;
+
         // Owns all schemas
         std::vector<std::unique_ptr<schema_keyword<Json>>> subschemas_;
 
         // Map location to subschema_registry
         std::map<std::string, subschema_registry> subschema_registries_;
 
+        schema_cache<Json>* cache_;
+        // The external documents taken from the cache
+        std::map<std::string, std::shared_ptr<const typename schema_cache<Json>::entry>> cached_;
+        // The documents being loaded into the cache by this loader and the loaders that started it
+        std::set<std::string> loading_;
+
     public:
-        schema_loader(uri_resolver<Json>&& resolver) noexcept
+        schema_loader(uri_resolver<Json>&& resolver, 
+                      regex_engine engine = default_regex_engine())
+            : resolver_(std::move(resolver)), regex_engine_(std::move(engine)), cache_(nullptr)
+        {
+        }
 
-            : resolver_(std::move(resolver))
+        schema_loader(uri_resolver<Json>&& resolver, 
+                      schema_cache<Json>& cache)
+            : resolver_(std::move(resolver)), regex_engine_(cache.engine()), cache_(std::addressof(cache))
         {
         }
 
@@ -157,7 +261,12 @@ namespace jsonschema {
 
         std::shared_ptr<json_schema<Json>> get_schema()
         {
-            return std::make_shared<json_schema<Json>>(std::move(subschemas_), root_);
+            std::vector<std::shared_ptr<json_schema<Json>>> dependencies;
+            for (const auto& item : cached_)
+            {
+                dependencies.push_back(item.second->schema);
+            }
+            return std::make_shared<json_schema<Json>>(std::move(subschemas_), root_, std::move(dependencies));
         }
 
         schema_pointer make_required_keyword(const std::vector<uri_wrapper>& uris,
@@ -214,12 +323,24 @@ namespace jsonschema {
         schema_pointer make_string_keyword(const Json& schema,
                                         const std::vector<uri_wrapper>& uris) override
         {
-            auto sch_orig = jsoncons::make_unique<string_keyword<Json>>(schema, uris);
+            auto sch_orig = jsoncons::make_unique<string_keyword<Json>>(this, schema, uris);
             auto sch = sch_orig.get();
             subschemas_.emplace_back(std::move(sch_orig));
             return sch;
         }
 
+        regex_matcher_pointer make_regex(const std::string& pattern) override
+        {
+            auto it = regexes_.find(pattern);
+            if (it != regexes_.end())
+            {
+                return it->second;
+            }
+            regex_matcher_pointer matcher = regex_engine_ ? regex_engine_(pattern) : regex_matcher_pointer();
+            regexes_.emplace(pattern, matcher);
+            return matcher;
+        }
+
         schema_pointer make_boolean_keyword(const std::vector<uri_wrapper>& uris) override
         {
             auto sch_orig = jsoncons::make_unique<boolean_keyword<Json>>(uris);
@@ -354,9 +475,16 @@ namespace jsonschema {
         }
 
         void load(const Json& sch)
+        {
+            load(sch, uri_wrapper("#"));
+        }
+
+    private:
+
+        void load(const Json& sch, const uri_wrapper& base)
         {
             subschema_registries_.clear();
-            root_ = build(sch, {{"#"}}, {});
+            root_ = build(sch, {base}, {});
 
             // load all external schemas that have not already been loaded
 
@@ -371,7 +499,14 @@ namespace jsonschema {
 
                 for (const auto& loc : locations) 
                 {
-                    if (subschema_registries_[loc].schemas.empty()) // registry for this file is empty
+                    if (cache_ != nullptr && use_cache(loc)) 
+                    {
+                        if (link_cached(loc))
+                        {
+                            ++loaded_count;
+                        }
+                    }
+                    else if (subschema_registries_[loc].schemas.empty()) // registry for this file is empty
                     { 
                         if (resolver_) 
                         {
@@ -399,7 +534,85 @@ namespace jsonschema {
             }
         }
 
-    private:
+        bool use_cache(const std::string& loc)
+        {
+            if (cached_.find(loc) != cached_.end())
+            {
+                return true;
+            }
+            // Documents that refer back to a document being loaded into the cache build it themselves
+            if (!subschema_registries_[loc].schemas.empty() || loading_.find(loc) != loading_.end())
+            {
+                return false;
+            }
+
+            auto e = cache_->find(loc);
+            if (!e)
+            {
+                if (!resolver_) 
+                {
+                    JSONCONS_THROW(schema_error("External schema reference '" + loc + "' needs to be loaded, but no resolver provided"));
+                }
+                Json external_schema = resolver_(loc);
+
+                schema_loader<Json> loader(uri_resolver<Json>(resolver_), *cache_);
+                loader.loading_ = loading_;
+                loader.loading_.insert(loc);
+                loader.load(external_schema, uri_wrapper(loc));
+
+                auto new_entry = std::make_shared<typename schema_cache<Json>::entry>();
+                for (auto& registry : loader.subschema_registries_)
+                {
+                    new_entry->schemas[registry.first] = registry.second.schemas;
+                    new_entry->unprocessed_keywords[registry.first] = std::move(registry.second.unprocessed_keywords);
+                }
+                new_entry->schema = loader.get_schema();
+                e = cache_->insert(loc, std::move(new_entry));
+            }
+            cached_.emplace(loc, e);
+            return true;
+        }
+
+        // Resolves the references to a cached document, and returns false if there were none that could be
+        bool link_cached(const std::string& loc)
+        {
+            const auto& e = *cached_[loc];
+            auto& file = subschema_registries_[loc];
+
+            std::vector<std::string> fragments;
+            for (const auto& item : file.unresolved)
+            {
+                fragments.push_back(item.first);
+            }
+
+            bool linked = false;
+            auto schemas_it = e.schemas.find(loc);
+            auto unprocessed_it = e.unprocessed_keywords.find(loc);
+            for (const auto& fragment : fragments)
+            {
+                if (schemas_it != e.schemas.end())
+                {
+                    auto it = schemas_it->second.find(fragment);
+                    if (it != schemas_it->second.end())
+                    {
+                        insert(uri_wrapper(loc + "#" + fragment), it->second);
+                        linked = true;
+                        continue;
+                    }
+                }
+                // A value that the cached document doesn't use as a schema is built here
+                if (unprocessed_it != e.unprocessed_keywords.end())
+                {
+                    auto it = unprocessed_it->second.find(fragment);
+                    if (it != unprocessed_it->second.end())
+                    {
+                        build(it->second, {uri_wrapper(loc + "#" + fragment)}, {});
+                        linked = true;
+                    }
+                }
+            }
+            return linked;
+        }
 
         void insert(const uri_wrapper& uri, schema_pointer s)
         {
@@ -524,6 +737,26 @@ namespace jsonschema {
         return loader.get_schema();
     }
 
+    template <class Json,class URIResolver>
+    typename std::enable_if<type_traits::is_unary_function_object_exact<URIResolver,Json,std::string>::value,std::shared_ptr<json_schema<Json>>>::type
+    make_schema(const Json& schema, const URIResolver& resolver, const regex_engine& engine)
+    {
+        schema_loader<Json> loader(resolver, engine);
+        loader.load(schema);
+
+        return loader.get_schema();
+    }
+
+    template <class Json,class URIResolver>
+    typename std::enable_if<type_traits::is_unary_function_object_exact<URIResolver,Json,std::string>::value,std::shared_ptr<json_schema<Json>>>::type
+    make_schema(const Json& schema, const URIResolver& resolver, schema_cache<Json>& cache)
+    {
+        schema_loader<Json> loader(resolver, cache);
+        loader.load(schema);
+
+        return loader.get_schema();
+    }
+
 } // namespace jsonschema
 } // namespace jsoncons
 
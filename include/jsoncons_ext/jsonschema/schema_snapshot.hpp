@@ -0,0 +1,86 @@
+// Copyright 2020 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSONSCHEMA_SCHEMA_SNAPSHOT_HPP
+#define JSONCONS_JSONSCHEMA_SCHEMA_SNAPSHOT_HPP
+
+#include <jsoncons/config/jsoncons_config.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/jsonschema/schema_loader.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace jsoncons {
+namespace jsonschema {
+
+    // A snapshot is a CBOR map with the schema, and every external document that
+    // it references, directly or indirectly, as returned by the resolver:
+    //
+    //     {"schema": <schema>, "documents": {<absolute URI>: <document>, ...}}
+    //
+    // Schemas made from a snapshot don't call a resolver, or parse JSON text.
+
+    template <class Json,class URIResolver>
+    typename std::enable_if<type_traits::is_unary_function_object_exact<URIResolver,Json,std::string>::value,void>::type
+    encode_schema_snapshot(const Json& schema, const URIResolver& resolver, std::vector<uint8_t>& buffer)
+    {
+        uri_resolver<Json> resolve(resolver);
+        Json documents(json_object_arg);
+        auto recorder = [&resolve,&documents](const jsoncons::uri& uri) -> Json
+        {
+            Json document = resolve(uri);
+            documents.try_emplace(uri.string(), document);
+            return document;
+        };
+
+        // Loading the schema checks it, and finds the documents it references
+        schema_loader<Json> loader(recorder);
+        loader.load(schema);
+
+        Json snapshot(json_object_arg);
+        snapshot.try_emplace("schema", schema);
+        snapshot.try_emplace("documents", std::move(documents));
+        cbor::encode_cbor(snapshot, buffer);
+    }
+
+    template <class Json>
+    void encode_schema_snapshot(const Json& schema, std::vector<uint8_t>& buffer)
+    {
+        encode_schema_snapshot(schema, default_uri_resolver<Json>(), buffer);
+    }
+
+    template <class Json>
+    std::shared_ptr<json_schema<Json>> make_schema_from_snapshot(const std::vector<uint8_t>& buffer,
+                                                                 const regex_engine& engine = default_regex_engine())
+    {
+        Json snapshot = cbor::decode_cbor<Json>(buffer);
+        if (!snapshot.is_object() || !snapshot.contains("schema") || !snapshot.contains("documents"))
+        {
+            JSONCONS_THROW(schema_error("Not a JSON Schema snapshot"));
+        }
+        const Json& documents = snapshot.at("documents");
+        auto resolver = [&documents](const jsoncons::uri& uri) -> Json
+        {
+            auto it = documents.find(uri.string());
+            if (it == documents.object_range().end())
+            {
+                JSONCONS_THROW(schema_error("JSON Schema " + uri.string() + " is not in the snapshot"));
+            }
+            return it->value();
+        };
+
+        schema_loader<Json> loader(resolver, engine);
+        loader.load(snapshot.at("schema"));
+
+        return loader.get_schema();
+    }
+
+} // namespace jsonschema
+} // namespace jsoncons
+
+#endif // JSONCONS_JSONSCHEMA_SCHEMA_SNAPSHOT_HPP
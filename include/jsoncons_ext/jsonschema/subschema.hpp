@@ -10,6 +10,8 @@
 #include <jsoncons/config/jsoncons_config.hpp>
 #include <jsoncons/uri.hpp>
 #include <jsoncons/json.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/staj_cursor.hpp>
 #include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
 #include <jsoncons_ext/jsonschema/jsonschema_error.hpp>
 
@@ -199,14 +201,108 @@ namespace jsonschema {
         }
     };
 
+    // The location of a value in the instance being validated. Each location 
+    // refers to its parent and to a member name or array index, and lives on 
+    // the call stack of the validator, so descending into an instance allocates 
+    // nothing. It is turned into a JSON Pointer only when an error or default 
+    // value is reported. A location must not outlive its parent or the name it 
+    // refers to.
+    class instance_path
+    {
+        const instance_path* parent_;
+        jsoncons::string_view name_;
+        std::size_t index_;
+        bool is_index_;
+    public:
+        // The root of the instance
+        instance_path()
+            : parent_(nullptr), index_(0), is_index_(false)
+        {
+        }
+
+        instance_path(const instance_path& parent, const jsoncons::string_view& name)
+            : parent_(std::addressof(parent)), name_(name), index_(0), is_index_(false)
+        {
+        }
+
+        instance_path(const instance_path& parent, std::size_t index)
+            : parent_(std::addressof(parent)), index_(index), is_index_(true)
+        {
+        }
+
+        instance_path append(const jsoncons::string_view& name) const
+        {
+            return instance_path(*this, name);
+        }
+
+        instance_path append(const std::string& name) const
+        {
+            return instance_path(*this, jsoncons::string_view(name));
+        }
+
+        instance_path append(std::size_t index) const
+        {
+            return instance_path(*this, index);
+        }
+
+        // The JSON Pointer to the value, e.g. "/a/0"
+        std::string pointer() const
+        {
+            std::string s;
+            append_to(s);
+            return s;
+        }
+
+        // The JSON Pointer to the value as a URI fragment, e.g. "#/a/0"
+        std::string string() const
+        {
+            std::string s("#");
+            append_to(s);
+            return s;
+        }
+    private:
+        void append_to(std::string& s) const
+        {
+            if (parent_ == nullptr)
+            {
+                return;
+            }
+            parent_->append_to(s);
+            s.push_back('/');
+            if (is_index_)
+            {
+                s.append(std::to_string(index_));
+            }
+            else
+            {
+                for (auto c : name_)
+                {
+                    switch (c)
+                    {
+                        case '~':
+                            s.append("~0");
+                            break;
+                        case '/':
+                            s.append("~1");
+                            break;
+                        default:
+                            s.push_back(c);
+                            break;
+                    }
+                }
+            }
+        }
+    };
+
     // Interface for validation error handlers
     class error_reporter
     {
         bool fail_early_;
         std::size_t error_count_;
+        std::size_t max_threads_;
     public:
         error_reporter(bool fail_early = false)
-            : fail_early_(fail_early), error_count_(0)
+            : fail_early_(fail_early), error_count_(0), max_threads_(1)
         {
         }
 
@@ -228,16 +324,134 @@ namespace jsonschema {
             return fail_early_;
         }
 
+        // The number of threads that the items of a large array may be validated on
+        std::size_t max_threads() const
+        {
+            return max_threads_;
+        }
+
+        void max_threads(std::size_t value)
+        {
+            max_threads_ = value;
+        }
+
     private:
         virtual void do_error(const validation_output& /* e */) = 0;
     };
 
+    // Reads the value that begins at the current event of the cursor
+    template <class Json>
+    Json read_instance(basic_staj_cursor<typename Json::char_type>& cursor)
+    {
+        json_decoder<Json> decoder;
+        cursor.read_to(decoder);
+        return decoder.get_result();
+    }
+
+namespace detail {
+
+    // Accepts the events of one value, and asks for no more once the value is complete
+    template <class CharT>
+    class value_skipper : public basic_json_visitor<CharT>
+    {
+        using typename basic_json_visitor<CharT>::string_view_type;
+
+        std::size_t level_;
+    public:
+        value_skipper()
+            : level_(0)
+        {
+        }
+    private:
+        void visit_flush() override
+        {
+        }
+
+        bool visit_begin_object(semantic_tag, const ser_context&, std::error_code&) override
+        {
+            ++level_;
+            return true;
+        }
+
+        bool visit_end_object(const ser_context&, std::error_code&) override
+        {
+            return --level_ != 0;
+        }
+
+        bool visit_begin_array(semantic_tag, const ser_context&, std::error_code&) override
+        {
+            ++level_;
+            return true;
+        }
+
+        bool visit_end_array(const ser_context&, std::error_code&) override
+        {
+            return --level_ != 0;
+        }
+
+        bool visit_key(const string_view_type&, const ser_context&, std::error_code&) override
+        {
+            return true;
+        }
+
+        bool visit_null(semantic_tag, const ser_context&, std::error_code&) override
+        {
+            return level_ != 0;
+        }
+
+        bool visit_string(const string_view_type&, semantic_tag, const ser_context&, std::error_code&) override
+        {
+            return level_ != 0;
+        }
+
+        bool visit_byte_string(const byte_string_view&, semantic_tag, const ser_context&, std::error_code&) override
+        {
+            return level_ != 0;
+        }
+
+        bool visit_uint64(uint64_t, semantic_tag, const ser_context&, std::error_code&) override
+        {
+            return level_ != 0;
+        }
+
+        bool visit_int64(int64_t, semantic_tag, const ser_context&, std::error_code&) override
+        {
+            return level_ != 0;
+        }
+
+        bool visit_half(uint16_t, semantic_tag, const ser_context&, std::error_code&) override
+        {
+            return level_ != 0;
+        }
+
+        bool visit_double(double, semantic_tag, const ser_context&, std::error_code&) override
+        {
+            return level_ != 0;
+        }
+
+        bool visit_bool(bool, semantic_tag, const ser_context&, std::error_code&) override
+        {
+            return level_ != 0;
+        }
+    };
+
+} // namespace detail
+
+    // Consumes the value that begins at the current event of the cursor
+    template <class CharT>
+    void skip_instance(basic_staj_cursor<CharT>& cursor)
+    {
+        detail::value_skipper<CharT> visitor;
+        cursor.read_to(visitor);
+    }
+
     template <class Json>
     class schema_keyword 
     {
         std::string absolute_keyword_location_;
     public:
         using schema_pointer = schema_keyword<Json>*;
+        using cursor_type = basic_staj_cursor<typename Json::char_type>;
 
         schema_keyword(const std::string& absolute_keyword_location)
             : absolute_keyword_location_(absolute_keyword_location)
@@ -256,7 +470,7 @@ namespace jsonschema {
             return absolute_keyword_location_;
         }
 
-        void validate(const uri_wrapper& instance_location, 
+        void validate(const instance_path& instance_location, 
                       const Json& instance, 
                       error_reporter& reporter, 
                       Json& patch) const 
@@ -264,16 +478,38 @@ namespace jsonschema {
             do_validate(instance_location,instance,reporter,patch);
         }
 
-        virtual jsoncons::optional<Json> get_default_value(const uri_wrapper&, const Json&, error_reporter&) const
+        // Validates the value that begins at the current event of the cursor. 
+        // The value is consumed, so that the cursor's next() moves past it, 
+        // unless validation stops early on an error.
+        void validate(const instance_path& instance_location, 
+                      cursor_type& cursor, 
+                      error_reporter& reporter, 
+                      Json& patch) const 
+        {
+            do_validate_stream(instance_location,cursor,reporter,patch);
+        }
+
+        virtual jsoncons::optional<Json> get_default_value(const instance_path&, const Json&, error_reporter&) const
         {
             return jsoncons::optional<Json>();
         }
 
     private:
-        virtual void do_validate(const uri_wrapper& instance_location, 
+        virtual void do_validate(const instance_path& instance_location, 
                                  const Json& instance, 
                                  error_reporter& reporter, 
                                  Json& patch) const = 0;
+
+        // Keywords that can check a value as it is read override this, by default
+        // the value is read into memory and validated as a whole
+        virtual void do_validate_stream(const instance_path& instance_location, 
+                                        cursor_type& cursor, 
+                                        error_reporter& reporter, 
+                                        Json& patch) const
+        {
+            Json instance = read_instance<Json>(cursor);
+            do_validate(instance_location, instance, reporter, patch);
+        }
     };
 
     template <class Json>
@@ -19,6 +19,7 @@
 #include <jsoncons_ext/msgpack/msgpack_cursor.hpp>
 #include <jsoncons_ext/msgpack/encode_msgpack.hpp>
 #include <jsoncons_ext/msgpack/decode_msgpack.hpp>
+#include <jsoncons_ext/msgpack/msgpack_sequence_index.hpp>
 
 #endif
 
@@ -0,0 +1,850 @@
+// Copyright 2020 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_MSGPACK_MSGPACK_CBOR_TRANSCODE_HPP
+#define JSONCONS_MSGPACK_MSGPACK_CBOR_TRANSCODE_HPP
+
+#include <limits> // std::numeric_limits
+#include <type_traits> // std::enable_if
+#include <system_error>
+#include <jsoncons/config/jsoncons_config.hpp>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/more_type_traits.hpp>
+#include <jsoncons/source.hpp>
+#include <jsoncons/sink.hpp>
+#include <jsoncons/unicode_traits.hpp>
+#include <jsoncons_ext/cbor/cbor_reader.hpp>
+#include <jsoncons_ext/cbor/cbor_encoder.hpp>
+#include <jsoncons_ext/cbor/cbor_sequence_index.hpp>
+#include <jsoncons_ext/msgpack/msgpack_detail.hpp>
+#include <jsoncons_ext/msgpack/msgpack_reader.hpp>
+#include <jsoncons_ext/msgpack/msgpack_encoder.hpp>
+
+namespace jsoncons { namespace msgpack {
+
+namespace detail {
+
+    // Writes the n low order bytes of value in big endian order
+    template <class Container>
+    void write_be(uint64_t value, std::size_t n, Container& dest)
+    {
+        for (std::size_t i = n; i-- > 0;)
+        {
+            dest.push_back(static_cast<uint8_t>(value >> (8*i)));
+        }
+    }
+
+    // Copies n bytes starting at p to dest, or sets ec if fewer than n remain
+    template <class Container,class Errc>
+    const uint8_t* copy_bytes(const uint8_t* p, const uint8_t* last, std::size_t n,
+                              Container& dest, Errc eof, std::error_code& ec)
+    {
+        if (static_cast<std::size_t>(last - p) < n)
+        {
+            ec = eof;
+            return last;
+        }
+        dest.insert(dest.end(), p, p + n);
+        return p + n;
+    }
+
+    // CBOR to MessagePack
+
+    template <class Container>
+    class cbor_to_msgpack_transcoder
+    {
+        const uint8_t* first_;
+        const uint8_t* last_;
+        Container& dest_;
+        int max_nesting_depth_;
+    public:
+        cbor_to_msgpack_transcoder(const uint8_t* first, const uint8_t* last,
+                                   Container& dest, int max_nesting_depth)
+            : first_(first), last_(last), dest_(dest), max_nesting_depth_(max_nesting_depth)
+        {
+        }
+
+        const uint8_t* transcode(std::error_code& ec)
+        {
+            return transcode_item(first_, 0, ec);
+        }
+
+    private:
+        const uint8_t* transcode_item(const uint8_t* p, int depth, std::error_code& ec)
+        {
+            if (p == last_)
+            {
+                ec = cbor::cbor_errc::unexpected_eof;
+                return p;
+            }
+            if (JSONCONS_UNLIKELY(depth > max_nesting_depth_))
+            {
+                ec = cbor::cbor_errc::max_nesting_depth_exceeded;
+                return p;
+            }
+
+            const uint8_t* start = p;
+            const auto major_type = static_cast<cbor::detail::cbor_major_type>(*p >> 5);
+            const uint8_t info = *p & 0x1f;
+
+            if (info == cbor::detail::additional_info::indefinite_length)
+            {
+                switch (major_type)
+                {
+                    case cbor::detail::cbor_major_type::array:
+                    case cbor::detail::cbor_major_type::map:
+                        return transcode_indefinite_container(p, major_type, depth, ec);
+                    default: // chunked strings are assembled on the visitor path
+                        return transcode_fallback(start, depth, ec);
+                }
+            }
+
+            uint64_t value = 0;
+            switch (major_type)
+            {
+                case cbor::detail::cbor_major_type::unsigned_integer:
+                    p = cbor::detail::read_argument(p, last_, value, ec);
+                    if (!ec)
+                    {
+                        write_uint64(value);
+                    }
+                    return p;
+                case cbor::detail::cbor_major_type::negative_integer:
+                    p = cbor::detail::read_argument(p, last_, value, ec);
+                    if (ec)
+                    {
+                        return p;
+                    }
+                    if (value > static_cast<uint64_t>((std::numeric_limits<int64_t>::max)()))
+                    {
+                        // Out of int64_t range, becomes a bignum on the visitor path
+                        return transcode_fallback(start, depth, ec);
+                    }
+                    write_int64(-1 - static_cast<int64_t>(value));
+                    return p;
+                case cbor::detail::cbor_major_type::byte_string:
+                case cbor::detail::cbor_major_type::text_string:
+                    p = cbor::detail::read_argument(p, last_, value, ec);
+                    if (ec)
+                    {
+                        return p;
+                    }
+                    if (value > static_cast<uint64_t>(last_ - p))
+                    {
+                        ec = cbor::cbor_errc::unexpected_eof;
+                        return last_;
+                    }
+                    if (value > 0xffffffff)
+                    {
+                        ec = cbor::cbor_errc::number_too_large;
+                        return start;
+                    }
+                    if (major_type == cbor::detail::cbor_major_type::text_string)
+                    {
+                        auto result = unicode_traits::validate(p, static_cast<std::size_t>(value));
+                        if (result.ec != unicode_traits::conv_errc())
+                        {
+                            ec = cbor::cbor_errc::invalid_utf8_text_string;
+                            return p;
+                        }
+                        write_str_header(static_cast<std::size_t>(value));
+                    }
+                    else
+                    {
+                        write_bin_header(static_cast<std::size_t>(value));
+                    }
+                    dest_.insert(dest_.end(), p, p + static_cast<std::size_t>(value));
+                    return p + static_cast<std::size_t>(value);
+                case cbor::detail::cbor_major_type::array:
+                case cbor::detail::cbor_major_type::map:
+                    p = cbor::detail::read_argument(p, last_, value, ec);
+                    if (ec)
+                    {
+                        return p;
+                    }
+                    if (value > 0xffffffff)
+                    {
+                        ec = cbor::cbor_errc::number_too_large;
+                        return start;
+                    }
+                    if (major_type == cbor::detail::cbor_major_type::array)
+                    {
+                        write_array_header(static_cast<std::size_t>(value));
+                    }
+                    else
+                    {
+                        write_map_header(static_cast<std::size_t>(value));
+                        value *= 2;
+                    }
+                    for (uint64_t i = 0; i < value; ++i)
+                    {
+                        p = transcode_item(p, depth+1, ec);
+                        if (ec)
+                        {
+                            return p;
+                        }
+                    }
+                    return p;
+                case cbor::detail::cbor_major_type::simple:
+                    switch (*p)
+                    {
+                        case 0xf4:
+                            dest_.push_back(jsoncons::msgpack::detail::msgpack_format::false_cd);
+                            return p + 1;
+                        case 0xf5:
+                            dest_.push_back(jsoncons::msgpack::detail::msgpack_format::true_cd);
+                            return p + 1;
+                        case 0xf6:
+                            dest_.push_back(jsoncons::msgpack::detail::msgpack_format::nil_cd);
+                            return p + 1;
+                        case 0xfa:
+                            dest_.push_back(jsoncons::msgpack::detail::msgpack_format::float32_cd);
+                            return copy_bytes(p + 1, last_, 4, dest_, cbor::cbor_errc::unexpected_eof, ec);
+                        case 0xfb:
+                            dest_.push_back(jsoncons::msgpack::detail::msgpack_format::float64_cd);
+                            return copy_bytes(p + 1, last_, 8, dest_, cbor::cbor_errc::unexpected_eof, ec);
+                        default: // half precision floats, undefined and other simple values
+                            return transcode_fallback(start, depth, ec);
+                    }
+                default: // semantic tags
+                    return transcode_fallback(start, depth, ec);
+            }
+        }
+
+        const uint8_t* transcode_indefinite_container(const uint8_t* p,
+                                                      cbor::detail::cbor_major_type major_type,
+                                                      int depth, std::error_code& ec)
+        {
+            // MessagePack requires a length up front, count the items first
+            const uint8_t* q = p + 1;
+            std::size_t count = 0;
+            while (true)
+            {
+                if (q == last_)
+                {
+                    ec = cbor::cbor_errc::unexpected_eof;
+                    return q;
+                }
+                if (*q == 0xff)
+                {
+                    break;
+                }
+                q = cbor::detail::skip_item(q, last_, depth+1, max_nesting_depth_, ec);
+                if (ec)
+                {
+                    return q;
+                }
+                ++count;
+            }
+            if (major_type == cbor::detail::cbor_major_type::array)
+            {
+                write_array_header(count);
+            }
+            else
+            {
+                if (count % 2 != 0)
+                {
+                    ec = cbor::cbor_errc::too_few_items;
+                    return q;
+                }
+                write_map_header(count/2);
+            }
+            ++p;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                p = transcode_item(p, depth+1, ec);
+                if (ec)
+                {
+                    return p;
+                }
+            }
+            return p + 1; // break
+        }
+
+        // Transcodes the single item at p through a cbor reader and msgpack encoder
+        const uint8_t* transcode_fallback(const uint8_t* p, int depth, std::error_code& ec)
+        {
+            const uint8_t* end = cbor::detail::skip_item(p, last_, depth, max_nesting_depth_, ec);
+            if (ec)
+            {
+                return end;
+            }
+            basic_msgpack_encoder<jsoncons::bytes_sink<Container>> encoder(dest_);
+            cbor::basic_cbor_reader<jsoncons::bytes_source> reader(
+                jsoncons::span<const uint8_t>(p, static_cast<std::size_t>(end - p)), encoder);
+            reader.read(ec);
+            return ec ? p : end;
+        }
+
+        void write_uint64(uint64_t val)
+        {
+            if (val <= 0x7f)
+            {
+                dest_.push_back(static_cast<uint8_t>(val));
+            }
+            else if (val <= (std::numeric_limits<uint8_t>::max)())
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::uint8_cd);
+                write_be(val, 1, dest_);
+            }
+            else if (val <= (std::numeric_limits<uint16_t>::max)())
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::uint16_cd);
+                write_be(val, 2, dest_);
+            }
+            else if (val <= (std::numeric_limits<uint32_t>::max)())
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::uint32_cd);
+                write_be(val, 4, dest_);
+            }
+            else
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::uint64_cd);
+                write_be(val, 8, dest_);
+            }
+        }
+
+        // val is negative
+        void write_int64(int64_t val)
+        {
+            if (val >= -32)
+            {
+                dest_.push_back(static_cast<uint8_t>(val));
+            }
+            else if (val >= (std::numeric_limits<int8_t>::lowest)())
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::int8_cd);
+                write_be(static_cast<uint64_t>(val), 1, dest_);
+            }
+            else if (val >= (std::numeric_limits<int16_t>::lowest)())
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::int16_cd);
+                write_be(static_cast<uint64_t>(val), 2, dest_);
+            }
+            else if (val >= (std::numeric_limits<int32_t>::lowest)())
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::int32_cd);
+                write_be(static_cast<uint64_t>(val), 4, dest_);
+            }
+            else
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::int64_cd);
+                write_be(static_cast<uint64_t>(val), 8, dest_);
+            }
+        }
+
+        void write_str_header(std::size_t length)
+        {
+            if (length <= 31)
+            {
+                dest_.push_back(static_cast<uint8_t>(jsoncons::msgpack::detail::msgpack_format::fixstr_base_cd | length));
+            }
+            else if (length <= (std::numeric_limits<uint8_t>::max)())
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::str8_cd);
+                write_be(length, 1, dest_);
+            }
+            else if (length <= (std::numeric_limits<uint16_t>::max)())
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::str16_cd);
+                write_be(length, 2, dest_);
+            }
+            else
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::str32_cd);
+                write_be(length, 4, dest_);
+            }
+        }
+
+        void write_bin_header(std::size_t length)
+        {
+            if (length <= (std::numeric_limits<uint8_t>::max)())
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::bin8_cd);
+                write_be(length, 1, dest_);
+            }
+            else if (length <= (std::numeric_limits<uint16_t>::max)())
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::bin16_cd);
+                write_be(length, 2, dest_);
+            }
+            else
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::bin32_cd);
+                write_be(length, 4, dest_);
+            }
+        }
+
+        void write_array_header(std::size_t length)
+        {
+            if (length <= 15)
+            {
+                dest_.push_back(static_cast<uint8_t>(jsoncons::msgpack::detail::msgpack_format::fixarray_base_cd | length));
+            }
+            else if (length <= (std::numeric_limits<uint16_t>::max)())
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::array16_cd);
+                write_be(length, 2, dest_);
+            }
+            else
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::array32_cd);
+                write_be(length, 4, dest_);
+            }
+        }
+
+        void write_map_header(std::size_t length)
+        {
+            if (length <= 15)
+            {
+                dest_.push_back(static_cast<uint8_t>(jsoncons::msgpack::detail::msgpack_format::fixmap_base_cd | length));
+            }
+            else if (length <= (std::numeric_limits<uint16_t>::max)())
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::map16_cd);
+                write_be(length, 2, dest_);
+            }
+            else
+            {
+                dest_.push_back(jsoncons::msgpack::detail::msgpack_format::map32_cd);
+                write_be(length, 4, dest_);
+            }
+        }
+    };
+
+    // MessagePack to CBOR
+
+    template <class Container>
+    class msgpack_to_cbor_transcoder
+    {
+        const uint8_t* first_;
+        const uint8_t* last_;
+        Container& dest_;
+        int max_nesting_depth_;
+    public:
+        msgpack_to_cbor_transcoder(const uint8_t* first, const uint8_t* last,
+                                   Container& dest, int max_nesting_depth)
+            : first_(first), last_(last), dest_(dest), max_nesting_depth_(max_nesting_depth)
+        {
+        }
+
+        const uint8_t* transcode(std::error_code& ec)
+        {
+            return transcode_item(first_, 0, ec);
+        }
+
+    private:
+        const uint8_t* read_length(const uint8_t* p, std::size_t n,
+                                   std::size_t& length, std::error_code& ec)
+        {
+            if (static_cast<std::size_t>(last_ - p) < n)
+            {
+                ec = msgpack_errc::unexpected_eof;
+                return last_;
+            }
+            length = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                length = (length << 8) | p[i];
+            }
+            return p + n;
+        }
+
+        const uint8_t* transcode_item(const uint8_t* p, int depth, std::error_code& ec)
+        {
+            if (p == last_)
+            {
+                ec = msgpack_errc::unexpected_eof;
+                return p;
+            }
+            if (JSONCONS_UNLIKELY(depth > max_nesting_depth_))
+            {
+                ec = msgpack_errc::max_nesting_depth_exceeded;
+                return p;
+            }
+
+            const uint8_t* start = p;
+            const uint8_t type = *p++;
+            std::size_t length = 0;
+
+            if (type <= 0xbf)
+            {
+                if (type <= 0x7f)
+                {
+                    // positive fixint
+                    write_header(cbor::detail::cbor_major_type::unsigned_integer, type);
+                    return p;
+                }
+                else if (type <= 0x8f)
+                {
+                    // fixmap
+                    return transcode_map(p, type & 0x0f, depth, ec);
+                }
+                else if (type <= 0x9f)
+                {
+                    // fixarray
+                    return transcode_array(p, type & 0x0f, depth, ec);
+                }
+                else
+                {
+                    // fixstr
+                    return transcode_str(p, type & 0x1f, ec);
+                }
+            }
+            else if (type >= jsoncons::msgpack::detail::msgpack_format::negative_fixint_base_cd)
+            {
+                write_header(cbor::detail::cbor_major_type::negative_integer,
+                             static_cast<uint64_t>(-1 - static_cast<int64_t>(static_cast<int8_t>(type))));
+                return p;
+            }
+
+            switch (type)
+            {
+                case jsoncons::msgpack::detail::msgpack_format::nil_cd:
+                    dest_.push_back(0xf6);
+                    return p;
+                case jsoncons::msgpack::detail::msgpack_format::false_cd:
+                    dest_.push_back(0xf4);
+                    return p;
+                case jsoncons::msgpack::detail::msgpack_format::true_cd:
+                    dest_.push_back(0xf5);
+                    return p;
+                case jsoncons::msgpack::detail::msgpack_format::float32_cd:
+                    dest_.push_back(0xfa);
+                    return copy_bytes(p, last_, 4, dest_, msgpack_errc::unexpected_eof, ec);
+                case jsoncons::msgpack::detail::msgpack_format::float64_cd:
+                    dest_.push_back(0xfb);
+                    return copy_bytes(p, last_, 8, dest_, msgpack_errc::unexpected_eof, ec);
+                case jsoncons::msgpack::detail::msgpack_format::uint8_cd:
+                    return transcode_uint(p, 1, ec);
+                case jsoncons::msgpack::detail::msgpack_format::uint16_cd:
+                    return transcode_uint(p, 2, ec);
+                case jsoncons::msgpack::detail::msgpack_format::uint32_cd:
+                    return transcode_uint(p, 4, ec);
+                case jsoncons::msgpack::detail::msgpack_format::uint64_cd:
+                    return transcode_uint(p, 8, ec);
+                case jsoncons::msgpack::detail::msgpack_format::int8_cd:
+                    return transcode_int(p, 1, ec);
+                case jsoncons::msgpack::detail::msgpack_format::int16_cd:
+                    return transcode_int(p, 2, ec);
+                case jsoncons::msgpack::detail::msgpack_format::int32_cd:
+                    return transcode_int(p, 4, ec);
+                case jsoncons::msgpack::detail::msgpack_format::int64_cd:
+                    return transcode_int(p, 8, ec);
+                case jsoncons::msgpack::detail::msgpack_format::str8_cd:
+                    p = read_length(p, 1, length, ec);
+                    return ec ? p : transcode_str(p, length, ec);
+                case jsoncons::msgpack::detail::msgpack_format::str16_cd:
+                    p = read_length(p, 2, length, ec);
+                    return ec ? p : transcode_str(p, length, ec);
+                case jsoncons::msgpack::detail::msgpack_format::str32_cd:
+                    p = read_length(p, 4, length, ec);
+                    return ec ? p : transcode_str(p, length, ec);
+                case jsoncons::msgpack::detail::msgpack_format::bin8_cd:
+                    p = read_length(p, 1, length, ec);
+                    return ec ? p : transcode_bin(p, length, ec);
+                case jsoncons::msgpack::detail::msgpack_format::bin16_cd:
+                    p = read_length(p, 2, length, ec);
+                    return ec ? p : transcode_bin(p, length, ec);
+                case jsoncons::msgpack::detail::msgpack_format::bin32_cd:
+                    p = read_length(p, 4, length, ec);
+                    return ec ? p : transcode_bin(p, length, ec);
+                case jsoncons::msgpack::detail::msgpack_format::array16_cd:
+                    p = read_length(p, 2, length, ec);
+                    return ec ? p : transcode_array(p, length, depth, ec);
+                case jsoncons::msgpack::detail::msgpack_format::array32_cd:
+                    p = read_length(p, 4, length, ec);
+                    return ec ? p : transcode_array(p, length, depth, ec);
+                case jsoncons::msgpack::detail::msgpack_format::map16_cd:
+                    p = read_length(p, 2, length, ec);
+                    return ec ? p : transcode_map(p, length, depth, ec);
+                case jsoncons::msgpack::detail::msgpack_format::map32_cd:
+                    p = read_length(p, 4, length, ec);
+                    return ec ? p : transcode_map(p, length, depth, ec);
+                case jsoncons::msgpack::detail::msgpack_format::fixext1_cd:
+                    return transcode_fallback(start, p, 1, ec);
+                case jsoncons::msgpack::detail::msgpack_format::fixext2_cd:
+                    return transcode_fallback(start, p, 2, ec);
+                case jsoncons::msgpack::detail::msgpack_format::fixext4_cd:
+                    return transcode_fallback(start, p, 4, ec);
+                case jsoncons::msgpack::detail::msgpack_format::fixext8_cd:
+                    return transcode_fallback(start, p, 8, ec);
+                case jsoncons::msgpack::detail::msgpack_format::fixext16_cd:
+                    return transcode_fallback(start, p, 16, ec);
+                case jsoncons::msgpack::detail::msgpack_format::ext8_cd:
+                    p = read_length(p, 1, length, ec);
+                    return ec ? p : transcode_fallback(start, p, length, ec);
+                case jsoncons::msgpack::detail::msgpack_format::ext16_cd:
+                    p = read_length(p, 2, length, ec);
+                    return ec ? p : transcode_fallback(start, p, length, ec);
+                case jsoncons::msgpack::detail::msgpack_format::ext32_cd:
+                    p = read_length(p, 4, length, ec);
+                    return ec ? p : transcode_fallback(start, p, length, ec);
+                default:
+                    ec = msgpack_errc::unknown_type;
+                    return start;
+            }
+        }
+
+        const uint8_t* transcode_uint(const uint8_t* p, std::size_t n, std::error_code& ec)
+        {
+            uint64_t val = 0;
+            if (static_cast<std::size_t>(last_ - p) < n)
+            {
+                ec = msgpack_errc::unexpected_eof;
+                return last_;
+            }
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                val = (val << 8) | p[i];
+            }
+            write_header(cbor::detail::cbor_major_type::unsigned_integer, val);
+            return p + n;
+        }
+
+        const uint8_t* transcode_int(const uint8_t* p, std::size_t n, std::error_code& ec)
+        {
+            if (static_cast<std::size_t>(last_ - p) < n)
+            {
+                ec = msgpack_errc::unexpected_eof;
+                return last_;
+            }
+            // Sign extend the n byte two's complement value
+            uint64_t bits = (p[0] & 0x80) ? (std::numeric_limits<uint64_t>::max)() : 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                bits = (bits << 8) | p[i];
+            }
+            int64_t val = static_cast<int64_t>(bits);
+            if (val >= 0)
+            {
+                write_header(cbor::detail::cbor_major_type::unsigned_integer, static_cast<uint64_t>(val));
+            }
+            else
+            {
+                write_header(cbor::detail::cbor_major_type::negative_integer, static_cast<uint64_t>(-1 - val));
+            }
+            return p + n;
+        }
+
+        const uint8_t* transcode_str(const uint8_t* p, std::size_t length, std::error_code& ec)
+        {
+            if (static_cast<std::size_t>(last_ - p) < length)
+            {
+                ec = msgpack_errc::unexpected_eof;
+                return last_;
+            }
+            auto result = unicode_traits::validate(p, length);
+            if (result.ec != unicode_traits::conv_errc())
+            {
+                ec = msgpack_errc::invalid_utf8_text_string;
+                return p;
+            }
+            write_header(cbor::detail::cbor_major_type::text_string, length);
+            dest_.insert(dest_.end(), p, p + length);
+            return p + length;
+        }
+
+        const uint8_t* transcode_bin(const uint8_t* p, std::size_t length, std::error_code& ec)
+        {
+            if (static_cast<std::size_t>(last_ - p) < length)
+            {
+                ec = msgpack_errc::unexpected_eof;
+                return last_;
+            }
+            write_header(cbor::detail::cbor_major_type::byte_string, length);
+            dest_.insert(dest_.end(), p, p + length);
+            return p + length;
+        }
+
+        const uint8_t* transcode_array(const uint8_t* p, std::size_t length, int depth, std::error_code& ec)
+        {
+            write_header(cbor::detail::cbor_major_type::array, length);
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                p = transcode_item(p, depth+1, ec);
+                if (ec)
+                {
+                    return p;
+                }
+            }
+            return p;
+        }
+
+        const uint8_t* transcode_map(const uint8_t* p, std::size_t length, int depth, std::error_code& ec)
+        {
+            write_header(cbor::detail::cbor_major_type::map, length);
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                p = transcode_item(p, depth+1, ec);
+                if (ec)
+                {
+                    return p;
+                }
+                p = transcode_item(p, depth+1, ec);
+                if (ec)
+                {
+                    return p;
+                }
+            }
+            return p;
+        }
+
+        // Transcodes the ext at start, whose payload of length bytes follows
+        // the ext type at p, through a msgpack reader and cbor encoder
+        const uint8_t* transcode_fallback(const uint8_t* start, const uint8_t* p, std::size_t length, std::error_code& ec)
+        {
+            if (static_cast<std::size_t>(last_ - p) < length || static_cast<std::size_t>(last_ - p) - length < 1)
+            {
+                ec = msgpack_errc::unexpected_eof;
+                return last_;
+            }
+            const uint8_t* end = p + 1 + length;
+            cbor::basic_cbor_encoder<jsoncons::bytes_sink<Container>> encoder(dest_);
+            basic_msgpack_reader<jsoncons::bytes_source> reader(
+                jsoncons::span<const uint8_t>(start, static_cast<std::size_t>(end - start)), encoder);
+            reader.read(ec);
+            return ec ? start : end;
+        }
+
+        void write_header(cbor::detail::cbor_major_type major_type, uint64_t value)
+        {
+            const uint8_t mt = static_cast<uint8_t>(static_cast<uint8_t>(major_type) << 5);
+            if (value <= 0x17)
+            {
+                dest_.push_back(static_cast<uint8_t>(mt | value));
+            }
+            else if (value <= (std::numeric_limits<uint8_t>::max)())
+            {
+                dest_.push_back(static_cast<uint8_t>(mt | 0x18));
+                write_be(value, 1, dest_);
+            }
+            else if (value <= (std::numeric_limits<uint16_t>::max)())
+            {
+                dest_.push_back(static_cast<uint8_t>(mt | 0x19));
+                write_be(value, 2, dest_);
+            }
+            else if (value <= (std::numeric_limits<uint32_t>::max)())
+            {
+                dest_.push_back(static_cast<uint8_t>(mt | 0x1a));
+                write_be(value, 4, dest_);
+            }
+            else
+            {
+                dest_.push_back(static_cast<uint8_t>(mt | 0x1b));
+                write_be(value, 8, dest_);
+            }
+        }
+    };
+
+    // Transcodes the one item in [first,last) and appends it to dest. If the item is
+    // malformed, or followed by more data, sets ec and restores dest to its size before
+    // the call. Returns the offset of the error.
+    template <class Transcoder,class Container>
+    std::size_t transcode_single_item(const uint8_t* first, const uint8_t* last, Container& dest,
+                                      int max_nesting_depth, std::error_code trailing_data, std::error_code& ec)
+    {
+        const std::size_t size = dest.size();
+        Transcoder transcoder(first, last, dest, max_nesting_depth);
+        const uint8_t* p = transcoder.transcode(ec);
+        if (!ec && p != last)
+        {
+            ec = trailing_data;
+        }
+        if (ec)
+        {
+            dest.resize(size);
+        }
+        return static_cast<std::size_t>(p - first);
+    }
+
+} // namespace detail
+
+// Transcodes a single CBOR data item directly to MessagePack, without
+// going through an intermediate basic_json or the json_visitor interface.
+// Tagged items, chunked strings, half precision floats and other items
+// with no direct MessagePack equivalent are transcoded on the visitor path.
+
+template <class Source,class Container>
+typename std::enable_if<type_traits::is_byte_sequence<Source>::value &&
+                        type_traits::is_back_insertable_byte_container<Container>::value,void>::type
+cbor_to_msgpack(const Source& source, Container& dest,
+                const cbor::cbor_decode_options& options, std::error_code& ec)
+{
+    const uint8_t* first = reinterpret_cast<const uint8_t*>(source.data());
+    const uint8_t* last = first + source.size();
+    detail::transcode_single_item<detail::cbor_to_msgpack_transcoder<Container>>(first, last, dest, options.max_nesting_depth(),
+                                                          cbor::cbor_errc::trailing_data, ec);
+}
+
+template <class Source,class Container>
+typename std::enable_if<type_traits::is_byte_sequence<Source>::value &&
+                        type_traits::is_back_insertable_byte_container<Container>::value,void>::type
+cbor_to_msgpack(const Source& source, Container& dest, std::error_code& ec)
+{
+    cbor_to_msgpack(source, dest, cbor::cbor_decode_options(), ec);
+}
+
+template <class Source,class Container>
+typename std::enable_if<type_traits::is_byte_sequence<Source>::value &&
+                        type_traits::is_back_insertable_byte_container<Container>::value,void>::type
+cbor_to_msgpack(const Source& source, Container& dest,
+                const cbor::cbor_decode_options& options = cbor::cbor_decode_options())
+{
+    const uint8_t* first = reinterpret_cast<const uint8_t*>(source.data());
+    const uint8_t* last = first + source.size();
+    std::error_code ec;
+    std::size_t position = detail::transcode_single_item<detail::cbor_to_msgpack_transcoder<Container>>(first, last, dest, options.max_nesting_depth(),
+                                                                                 cbor::cbor_errc::trailing_data, ec);
+    if (ec)
+    {
+        JSONCONS_THROW(ser_error(ec, 0, position));
+    }
+}
+
+// Transcodes a single MessagePack object directly to CBOR. ext types,
+// including timestamps, are transcoded on the visitor path.
+
+template <class Source,class Container>
+typename std::enable_if<type_traits::is_byte_sequence<Source>::value &&
+                        type_traits::is_back_insertable_byte_container<Container>::value,void>::type
+msgpack_to_cbor(const Source& source, Container& dest,
+                const msgpack_decode_options& options, std::error_code& ec)
+{
+    const uint8_t* first = reinterpret_cast<const uint8_t*>(source.data());
+    const uint8_t* last = first + source.size();
+    detail::transcode_single_item<detail::msgpack_to_cbor_transcoder<Container>>(first, last, dest, options.max_nesting_depth(),
+                                                          msgpack_errc::trailing_data, ec);
+}
+
+template <class Source,class Container>
+typename std::enable_if<type_traits::is_byte_sequence<Source>::value &&
+                        type_traits::is_back_insertable_byte_container<Container>::value,void>::type
+msgpack_to_cbor(const Source& source, Container& dest, std::error_code& ec)
+{
+    msgpack_to_cbor(source, dest, msgpack_decode_options(), ec);
+}
+
+template <class Source,class Container>
+typename std::enable_if<type_traits::is_byte_sequence<Source>::value &&
+                        type_traits::is_back_insertable_byte_container<Container>::value,void>::type
+msgpack_to_cbor(const Source& source, Container& dest,
+                const msgpack_decode_options& options = msgpack_decode_options())
+{
+    const uint8_t* first = reinterpret_cast<const uint8_t*>(source.data());
+    const uint8_t* last = first + source.size();
+    std::error_code ec;
+    std::size_t position = detail::transcode_single_item<detail::msgpack_to_cbor_transcoder<Container>>(first, last, dest, options.max_nesting_depth(),
+                                                                                 msgpack_errc::trailing_data, ec);
+    if (ec)
+    {
+        JSONCONS_THROW(ser_error(ec, 0, position));
+    }
+}
+
+}}
+
+#endif
@@ -25,7 +25,9 @@ enum class msgpack_errc
     max_nesting_depth_exceeded,
     length_is_negative,
     invalid_timestamp,
-    unknown_type
+    unknown_type,
+    invalid_offsets,
+    trailing_data
 };
 
 class msgpack_error_category_impl
@@ -62,6 +64,10 @@ public:
                 return "Invalid timestamp";
             case msgpack_errc::unknown_type:
                 return "An unknown type was found in the stream";
+            case msgpack_errc::invalid_offsets:
+                return "Saved offsets are not strictly increasing or not within the buffer";
+            case msgpack_errc::trailing_data:
+                return "Unexpected data after the MessagePack object";
             default:
                 return "Unknown MessagePack parser error";
         }
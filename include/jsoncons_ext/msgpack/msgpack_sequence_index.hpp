@@ -0,0 +1,313 @@
+// Copyright 2020 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_MSGPACK_MSGPACK_SEQUENCE_INDEX_HPP
+#define JSONCONS_MSGPACK_MSGPACK_SEQUENCE_INDEX_HPP
+
+#include <vector>
+#include <utility> // std::move
+#include <type_traits> // std::enable_if
+#include <system_error>
+#include <jsoncons/config/jsoncons_config.hpp>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/more_type_traits.hpp>
+#include <jsoncons_ext/msgpack/msgpack_detail.hpp>
+#include <jsoncons_ext/msgpack/msgpack_error.hpp>
+#include <jsoncons_ext/msgpack/msgpack_options.hpp>
+
+namespace jsoncons { namespace msgpack {
+
+// An index of the byte offsets of the objects in a buffer holding a sequence
+// of concatenated MessagePack objects. The index is built in one pass that
+// reads only headers and skips over str, bin and ext payloads, and is intended
+// to be used with a memory mapped file or another contiguous buffer that
+// outlives it.
+class msgpack_sequence_index
+{
+    const uint8_t* data_;
+    std::size_t length_;
+    std::vector<std::size_t> offsets_;
+public:
+    template <class Source>
+    msgpack_sequence_index(const Source& source,
+                           const msgpack_decode_options& options = msgpack_decode_options(),
+                           typename std::enable_if<type_traits::is_byte_sequence<Source>::value,int>::type = 0)
+        : data_(reinterpret_cast<const uint8_t*>(source.data())), length_(source.size())
+    {
+        std::error_code ec;
+        std::size_t position = build(options, ec);
+        if (ec)
+        {
+            JSONCONS_THROW(ser_error(ec, 0, position));
+        }
+    }
+
+    template <class Source>
+    msgpack_sequence_index(const Source& source,
+                           const msgpack_decode_options& options,
+                           std::error_code& ec,
+                           typename std::enable_if<type_traits::is_byte_sequence<Source>::value,int>::type = 0)
+        : data_(reinterpret_cast<const uint8_t*>(source.data())), length_(source.size())
+    {
+        build(options, ec);
+    }
+
+    // Restores an index from previously saved offsets, which must be strictly
+    // increasing and less than the length of the buffer
+    template <class Source>
+    msgpack_sequence_index(const Source& source,
+                           std::vector<std::size_t> offsets,
+                           typename std::enable_if<type_traits::is_byte_sequence<Source>::value,int>::type = 0)
+        : data_(reinterpret_cast<const uint8_t*>(source.data())), length_(source.size()),
+          offsets_(std::move(offsets))
+    {
+        std::error_code ec;
+        std::size_t position = check_offsets(ec);
+        if (ec)
+        {
+            JSONCONS_THROW(ser_error(ec, 0, position));
+        }
+    }
+
+    template <class Source>
+    msgpack_sequence_index(const Source& source,
+                           std::vector<std::size_t> offsets,
+                           std::error_code& ec,
+                           typename std::enable_if<type_traits::is_byte_sequence<Source>::value,int>::type = 0)
+        : data_(reinterpret_cast<const uint8_t*>(source.data())), length_(source.size()),
+          offsets_(std::move(offsets))
+    {
+        check_offsets(ec);
+    }
+
+    // The index points into source, so a temporary would leave it dangling
+    template <class Source,class... Args,
+              class=typename std::enable_if<!std::is_lvalue_reference<Source>::value && type_traits::is_byte_sequence<Source>::value>::type>
+    msgpack_sequence_index(Source&& source, Args&&... args) = delete;
+
+    std::size_t size() const
+    {
+        return offsets_.size();
+    }
+
+    const std::vector<std::size_t>& offsets() const
+    {
+        return offsets_;
+    }
+
+    std::size_t offset(std::size_t i) const
+    {
+        return offsets_.at(i);
+    }
+
+    // Returns the bytes of the i-th object, suitable as a source for decode_msgpack
+    // or msgpack_bytes_cursor
+    jsoncons::span<const uint8_t> item(std::size_t i) const
+    {
+        std::size_t first = offsets_.at(i);
+        std::size_t last = i+1 < offsets_.size() ? offsets_[i+1] : length_;
+        return jsoncons::span<const uint8_t>(data_ + first, last - first);
+    }
+
+private:
+    // Returns the first offset that is out of order or out of range
+    std::size_t check_offsets(std::error_code& ec)
+    {
+        for (std::size_t i = 0; i < offsets_.size(); ++i)
+        {
+            if (offsets_[i] >= length_ || (i > 0 && offsets_[i] <= offsets_[i-1]))
+            {
+                std::size_t position = offsets_[i];
+                ec = msgpack_errc::invalid_offsets;
+                offsets_.clear();
+                return position;
+            }
+        }
+        return 0;
+    }
+
+    std::size_t build(const msgpack_decode_options& options, std::error_code& ec)
+    {
+        const uint8_t* p = data_;
+        const uint8_t* last = data_ + length_;
+        while (p != last)
+        {
+            const uint8_t* start = p;
+            p = skip_item(p, last, 0, options.max_nesting_depth(), ec);
+            if (ec)
+            {
+                offsets_.clear();
+                return static_cast<std::size_t>(p - data_);
+            }
+            offsets_.push_back(static_cast<std::size_t>(start - data_));
+        }
+        return length_;
+    }
+
+    // Reads a big endian length of n bytes at p
+    static const uint8_t* read_length(const uint8_t* p, const uint8_t* last, std::size_t n,
+                                      std::size_t& length, std::error_code& ec)
+    {
+        if (static_cast<std::size_t>(last - p) < n)
+        {
+            ec = msgpack_errc::unexpected_eof;
+            return last;
+        }
+        length = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            length = (length << 8) | p[i];
+        }
+        return p + n;
+    }
+
+    static const uint8_t* skip_bytes(const uint8_t* p, const uint8_t* last, std::size_t n,
+                                     std::error_code& ec)
+    {
+        if (static_cast<std::size_t>(last - p) < n)
+        {
+            ec = msgpack_errc::unexpected_eof;
+            return last;
+        }
+        return p + n;
+    }
+
+    // Skips count array elements, or count key-value pairs when items_per_entry is 2 
+    static const uint8_t* skip_items(const uint8_t* p, const uint8_t* last, std::size_t count, std::size_t items_per_entry,
+                                     int depth, int max_nesting_depth, std::error_code& ec)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            for (std::size_t j = 0; j < items_per_entry; ++j)
+            {
+                p = skip_item(p, last, depth, max_nesting_depth, ec);
+                if (ec)
+                {
+                    return p;
+                }
+            }
+        }
+        return p;
+    }
+
+    static const uint8_t* skip_item(const uint8_t* p, const uint8_t* last,
+                                    int depth, int max_nesting_depth, std::error_code& ec)
+    {
+        if (p == last)
+        {
+            ec = msgpack_errc::unexpected_eof;
+            return p;
+        }
+        if (JSONCONS_UNLIKELY(depth > max_nesting_depth))
+        {
+            ec = msgpack_errc::max_nesting_depth_exceeded;
+            return p;
+        }
+
+        const uint8_t type = *p++;
+        std::size_t length = 0;
+
+        if (type <= 0xbf)
+        {
+            if (type <= 0x7f)
+            {
+                // positive fixint
+                return p;
+            }
+            else if (type <= 0x8f)
+            {
+                // fixmap
+                return skip_items(p, last, type & 0x0f, 2, depth+1, max_nesting_depth, ec);
+            }
+            else if (type <= 0x9f)
+            {
+                // fixarray
+                return skip_items(p, last, type & 0x0f, 1, depth+1, max_nesting_depth, ec);
+            }
+            else
+            {
+                // fixstr
+                return skip_bytes(p, last, type & 0x1f, ec);
+            }
+        }
+        else if (type >= jsoncons::msgpack::detail::msgpack_format::negative_fixint_base_cd)
+        {
+            return p;
+        }
+
+        switch (type)
+        {
+            case jsoncons::msgpack::detail::msgpack_format::nil_cd:
+            case jsoncons::msgpack::detail::msgpack_format::false_cd:
+            case jsoncons::msgpack::detail::msgpack_format::true_cd:
+                return p;
+            case jsoncons::msgpack::detail::msgpack_format::uint8_cd:
+            case jsoncons::msgpack::detail::msgpack_format::int8_cd:
+                return skip_bytes(p, last, 1, ec);
+            case jsoncons::msgpack::detail::msgpack_format::uint16_cd:
+            case jsoncons::msgpack::detail::msgpack_format::int16_cd:
+                return skip_bytes(p, last, 2, ec);
+            case jsoncons::msgpack::detail::msgpack_format::uint32_cd:
+            case jsoncons::msgpack::detail::msgpack_format::int32_cd:
+            case jsoncons::msgpack::detail::msgpack_format::float32_cd:
+                return skip_bytes(p, last, 4, ec);
+            case jsoncons::msgpack::detail::msgpack_format::uint64_cd:
+            case jsoncons::msgpack::detail::msgpack_format::int64_cd:
+            case jsoncons::msgpack::detail::msgpack_format::float64_cd:
+                return skip_bytes(p, last, 8, ec);
+            case jsoncons::msgpack::detail::msgpack_format::fixext1_cd:
+                return skip_bytes(p, last, 1+1, ec);
+            case jsoncons::msgpack::detail::msgpack_format::fixext2_cd:
+                return skip_bytes(p, last, 1+2, ec);
+            case jsoncons::msgpack::detail::msgpack_format::fixext4_cd:
+                return skip_bytes(p, last, 1+4, ec);
+            case jsoncons::msgpack::detail::msgpack_format::fixext8_cd:
+                return skip_bytes(p, last, 1+8, ec);
+            case jsoncons::msgpack::detail::msgpack_format::fixext16_cd:
+                return skip_bytes(p, last, 1+16, ec);
+            case jsoncons::msgpack::detail::msgpack_format::str8_cd:
+            case jsoncons::msgpack::detail::msgpack_format::bin8_cd:
+                p = read_length(p, last, 1, length, ec);
+                return ec ? p : skip_bytes(p, last, length, ec);
+            case jsoncons::msgpack::detail::msgpack_format::str16_cd:
+            case jsoncons::msgpack::detail::msgpack_format::bin16_cd:
+                p = read_length(p, last, 2, length, ec);
+                return ec ? p : skip_bytes(p, last, length, ec);
+            case jsoncons::msgpack::detail::msgpack_format::str32_cd:
+            case jsoncons::msgpack::detail::msgpack_format::bin32_cd:
+                p = read_length(p, last, 4, length, ec);
+                return ec ? p : skip_bytes(p, last, length, ec);
+            case jsoncons::msgpack::detail::msgpack_format::ext8_cd:
+                p = read_length(p, last, 1, length, ec);
+                return ec ? p : skip_bytes(p, last, 1+length, ec);
+            case jsoncons::msgpack::detail::msgpack_format::ext16_cd:
+                p = read_length(p, last, 2, length, ec);
+                return ec ? p : skip_bytes(p, last, 1+length, ec);
+            case jsoncons::msgpack::detail::msgpack_format::ext32_cd:
+                p = read_length(p, last, 4, length, ec);
+                return ec ? p : skip_bytes(p, last, 1+length, ec);
+            case jsoncons::msgpack::detail::msgpack_format::array16_cd:
+                p = read_length(p, last, 2, length, ec);
+                return ec ? p : skip_items(p, last, length, 1, depth+1, max_nesting_depth, ec);
+            case jsoncons::msgpack::detail::msgpack_format::array32_cd:
+                p = read_length(p, last, 4, length, ec);
+                return ec ? p : skip_items(p, last, length, 1, depth+1, max_nesting_depth, ec);
+            case jsoncons::msgpack::detail::msgpack_format::map16_cd:
+                p = read_length(p, last, 2, length, ec);
+                return ec ? p : skip_items(p, last, length, 2, depth+1, max_nesting_depth, ec);
+            case jsoncons::msgpack::detail::msgpack_format::map32_cd:
+                p = read_length(p, last, 4, length, ec);
+                return ec ? p : skip_items(p, last, length, 2, depth+1, max_nesting_depth, ec);
+            default:
+                ec = msgpack_errc::unknown_type;
+                return p - 1;
+        }
+    }
+};
+
+}}
+
+#endif
@@ -101,6 +101,11 @@ public:
         return parser_.done();
     }
 
+    bool is_typed_array() const
+    {
+        return cursor_visitor_.is_typed_array();
+    }
+
     const staj_event& current() const override
     {
         return cursor_visitor_.event();
@@ -119,7 +124,7 @@ public:
     void read_to(basic_json_visitor<char_type>& visitor,
                 std::error_code& ec) override
     {
-        if (staj_to_saj_event(cursor_visitor_.event(), visitor, *this, ec))
+        if (cursor_visitor_.dump(visitor, *this, ec))
         {
             read_next(visitor, ec);
         }
@@ -232,11 +237,18 @@ private:
 
     void read_next(std::error_code& ec)
     {
-        parser_.restart();
-        while (!parser_.stopped())
+        if (cursor_visitor_.in_available())
         {
-            parser_.parse(cursor_visitor_, ec);
-            if (ec) return;
+            cursor_visitor_.send_available(ec);
+        }
+        else
+        {
+            parser_.restart();
+            while (!parser_.stopped())
+            {
+                parser_.parse(cursor_visitor_, ec);
+                if (ec) return;
+            }
         }
     }
 
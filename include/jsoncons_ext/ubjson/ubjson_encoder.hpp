@@ -461,6 +461,238 @@ private:
         return true;
     }
 
+    bool visit_typed_array(const jsoncons::span<const uint8_t>& data, 
+                           semantic_tag,
+                           const ser_context&, 
+                           std::error_code& ec) override
+    {
+        return write_integer_typed_array(data, ec);
+    }
+
+    bool visit_typed_array(const jsoncons::span<const uint16_t>& data, 
+                           semantic_tag,
+                           const ser_context&, 
+                           std::error_code& ec) override
+    {
+        return write_integer_typed_array(data, ec);
+    }
+
+    bool visit_typed_array(const jsoncons::span<const uint32_t>& data, 
+                           semantic_tag,
+                           const ser_context&, 
+                           std::error_code& ec) override
+    {
+        return write_integer_typed_array(data, ec);
+    }
+
+    bool visit_typed_array(const jsoncons::span<const uint64_t>& data, 
+                           semantic_tag tag,
+                           const ser_context& context, 
+                           std::error_code& ec) override
+    {
+        for (auto val : data)
+        {
+            if (val > static_cast<uint64_t>((std::numeric_limits<int64_t>::max)()))
+            {
+                bool more = this->begin_array(data.size(), tag, context, ec);
+                for (auto p = data.begin(); more && p != data.end(); ++p)
+                {
+                    more = this->uint64_value(*p, semantic_tag::none, context, ec);
+                }
+                if (more)
+                {
+                    more = this->end_array(context, ec);
+                }
+                return more;
+            }
+        }
+        return write_integer_typed_array(data, ec);
+    }
+
+    bool visit_typed_array(const jsoncons::span<const int8_t>& data, 
+                           semantic_tag,
+                           const ser_context&, 
+                           std::error_code& ec) override
+    {
+        return write_integer_typed_array(data, ec);
+    }
+
+    bool visit_typed_array(const jsoncons::span<const int16_t>& data, 
+                           semantic_tag,
+                           const ser_context&, 
+                           std::error_code& ec) override
+    {
+        return write_integer_typed_array(data, ec);
+    }
+
+    bool visit_typed_array(const jsoncons::span<const int32_t>& data, 
+                           semantic_tag,
+                           const ser_context&, 
+                           std::error_code& ec) override
+    {
+        return write_integer_typed_array(data, ec);
+    }
+
+    bool visit_typed_array(const jsoncons::span<const int64_t>& data, 
+                           semantic_tag,
+                           const ser_context&, 
+                           std::error_code& ec) override
+    {
+        return write_integer_typed_array(data, ec);
+    }
+
+    bool visit_typed_array(const jsoncons::span<const float>& data, 
+                           semantic_tag,
+                           const ser_context&, 
+                           std::error_code& ec) override
+    {
+        if (!begin_typed_array(jsoncons::ubjson::detail::ubjson_format::float32_type, data.size(), ec))
+        {
+            return false;
+        }
+        for (auto val : data)
+        {
+            binary::native_to_big(val,std::back_inserter(sink_));
+        }
+        end_value();
+        return true;
+    }
+
+    bool visit_typed_array(const jsoncons::span<const double>& data, 
+                           semantic_tag,
+                           const ser_context&, 
+                           std::error_code& ec) override
+    {
+        bool is_float32 = true;
+        for (auto val : data)
+        {
+            if ((double)(float)val != val)
+            {
+                is_float32 = false;
+                break;
+            }
+        }
+        if (is_float32)
+        {
+            if (!begin_typed_array(jsoncons::ubjson::detail::ubjson_format::float32_type, data.size(), ec))
+            {
+                return false;
+            }
+            for (auto val : data)
+            {
+                binary::native_to_big(static_cast<float>(val),std::back_inserter(sink_));
+            }
+        }
+        else
+        {
+            if (!begin_typed_array(jsoncons::ubjson::detail::ubjson_format::float64_type, data.size(), ec))
+            {
+                return false;
+            }
+            for (auto val : data)
+            {
+                binary::native_to_big(val,std::back_inserter(sink_));
+            }
+        }
+        end_value();
+        return true;
+    }
+
+    // Writes the [$type#count header of an optimized container 
+    bool begin_typed_array(uint8_t type, std::size_t length, std::error_code& ec)
+    {
+        if (JSONCONS_UNLIKELY(nesting_depth_ >= options_.max_nesting_depth()))
+        {
+            ec = ubjson_errc::max_nesting_depth_exceeded;
+            return false;
+        } 
+        sink_.push_back(jsoncons::ubjson::detail::ubjson_format::start_array_marker);
+        sink_.push_back(jsoncons::ubjson::detail::ubjson_format::type_marker);
+        sink_.push_back(type);
+        sink_.push_back(jsoncons::ubjson::detail::ubjson_format::count_marker);
+        put_length(length);
+        return true;
+    }
+
+    // Writes an optimized container using the smallest integer type 
+    // that holds every element
+    template <class T>
+    bool write_integer_typed_array(const jsoncons::span<const T>& data, std::error_code& ec)
+    {
+        int64_t lowest = 0;
+        int64_t highest = 0;
+        for (auto val : data)
+        {
+            int64_t x = static_cast<int64_t>(val);
+            if (x < lowest)
+            {
+                lowest = x;
+            }
+            else if (x > highest)
+            {
+                highest = x;
+            }
+        }
+
+        if (lowest >= 0 && highest <= (std::numeric_limits<uint8_t>::max)())
+        {
+            if (!begin_typed_array(jsoncons::ubjson::detail::ubjson_format::uint8_type, data.size(), ec))
+            {
+                return false;
+            }
+            for (auto val : data)
+            {
+                binary::native_to_big(static_cast<uint8_t>(val),std::back_inserter(sink_));
+            }
+        }
+        else if (lowest >= (std::numeric_limits<int8_t>::lowest)() && highest <= (std::numeric_limits<int8_t>::max)())
+        {
+            if (!begin_typed_array(jsoncons::ubjson::detail::ubjson_format::int8_type, data.size(), ec))
+            {
+                return false;
+            }
+            for (auto val : data)
+            {
+                binary::native_to_big(static_cast<int8_t>(val),std::back_inserter(sink_));
+            }
+        }
+        else if (lowest >= (std::numeric_limits<int16_t>::lowest)() && highest <= (std::numeric_limits<int16_t>::max)())
+        {
+            if (!begin_typed_array(jsoncons::ubjson::detail::ubjson_format::int16_type, data.size(), ec))
+            {
+                return false;
+            }
+            for (auto val : data)
+            {
+                binary::native_to_big(static_cast<int16_t>(val),std::back_inserter(sink_));
+            }
+        }
+        else if (lowest >= (std::numeric_limits<int32_t>::lowest)() && highest <= (std::numeric_limits<int32_t>::max)())
+        {
+            if (!begin_typed_array(jsoncons::ubjson::detail::ubjson_format::int32_type, data.size(), ec))
+            {
+                return false;
+            }
+            for (auto val : data)
+            {
+                binary::native_to_big(static_cast<int32_t>(val),std::back_inserter(sink_));
+            }
+        }
+        else
+        {
+            if (!begin_typed_array(jsoncons::ubjson::detail::ubjson_format::int64_type, data.size(), ec))
+            {
+                return false;
+            }
+            for (auto val : data)
+            {
+                binary::native_to_big(static_cast<int64_t>(val),std::back_inserter(sink_));
+            }
+        }
+        end_value();
+        return true;
+    }
+
     void end_value()
     {
         if (!stack_.empty())
@@ -8,7 +8,11 @@
 #define JSONCONS_UBJSON_UBJSON_PARSER_HPP
 
 #include <string>
+#include <vector>
+#include <cstring> // std::memcpy
 #include <memory>
+#include <limits> // std::numeric_limits
+#include <type_traits> // std::aligned_storage
 #include <utility> // std::move
 #include <jsoncons/json.hpp>
 #include <jsoncons/source.hpp>
@@ -47,6 +51,8 @@ class basic_ubjson_parser : public ser_context
     using char_allocator_type = typename std::allocator_traits<temp_allocator_type>:: template rebind_alloc<char_type>;                  
     using byte_allocator_type = typename std::allocator_traits<temp_allocator_type>:: template rebind_alloc<uint8_t>;                  
     using parse_state_allocator_type = typename std::allocator_traits<temp_allocator_type>:: template rebind_alloc<parse_state>;                         
+    using aligned_word = typename std::aligned_storage<sizeof(uint64_t),alignof(uint64_t)>::type;
+    using aligned_word_allocator_type = typename std::allocator_traits<temp_allocator_type>:: template rebind_alloc<aligned_word>;
 
     Src source_;
     ubjson_decode_options options_;
@@ -54,6 +60,8 @@ class basic_ubjson_parser : public ser_context
     bool done_;
     std::basic_string<char,std::char_traits<char>,char_allocator_type> text_buffer_;
     std::vector<parse_state,parse_state_allocator_type> state_stack_;
+    std::vector<uint8_t,byte_allocator_type> typed_array_;
+    std::vector<aligned_word,aligned_word_allocator_type> typed_values_;
     int nesting_depth_;
 public:
     template <class Source>
@@ -66,6 +74,8 @@ public:
          done_(false),
          text_buffer_(alloc),
          state_stack_(alloc),
+         typed_array_(alloc),
+         typed_values_(alloc),
          nesting_depth_(0)
     {
         state_stack_.emplace_back(parse_mode::root,0);
@@ -568,8 +578,34 @@ private:
                     more_ = false;
                     return;
                 }
-                state_stack_.emplace_back(parse_mode::strongly_typed_array,length,item_type.value());
-                more_ = visitor.begin_array(length, semantic_tag::none, *this, ec);
+                switch (item_type.value())
+                {
+                    case jsoncons::ubjson::detail::ubjson_format::uint8_type:
+                        read_typed_array<uint8_t>(visitor, length, ec);
+                        break;
+                    case jsoncons::ubjson::detail::ubjson_format::int8_type:
+                        read_typed_array<int8_t>(visitor, length, ec);
+                        break;
+                    case jsoncons::ubjson::detail::ubjson_format::int16_type:
+                        read_typed_array<int16_t>(visitor, length, ec);
+                        break;
+                    case jsoncons::ubjson::detail::ubjson_format::int32_type:
+                        read_typed_array<int32_t>(visitor, length, ec);
+                        break;
+                    case jsoncons::ubjson::detail::ubjson_format::int64_type:
+                        read_typed_array<int64_t>(visitor, length, ec);
+                        break;
+                    case jsoncons::ubjson::detail::ubjson_format::float32_type:
+                        read_typed_array<float>(visitor, length, ec);
+                        break;
+                    case jsoncons::ubjson::detail::ubjson_format::float64_type:
+                        read_typed_array<double>(visitor, length, ec);
+                        break;
+                    default:
+                        state_stack_.emplace_back(parse_mode::strongly_typed_array,length,item_type.value());
+                        more_ = visitor.begin_array(length, semantic_tag::none, *this, ec);
+                        break;
+                }
             }
             else
             {
@@ -602,6 +638,43 @@ private:
         }
     }
 
+    // Reads the payload of a strongly typed numeric array in one pass and
+    // reports it to the visitor as a typed array
+    template <class T>
+    void read_typed_array(json_visitor& visitor, std::size_t length, std::error_code& ec)
+    {
+        if (length > (std::numeric_limits<std::size_t>::max)()/sizeof(T))
+        {
+            ec = ubjson_errc::max_items_exceeded;
+            more_ = false;
+            return;
+        }
+        const std::size_t size = length*sizeof(T);
+        typed_array_.clear();
+        if (source_reader<Src>::read(source_, typed_array_, size) != size)
+        {
+            ec = ubjson_errc::unexpected_eof;
+            more_ = false;
+            return;
+        }
+        // The bytes are not necessarily aligned for T, so they are copied to aligned storage
+        typed_values_.resize((size + sizeof(aligned_word) - 1)/sizeof(aligned_word));
+        if (size > 0)
+        {
+            std::memcpy(typed_values_.data(), typed_array_.data(), size);
+        }
+        T* data = reinterpret_cast<T*>(typed_values_.data());
+        if (jsoncons::endian::native != jsoncons::endian::big)
+        {
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                data[i] = binary::byte_swap<T>(data[i]);
+            }
+        }
+        --nesting_depth_;
+        more_ = visitor.typed_array(jsoncons::span<const T>(data,length), semantic_tag::none, *this, ec);
+    }
+
     void end_array(json_visitor& visitor, std::error_code& ec)
     {
         --nesting_depth_;
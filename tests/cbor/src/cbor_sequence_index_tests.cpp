@@ -0,0 +1,109 @@
+// Copyright 2020 Daniel Parker
+// Distributed under Boost license
+
+#if defined(_MSC_VER)
+#include "windows.h" // test no inadvertant macro expansions
+#endif
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <catch/catch.hpp>
+#include <vector>
+#include <string>
+#include <type_traits>
+
+using namespace jsoncons;
+
+// The index points into its source, so it can't be made from a temporary
+static_assert(std::is_constructible<cbor::cbor_sequence_index,const std::vector<uint8_t>&>::value, "");
+static_assert(!std::is_constructible<cbor::cbor_sequence_index,std::vector<uint8_t>>::value, "");
+static_assert(!std::is_constructible<cbor::cbor_sequence_index,std::vector<uint8_t>,std::vector<std::size_t>>::value, "");
+
+TEST_CASE("cbor_sequence_index tests")
+{
+    std::vector<json> items;
+    items.push_back(json::parse(R"({"id":1,"name":"first","tags":["a","b"]})"));
+    items.push_back(json(-1000));
+    items.push_back(json(byte_string{1,2,3}));
+    items.push_back(json::parse(R"([1.5,"a long text string that is more than twenty three bytes",null,true])"));
+    items.push_back(json(10, semantic_tag::epoch_second));
+
+    std::vector<uint8_t> data;
+    for (const auto& item : items)
+    {
+        std::vector<uint8_t> buf;
+        cbor::encode_cbor(item, buf);
+        data.insert(data.end(), buf.begin(), buf.end());
+    }
+
+    SECTION("random access")
+    {
+        cbor::cbor_sequence_index index(data);
+        REQUIRE(index.size() == items.size());
+        CHECK(index.offset(0) == 0);
+        for (std::size_t i = items.size(); i-- > 0; )
+        {
+            json j = cbor::decode_cbor<json>(index.item(i));
+            CHECK(j == items[i]);
+        }
+    }
+
+    SECTION("restore from offsets")
+    {
+        cbor::cbor_sequence_index index(data);
+        cbor::cbor_sequence_index other(data, index.offsets());
+        REQUIRE(other.size() == items.size());
+        CHECK(cbor::decode_cbor<json>(other.item(3)) == items[3]);
+    }
+
+    SECTION("restore from invalid offsets")
+    {
+        std::vector<std::vector<std::size_t>> invalid = {
+            {0, 5, 5},
+            {3, 1},
+            {0, data.size()},
+            {data.size() + 10}
+        };
+        for (const auto& offsets : invalid)
+        {
+            std::error_code ec;
+            cbor::cbor_sequence_index index(data, offsets, ec);
+            CHECK(ec == cbor::cbor_errc::invalid_offsets);
+            CHECK(index.size() == 0);
+            REQUIRE_THROWS_AS(cbor::cbor_sequence_index(data, offsets), ser_error);
+        }
+    }
+
+    SECTION("indefinite length items")
+    {
+        std::vector<uint8_t> v = {0x9f,0x01,0x7f,0x61,0x61,0x61,0x62,0xff,0xff, // [_ 1, (_ "a", "b")]
+                                  0xbf,0x61,0x61,0x01,0xff, // {_ "a": 1}
+                                  0xf5}; // true
+        cbor::cbor_sequence_index index(v);
+        REQUIRE(index.size() == 3);
+        CHECK(index.offset(1) == 9);
+        CHECK(index.offset(2) == 14);
+        CHECK(cbor::decode_cbor<json>(index.item(0)) == json::parse(R"([1,"ab"])"));
+        CHECK(cbor::decode_cbor<json>(index.item(1)) == json::parse(R"({"a":1})"));
+        CHECK(cbor::decode_cbor<json>(index.item(2)) == json(true));
+    }
+
+    SECTION("truncated item")
+    {
+        std::vector<uint8_t> v(data.begin(), data.end()-1);
+        std::error_code ec;
+        cbor::cbor_sequence_index index(v, cbor::cbor_decode_options(), ec);
+        CHECK(ec == cbor::cbor_errc::unexpected_eof);
+        CHECK(index.size() == 0);
+        REQUIRE_THROWS(cbor::cbor_sequence_index(v));
+    }
+
+    SECTION("max nesting depth")
+    {
+        std::vector<uint8_t> v = {0x81,0x81,0x81,0x01}; // [[[1]]]
+        cbor::cbor_options options;
+        options.max_nesting_depth(2);
+        std::error_code ec;
+        cbor::cbor_sequence_index index(v, options, ec);
+        CHECK(ec == cbor::cbor_errc::max_nesting_depth_exceeded);
+    }
+}
@@ -0,0 +1,124 @@
+// Copyright 2020 Daniel Parker
+// Distributed under Boost license
+
+#if defined(_MSC_VER)
+#include "windows.h" // test no inadvertant macro expansions
+#endif
+#include <jsoncons_ext/csv/csv.hpp>
+#include <catch/catch.hpp>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+TEST_CASE("csv_column_decoder tests")
+{
+    SECTION("header and type inference")
+    {
+        const std::string input = R"(id,price,flag,name,mixed
+1,2.5,true,"a",1
+2,3,false,b,x
+,4.25,,,2
+)";
+        csv::csv_options options;
+        options.assume_header(true)
+               .unquoted_empty_value_is_null(true);
+
+        csv::csv_column_decoder decoder;
+        csv::csv_reader reader(input, decoder, options);
+        reader.read();
+        REQUIRE(decoder.is_valid());
+        csv::csv_columns result = decoder.get_result();
+
+        REQUIRE(result.row_count() == 3);
+        REQUIRE(result.columns().size() == 5);
+
+        const csv::csv_column* id = result.find("id");
+        REQUIRE(id != nullptr);
+        CHECK(id->kind() == csv::csv_column_kind::integer_t);
+        REQUIRE(id->integers().size() == 3);
+        CHECK(id->integers()[0] == 1);
+        CHECK(id->integers()[1] == 2);
+        CHECK(!id->is_null(1));
+        CHECK(id->is_null(2));
+
+        const csv::csv_column& price = result[1];
+        CHECK(price.name() == "price");
+        CHECK(price.kind() == csv::csv_column_kind::float_t);
+        REQUIRE(price.doubles().size() == 3);
+        CHECK(price.doubles()[0] == 2.5);
+        CHECK(price.doubles()[1] == 3.0);
+        CHECK(price.doubles()[2] == 4.25);
+
+        const csv::csv_column& flag = result[2];
+        CHECK(flag.kind() == csv::csv_column_kind::boolean_t);
+        CHECK(flag.booleans()[0] == 1);
+        CHECK(flag.booleans()[1] == 0);
+        CHECK(flag.is_null(2));
+
+        const csv::csv_column& name = result[3];
+        CHECK(name.kind() == csv::csv_column_kind::string_t);
+        CHECK(name.string_value(0) == "a");
+        CHECK(name.string_value(1) == "b");
+        CHECK(name.is_null(2));
+        CHECK(name.string_offsets().size() == 4);
+
+        const csv::csv_column& mixed = result[4];
+        CHECK(mixed.kind() == csv::csv_column_kind::string_t);
+        CHECK(mixed.string_value(0) == "1");
+        CHECK(mixed.string_value(1) == "x");
+        CHECK(mixed.string_value(2) == "2");
+        CHECK(mixed.validity()[0] == 0x07);
+    }
+
+    SECTION("column_types")
+    {
+        const std::string input = "a,b\n1,2\n3,4\n";
+        csv::csv_options options;
+        options.assume_header(true)
+               .column_types("float,string");
+
+        csv::csv_column_decoder decoder;
+        csv::csv_reader reader(input, decoder, options);
+        reader.read();
+        csv::csv_columns result = decoder.get_result();
+
+        REQUIRE(result.columns().size() == 2);
+        CHECK(result[0].kind() == csv::csv_column_kind::float_t);
+        CHECK(result[0].doubles()[1] == 3.0);
+        CHECK(result[1].kind() == csv::csv_column_kind::string_t);
+        CHECK(result[1].string_value(1) == "4");
+    }
+
+    SECTION("n_rows without header")
+    {
+        const std::string input = "1,2\n3\n5,6,7\n";
+        csv::csv_options options;
+        options.mapping(csv::mapping_kind::n_rows);
+
+        csv::csv_column_decoder decoder;
+        csv::csv_reader reader(input, decoder, options);
+        reader.read();
+        csv::csv_columns result = decoder.get_result();
+
+        REQUIRE(result.row_count() == 3);
+        REQUIRE(result.columns().size() == 3);
+        CHECK(result[1].is_null(1));
+        CHECK(result[2].is_null(0));
+        CHECK(result[2].integers()[2] == 7);
+    }
+
+    SECTION("multi-valued fields are not supported")
+    {
+        const std::string input = "a\n1;2\n";
+        csv::csv_options options;
+        options.assume_header(true)
+               .subfield_delimiter(';');
+
+        csv::csv_column_decoder decoder;
+        csv::csv_reader reader(input, decoder, options);
+        std::error_code ec;
+        reader.read(ec);
+        CHECK(ec == csv::csv_errc::invalid_parse_state);
+    }
+}
@@ -0,0 +1,240 @@
+// Copyright 2020 Daniel Parker
+// Distributed under Boost license
+
+#if defined(_MSC_VER)
+#include "windows.h" // test no inadvertant macro expansions
+#endif
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/csv/csv.hpp>
+#include <jsoncons_ext/csv/csv_parallel_reader.hpp>
+#include <catch/catch.hpp>
+#include <string>
+#include <algorithm>
+
+using namespace jsoncons;
+
+namespace {
+
+    std::string make_csv(std::size_t rows)
+    {
+        std::string s = "id,name,amount,note\n";
+        for (std::size_t i = 0; i < rows; ++i)
+        {
+            s += std::to_string(i);
+            s += ",name";
+            s += std::to_string(i);
+            s += ",";
+            s += std::to_string(i * 0.25);
+            s += ",";
+            if (i % 7 == 0)
+            {
+                s += "\"quoted, with a \"\"quote\"\"\nand a new line\"";
+            }
+            else
+            {
+                s += "plain";
+            }
+            s += "\n";
+        }
+        return s;
+    }
+
+    ojson read_sequential(const std::string& input, const csv::csv_options& options)
+    {
+        json_decoder<ojson> decoder;
+        csv::csv_reader reader(input, decoder, options);
+        reader.read();
+        return decoder.get_result();
+    }
+
+    ojson read_parallel(const std::string& input, const csv::csv_options& options, std::size_t& chunk_count)
+    {
+        json_decoder<ojson> decoder;
+        csv::csv_parallel_reader reader(input, decoder, options, 4);
+        reader.read();
+        chunk_count = reader.chunk_count();
+        return decoder.get_result();
+    }
+
+    // Stops after a number of string values, optionally reporting an error
+    class stopping_visitor : public default_json_visitor
+    {
+        std::size_t count_;
+        bool fail_;
+    public:
+        std::size_t strings;
+
+        stopping_visitor(std::size_t count, bool fail)
+            : count_(count), fail_(fail), strings(0)
+        {
+        }
+    private:
+        bool visit_string(const string_view_type&, semantic_tag, const ser_context&, std::error_code& ec) override
+        {
+            if (++strings < count_)
+            {
+                return true;
+            }
+            if (fail_)
+            {
+                ec = csv::csv_errc::invalid_parse_state;
+                return true;
+            }
+            return false;
+        }
+    };
+}
+
+TEST_CASE("csv_parallel_reader tests")
+{
+    std::string input = make_csv(20000);
+    std::size_t chunk_count = 0;
+
+    SECTION("n_objects")
+    {
+        csv::csv_options options;
+        options.assume_header(true);
+
+        ojson expected = read_sequential(input, options);
+        ojson j = read_parallel(input, options, chunk_count);
+        CHECK(chunk_count > 4);
+        REQUIRE(j.size() == 20000);
+        CHECK(j == expected);
+    }
+
+    SECTION("n_rows with header")
+    {
+        csv::csv_options options;
+        options.assume_header(true)
+               .mapping(csv::mapping_kind::n_rows);
+
+        ojson expected = read_sequential(input, options);
+        ojson j = read_parallel(input, options, chunk_count);
+        CHECK(chunk_count > 4);
+        REQUIRE(j.size() == 20001);
+        CHECK(j == expected);
+    }
+
+    SECTION("n_rows without header")
+    {
+        csv::csv_options options;
+        options.mapping(csv::mapping_kind::n_rows);
+
+        ojson expected = read_sequential(input, options);
+        ojson j = read_parallel(input, options, chunk_count);
+        CHECK(chunk_count > 4);
+        CHECK(j == expected);
+    }
+
+    SECTION("m_columns is parsed on the calling thread")
+    {
+        csv::csv_options options;
+        options.assume_header(true)
+               .mapping(csv::mapping_kind::m_columns);
+
+        ojson expected = read_sequential(input, options);
+        ojson j = read_parallel(input, options, chunk_count);
+        CHECK(chunk_count == 1);
+        CHECK(j == expected);
+    }
+
+    SECTION("small input")
+    {
+        std::string small = make_csv(10);
+        csv::csv_options options;
+        options.assume_header(true);
+
+        ojson j = read_parallel(small, options, chunk_count);
+        CHECK(chunk_count == 1);
+        CHECK(j == read_sequential(small, options));
+    }
+
+    SECTION("error in a later chunk")
+    {
+        std::string bad = input;
+        std::size_t pos = bad.size() - 100;
+        pos = bad.find('\n', pos) + 1;
+        bad.insert(pos, "\"x\"y,1,2,3\n");
+
+        csv::csv_options options;
+        options.assume_header(true);
+
+        json_decoder<ojson> decoder1;
+        csv::csv_reader reader1(bad, decoder1, options);
+        std::error_code ec1;
+        reader1.read(ec1);
+        REQUIRE(ec1);
+
+        json_decoder<ojson> decoder2;
+        csv::csv_parallel_reader reader2(bad, decoder2, options, 4);
+        std::error_code ec2;
+        reader2.read(ec2);
+        CHECK(ec2 == ec1);
+        CHECK(reader2.line() == reader1.line());
+    }
+
+    SECTION("CR line endings")
+    {
+        std::string cr = input;
+        std::replace(cr.begin(), cr.end(), '\n', '\r');
+
+        csv::csv_options options;
+        options.assume_header(true);
+
+        ojson expected = read_sequential(cr, options);
+        ojson j = read_parallel(cr, options, chunk_count);
+        CHECK(chunk_count > 4);
+        REQUIRE(j.size() == 20000);
+        CHECK(j == expected);
+    }
+
+    SECTION("CRLF line endings")
+    {
+        std::string crlf;
+        for (auto c : input)
+        {
+            if (c == '\n')
+            {
+                crlf.push_back('\r');
+            }
+            crlf.push_back(c);
+        }
+
+        csv::csv_options options;
+        options.assume_header(true);
+
+        ojson expected = read_sequential(crlf, options);
+        ojson j = read_parallel(crlf, options, chunk_count);
+        CHECK(chunk_count > 4);
+        CHECK(j == expected);
+    }
+
+    SECTION("visitor stops")
+    {
+        csv::csv_options options;
+        options.assume_header(true);
+
+        stopping_visitor visitor(100, false);
+        csv::csv_parallel_reader reader(input, visitor, options, 4);
+        std::error_code ec;
+        reader.read(ec);
+        CHECK_FALSE(ec);
+        CHECK(visitor.strings == 100);
+    }
+
+    SECTION("visitor reports an error")
+    {
+        csv::csv_options options;
+        options.assume_header(true);
+
+        stopping_visitor visitor(100, true);
+        csv::csv_parallel_reader reader(input, visitor, options, 4);
+        std::error_code ec;
+        reader.read(ec);
+        CHECK(ec == csv::csv_errc::invalid_parse_state);
+        CHECK(visitor.strings == 100);
+        CHECK(reader.line() == 1);
+
+        CHECK_THROWS_AS(csv::csv_parallel_reader(input, visitor, options, 4).read(), ser_error);
+    }
+}
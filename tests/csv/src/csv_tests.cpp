@@ -1558,3 +1558,68 @@ TEST_CASE("infinite loop")
         CHECK(ec == csv::csv_errc::unexpected_char_between_fields); //-V521
     }
 }
+
+TEST_CASE("csv long fields")
+{
+    std::string long_text(100, 'a');
+    std::string input = "name,text,codes\n";
+    input += "\"" + long_text + ",\"\"quoted\"\"\nnext line\"," + long_text + ",1;22;333\n";
+    input += "0123456789012345678901234567890123456789," + long_text + "b,\"x\"\n";
+
+    csv::csv_options options;
+    options.assume_header(true)
+           .subfield_delimiter(';');
+
+    SECTION("whole input")
+    {
+        ojson j = csv::decode_csv<ojson>(input, options);
+        REQUIRE(j.size() == 2);
+        CHECK(j[0]["name"].as<std::string>() == long_text + ",\"quoted\"\nnext line");
+        CHECK(j[0]["text"].as<std::string>() == long_text);
+        CHECK(j[0]["codes"] == ojson::parse("[1,22,333]"));
+        CHECK(j[1]["name"].as<std::string>() == "0123456789012345678901234567890123456789");
+        CHECK(j[1]["text"].as<std::string>() == long_text + "b");
+        CHECK(j[1]["codes"].as<std::string>() == "x");
+    }
+
+    SECTION("small buffer")
+    {
+        json_decoder<ojson> decoder;
+        std::istringstream is(input);
+        csv::csv_reader reader(is, decoder, options);
+        reader.buffer_length(7);
+        reader.read();
+        ojson expected = csv::decode_csv<ojson>(input, options);
+        CHECK(decoder.get_result() == expected);
+    }
+}
+
+TEST_CASE("csv encode object rows")
+{
+    ojson j = ojson::parse(R"(
+[
+    {"a":1,"b":[1,2,3],"c":"x"},
+    {"c":"y","a":[true,null],"b":2.5,"d":9},
+    {"b":"q,r"},
+    {"c":"z","a":"w"}
+]
+    )");
+
+    SECTION("header from first row")
+    {
+        csv::csv_options options;
+        options.subfield_delimiter(';');
+        std::string output;
+        csv::encode_csv(j, output, options);
+        CHECK(output == "a,b,c\n1,1;2;3,x\ntrue;null,2.5,y\n,\"q,r\",\nw,,z\n");
+    }
+
+    SECTION("column names")
+    {
+        csv::csv_options options;
+        options.column_names("c,a");
+        std::string output;
+        csv::encode_csv(j, output, options);
+        CHECK(output == "c,a\nx,1\ny,truenull\n,\nz,w\n");
+    }
+}
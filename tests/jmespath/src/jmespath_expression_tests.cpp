@@ -8,6 +8,8 @@
 #include <jsoncons_ext/jmespath/jmespath.hpp>
 #include <catch/catch.hpp>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 using jsoncons::json;
 namespace jmespath = jsoncons::jmespath;
@@ -75,3 +77,138 @@ TEST_CASE("jmespath_expression tests")
     }    
 }
 
+
+TEST_CASE("jmespath_expression repeated evaluation")
+{
+    json doc = json::parse(R"(
+        {
+          "people": [
+            {"age": 30, "name": "George", "tags": {"a" : 1, "b" : 2}},
+            {"age": 20, "name": "Bob", "tags": {"c" : 3}},
+            {"age": 25, "name": "Fred", "tags": {}}
+          ]
+        }
+    )");
+
+    SECTION("reuse temporaries")
+    {
+        auto expr = jmespath::make_expression<json>("sort_by(people, &age)[].{name: name, n: length(values(tags)), first: to_array(name)}");
+
+        json expected = json::parse(R"(
+            [
+              {"name": "Bob", "n": 1, "first": ["Bob"]},
+              {"name": "Fred", "n": 0, "first": ["Fred"]},
+              {"name": "George", "n": 2, "first": ["George"]}
+            ]
+        )");
+
+        for (std::size_t i = 0; i < 200; ++i)
+        {
+            json result = expr.evaluate(doc);
+            REQUIRE(result == expected);
+        }
+    }
+
+    SECTION("temporaries referring to earlier temporaries")
+    {
+        auto expr = jmespath::make_expression<json>("sort(people[].age) | {ages: @, youngest: [0]}");
+
+        json expected = json::parse(R"({"ages": [20,25,30], "youngest": 20})");
+        for (std::size_t i = 0; i < 10; ++i)
+        {
+            json result = expr.evaluate(doc);
+            REQUIRE(result == expected);
+        }
+    }
+
+    SECTION("results are independent of the document")
+    {
+        auto expr = jmespath::make_expression<json>("reverse(sort(people[].name))");
+
+        json result = expr.evaluate(doc);
+        doc["people"][0]["name"] = "Zed";
+
+        json expected = json::parse(R"(["George","Fred","Bob"])");
+        CHECK(result == expected);
+    }
+
+    SECTION("concurrent evaluation")
+    {
+        auto expr = jmespath::make_expression<json>("people[?age > `21`].name | sort(@)");
+        json expected = json::parse(R"(["Fred","George"])");
+
+        std::vector<std::thread> threads;
+        std::vector<int> matches(4, 0);
+        for (std::size_t i = 0; i < matches.size(); ++i)
+        {
+            threads.emplace_back([&expr,&doc,&expected,&matches,i]()
+            {
+                for (std::size_t j = 0; j < 100; ++j)
+                {
+                    if (expr.evaluate(doc) == expected)
+                    {
+                        ++matches[i];
+                    }
+                }
+            });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        for (auto n : matches)
+        {
+            CHECK(n == 100);
+        }
+    }
+}
+
+TEST_CASE("jmespath_expression compile time optimizations")
+{
+    json doc = json::parse(R"(
+        {
+          "a": {"b": {"c": 1}},
+          "items": [
+            {"field": {"x": 1}, "kind": "lit", "active": true},
+            {"field": {"x": 2}, "kind": "other", "active": false},
+            {"field": "scalar", "kind": "lit"}
+          ]
+        }
+    )");
+
+    SECTION("fused member lookups")
+    {
+        CHECK(jmespath::make_expression<json>("a.b.c").evaluate(doc) == json(1));
+        CHECK(jmespath::make_expression<json>("a.b.c.d").evaluate(doc) == json::null());
+        CHECK(jmespath::make_expression<json>("a.x.c").evaluate(doc) == json::null());
+        CHECK(jmespath::make_expression<json>("items[*].field.x").evaluate(doc) == json::parse("[1,2]"));
+        CHECK(jmespath::make_expression<json>("a | b.c").evaluate(doc) == json(1));
+    }
+
+    SECTION("filter conditions")
+    {
+        CHECK(jmespath::make_expression<json>("items[?kind == 'lit'].field.x").evaluate(doc) == json::parse("[1]"));
+        CHECK(jmespath::make_expression<json>("items[?active].kind").evaluate(doc) == json::parse(R"(["lit"])"));
+        CHECK(jmespath::make_expression<json>("items[?field.x > `1`].kind").evaluate(doc) == json::parse(R"(["other"])"));
+        CHECK(jmespath::make_expression<json>("items[?kind == to_string('lit')].kind").evaluate(doc) == json::parse(R"(["lit","lit"])"));
+        CHECK(jmespath::make_expression<json>("items[?`true`].kind").evaluate(doc) == json::parse(R"(["lit","other","lit"])"));
+    }
+
+    SECTION("folded literals")
+    {
+        CHECK(jmespath::make_expression<json>("length('abc')").evaluate(doc) == json(3));
+        CHECK(jmespath::make_expression<json>("`1` < `2`").evaluate(doc) == json(true));
+        CHECK(jmespath::make_expression<json>("!`true`").evaluate(doc) == json(false));
+        CHECK(jmespath::make_expression<json>("`{\"x\": [1,2,3]}`.x[1]").evaluate(doc) == json(2));
+        CHECK(jmespath::make_expression<json>("{n: length(`[1,2]`), s: a.b.c}").evaluate(doc) == json::parse(R"({"n":2,"s":1})"));
+        CHECK(jmespath::make_expression<json>("[sum(`[1,2]`), max(`[4,5]`)]").evaluate(doc) == json::parse("[3,5]"));
+    }
+
+    SECTION("errors in literal sub-expressions are reported on evaluation")
+    {
+        auto expr = jmespath::make_expression<json>("abs('x')");
+        std::error_code ec;
+        expr.evaluate(doc, ec);
+        CHECK(ec == jmespath::jmespath_errc::invalid_type);
+    }
+}
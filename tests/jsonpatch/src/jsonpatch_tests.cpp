@@ -12,6 +12,7 @@
 #include <utility>
 #include <ctime>
 #include <new>
+#include <random>
 #include <jsoncons/json.hpp>
 #include <jsoncons_ext/jsonpatch/jsonpatch.hpp>
 
@@ -194,3 +195,455 @@ TEST_CASE("jsonpatch - remove two items from array")
 
 
 
+TEST_CASE("jsonpatch from_diff aligns array items")
+{
+    SECTION("insert at the front")
+    {
+        json source(jsoncons::json_array_arg);
+        for (int i = 0; i < 1000; ++i)
+        {
+            source.push_back(json::parse(R"({"id":)" + std::to_string(i) + R"(,"tags":["a","b"]})"));
+        }
+        json target = source;
+        target.insert(target.array_range().begin(), json::parse(R"({"id":-1})"));
+
+        json patch = jsonpatch::from_diff(source, target);
+        REQUIRE(patch.size() == 1);
+        CHECK(patch[0] == json::parse(R"({"op":"add","path":"/0","value":{"id":-1}})"));
+        check_patch(source,patch,std::error_code(),target);
+    }
+
+    SECTION("remove from the middle")
+    {
+        json source = json::parse(R"([1,2,3,4,5,6,7,8])");
+        json target = json::parse(R"([1,2,3,6,7,8])");
+
+        json patch = jsonpatch::from_diff(source, target);
+        CHECK(patch.size() == 2);
+        check_patch(source,patch,std::error_code(),target);
+    }
+
+    SECTION("changed item")
+    {
+        json source = json::parse(R"([{"a":1,"b":[1,2]},{"a":2}])");
+        json target = json::parse(R"([{"a":1,"b":[1,2,3]},{"a":2}])");
+
+        json patch = jsonpatch::from_diff(source, target);
+        REQUIRE(patch.size() == 1);
+        CHECK(patch[0] == json::parse(R"({"op":"add","path":"/0/b/2","value":3})"));
+        check_patch(source,patch,std::error_code(),target);
+    }
+
+    SECTION("more edits than are aligned")
+    {
+        json source(jsoncons::json_array_arg);
+        json target(jsoncons::json_array_arg);
+        for (int i = 0; i < 3000; ++i)
+        {
+            source.push_back(i);
+            target.push_back(i % 3 == 0 ? -i : i);
+        }
+        json patch = jsonpatch::from_diff(source, target);
+        check_patch(source,patch,std::error_code(),target);
+    }
+}
+
+TEST_CASE("jsonpatch from_diff moves and copies")
+{
+    SECTION("move an object between members")
+    {
+        json source = json::parse(R"({"old":{"x":[1,2,3],"y":"z"},"other":1})");
+        json target = json::parse(R"({"new":{"x":[1,2,3],"y":"z"},"other":1})");
+
+        json patch = jsonpatch::from_diff(source, target);
+        REQUIRE(patch.size() == 1);
+        CHECK(patch[0] == json::parse(R"({"op":"move","from":"/old","path":"/new"})"));
+        check_patch(source,patch,std::error_code(),target);
+    }
+
+    SECTION("copy an object to another member")
+    {
+        json source = json::parse(R"({"a":{"x":[1,2,3]}})");
+        json target = json::parse(R"({"a":{"x":[1,2,3]},"b":{"x":[1,2,3]}})");
+
+        json patch = jsonpatch::from_diff(source, target);
+        REQUIRE(patch.size() == 1);
+        CHECK(patch[0] == json::parse(R"({"op":"copy","from":"/a","path":"/b"})"));
+        check_patch(source,patch,std::error_code(),target);
+    }
+
+    SECTION("move array items")
+    {
+        json source = json::parse(R"([{"id":1},{"id":2},{"id":3},{"id":4}])");
+        json target = json::parse(R"([{"id":4},{"id":2},{"id":3},{"id":1}])");
+
+        json patch = jsonpatch::from_diff(source, target);
+        for (const auto& op : patch.array_range())
+        {
+            CHECK(op["op"].as<std::string>() == "move");
+        }
+        check_patch(source,patch,std::error_code(),target);
+    }
+}
+
+namespace {
+
+    json random_value(std::mt19937& gen, int depth)
+    {
+        std::uniform_int_distribution<int> kind(0, depth > 0 ? 5 : 2);
+        std::uniform_int_distribution<int> small(0, 4);
+        switch (kind(gen))
+        {
+            case 0:
+                return json(small(gen));
+            case 1:
+                return json(std::string(1, static_cast<char>('a' + small(gen))));
+            case 2:
+                return json(small(gen) == 0 ? json::null() : json(small(gen) % 2 == 0));
+            case 3:
+            case 4:
+            {
+                json val(jsoncons::json_array_arg);
+                int n = small(gen) + small(gen);
+                for (int i = 0; i < n; ++i)
+                {
+                    val.push_back(random_value(gen, depth-1));
+                }
+                return val;
+            }
+            default:
+            {
+                json val(jsoncons::json_object_arg);
+                int n = small(gen) + small(gen);
+                for (int i = 0; i < n; ++i)
+                {
+                    val.insert_or_assign(std::string(1, static_cast<char>('k' + small(gen))), random_value(gen, depth-1));
+                }
+                return val;
+            }
+        }
+    }
+
+    // Changes some of the values in val
+    void mutate(std::mt19937& gen, json& val, int depth)
+    {
+        std::uniform_int_distribution<int> choice(0, 9);
+        if (val.is_array())
+        {
+            for (std::size_t i = 0; i < val.size(); ++i)
+            {
+                switch (choice(gen))
+                {
+                    case 0:
+                        val.erase(val.array_range().begin() + i);
+                        break;
+                    case 1:
+                        val.insert(val.array_range().begin() + i, random_value(gen, depth));
+                        break;
+                    case 2:
+                        // duplicate an item
+                        val.insert(val.array_range().begin() + i, json(val[val.size() - 1 - i]));
+                        break;
+                    case 3:
+                        mutate(gen, val[i], depth-1);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+        else if (val.is_object())
+        {
+            std::vector<std::string> keys;
+            for (const auto& member : val.object_range())
+            {
+                keys.push_back(member.key());
+            }
+            for (const auto& key : keys)
+            {
+                switch (choice(gen))
+                {
+                    case 0:
+                        val.erase(key);
+                        break;
+                    case 1:
+                    {
+                        json moved = val[key];
+                        val.erase(key);
+                        val.insert_or_assign(key + "2", std::move(moved));
+                        break;
+                    }
+                    case 2:
+                        val.insert_or_assign(key + "3", json(val[key]));
+                        break;
+                    case 3:
+                        mutate(gen, val[key], depth-1);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+        else if (choice(gen) < 5)
+        {
+            val = random_value(gen, depth);
+        }
+    }
+}
+
+TEST_CASE("jsonpatch from_diff random round trips")
+{
+    std::mt19937 gen(20201018);
+    for (int n = 0; n < 2000; ++n)
+    {
+        json source = random_value(gen, 4);
+        if (!(source.is_array() || source.is_object()))
+        {
+            continue; // apply_patch doesn't replace the whole document
+        }
+        json target = source;
+        mutate(gen, target, 4);
+
+        json patch = jsonpatch::from_diff(source, target);
+        json result = source;
+        std::error_code ec;
+        jsonpatch::apply_patch(result, patch, ec);
+        INFO(source.to_string() + "\n" + target.to_string() + "\n" + patch.to_string());
+        CHECK_FALSE(ec);
+        CHECK(result == target);
+    }
+}
+
+TEST_CASE("jsonpatch apply_patch rollback")
+{
+    json doc = json::parse(R"(
+{"a":{"b":[1,2,3],"c":"x"},"d":[{"e":1},{"e":2}]}
+    )");
+
+    SECTION("every kind of operation is undone")
+    {
+        json patch = json::parse(R"(
+[
+    {"op":"add","path":"/a/b/-","value":4},
+    {"op":"add","path":"/a/b/0","value":0},
+    {"op":"add","path":"/a/c","value":"y"},
+    {"op":"remove","path":"/d/0"},
+    {"op":"replace","path":"/a/b/1","value":10},
+    {"op":"move","from":"/a/c","path":"/d/-"},
+    {"op":"move","from":"/a/b","path":"/a/c"},
+    {"op":"copy","from":"/a/c","path":"/f"},
+    {"op":"copy","from":"/d","path":"/a/c"},
+    {"op":"test","path":"/a/c/0/e","value":3}
+]
+        )");
+        json expected = doc;
+        std::error_code ec;
+        jsonpatch::apply_patch(doc, patch, ec);
+        CHECK(ec == jsonpatch::jsonpatch_errc::test_failed);
+        CHECK(doc == expected);
+    }
+
+    SECTION("no rollback")
+    {
+        json patch = json::parse(R"(
+[
+    {"op":"add","path":"/a/b/-","value":4},
+    {"op":"remove","path":"/d/0"},
+    {"op":"remove","path":"/d/5"}
+]
+        )");
+        std::error_code ec;
+        jsonpatch::apply_patch(doc, patch, jsonpatch::rollback_policy::no_rollback, ec);
+        CHECK(ec == jsonpatch::jsonpatch_errc::remove_failed);
+        CHECK(doc == json::parse(R"({"a":{"b":[1,2,3,4],"c":"x"},"d":[{"e":2}]})"));
+    }
+
+    SECTION("replace the whole document")
+    {
+        json patch = json::parse(R"([{"op":"replace","path":"","value":[1]},{"op":"add","path":"/-","value":2}])");
+        jsonpatch::apply_patch(doc, patch);
+        CHECK(doc == json::parse("[1,2]"));
+    }
+
+    SECTION("move into a child")
+    {
+        json patch = json::parse(R"([{"op":"move","from":"/a","path":"/a/b/0"}])");
+        json expected = doc;
+        std::error_code ec;
+        jsonpatch::apply_patch(doc, patch, ec);
+        CHECK(ec == jsonpatch::jsonpatch_errc::move_failed);
+        CHECK(doc == expected);
+    }
+
+    SECTION("invalid pointer")
+    {
+        json patch = json::parse(R"([{"op":"add","path":"/a/c~2","value":1}])");
+        std::error_code ec;
+        jsonpatch::apply_patch(doc, patch, ec);
+        CHECK(ec == jsonpatch::jsonpatch_errc::add_failed);
+    }
+
+    SECTION("unknown operation")
+    {
+        json patch = json::parse(R"([{"op":"swap","path":"/a"}])");
+        std::error_code ec;
+        jsonpatch::apply_patch(doc, patch, ec);
+        CHECK(ec == jsonpatch::jsonpatch_errc::invalid_patch);
+    }
+}
+
+TEST_CASE("jsonpatch apply_patch many operations on one parent")
+{
+    json doc = json::parse(R"({"config":{"items":[]}})");
+    json patch(jsoncons::json_array_arg);
+    for (int i = 0; i < 10000; ++i)
+    {
+        json op(jsoncons::json_object_arg);
+        op.try_emplace("op", "add");
+        op.try_emplace("path", "/config/items/-");
+        op.try_emplace("value", i);
+        patch.push_back(std::move(op));
+    }
+    for (int i = 0; i < 5000; ++i)
+    {
+        json op(jsoncons::json_object_arg);
+        op.try_emplace("op", "remove");
+        op.try_emplace("path", "/config/items/0");
+        patch.push_back(std::move(op));
+    }
+    json result = doc;
+    jsonpatch::apply_patch(result, patch);
+    REQUIRE(result["config"]["items"].size() == 5000);
+    CHECK(result["config"]["items"][0] == 5000);
+
+    patch.push_back(json::parse(R"({"op":"test","path":"/config/items/0","value":0})"));
+    result = doc;
+    std::error_code ec;
+    jsonpatch::apply_patch(result, patch, ec);
+    CHECK(ec == jsonpatch::jsonpatch_errc::test_failed);
+    CHECK(result == doc);
+}
+
+TEST_CASE("jsonpatch random patches are rolled back")
+{
+    std::mt19937 gen(1018);
+    for (int n = 0; n < 1000; ++n)
+    {
+        json source = random_value(gen, 4);
+        if (!(source.is_array() || source.is_object()))
+        {
+            continue;
+        }
+        json target = source;
+        mutate(gen, target, 4);
+
+        json patch = jsonpatch::from_diff(source, target);
+        patch.push_back(json::parse(R"({"op":"remove","path":"/no/such/path"})"));
+        json result = source;
+        std::error_code ec;
+        jsonpatch::apply_patch(result, patch, ec);
+        CHECK(ec == jsonpatch::jsonpatch_errc::remove_failed);
+        CHECK(result == source);
+    }
+}
+
+namespace {
+
+    // Fails the allocation that brings the count down to zero, once
+    struct allocation_budget
+    {
+        static std::size_t& countdown()
+        {
+            static std::size_t count = 0;
+            return count;
+        }
+    };
+
+    template <class T>
+    class failing_allocator
+    {
+    public:
+        using value_type = T;
+
+        failing_allocator() noexcept = default;
+
+        template <class U>
+        failing_allocator(const failing_allocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            std::size_t& count = allocation_budget::countdown();
+            if (count > 0 && --count == 0)
+            {
+                throw std::bad_alloc();
+            }
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            std::allocator<T>().deallocate(p, n);
+        }
+
+        friend bool operator==(const failing_allocator&, const failing_allocator&) noexcept
+        {
+            return true;
+        }
+
+        friend bool operator!=(const failing_allocator&, const failing_allocator&) noexcept
+        {
+            return false;
+        }
+    };
+}
+
+TEST_CASE("jsonpatch apply_patch rolls back when an allocation fails")
+{
+    using failing_json = jsoncons::basic_json<char,jsoncons::sorted_policy,failing_allocator<char>>;
+
+    failing_json doc = failing_json::parse(R"(
+{"a":{"b":["first long string value","second long string value"],"c":"a string that is not stored inline"},
+ "d":[{"e":"another string that is not stored inline"},{"e":2}]}
+    )");
+    failing_json patch = failing_json::parse(R"(
+[
+    {"op":"add","path":"/a/b/-","value":"a string that is added to the end"},
+    {"op":"add","path":"/a/new member with a long name","value":{"x":"a string that is not stored inline"}},
+    {"op":"remove","path":"/d/0"},
+    {"op":"replace","path":"/a/b/1","value":["a replacement that is not stored inline"]},
+    {"op":"move","from":"/a/c","path":"/d/-"},
+    {"op":"move","from":"/a/b","path":"/moved member with a long name"},
+    {"op":"copy","from":"/d","path":"/copied member with a long name"}
+]
+    )");
+
+    failing_json expected = doc;
+    jsonpatch::apply_patch(expected, patch);
+
+    std::size_t failures = 0;
+    for (std::size_t n = 1; n < 1000; ++n)
+    {
+        failing_json target = doc;
+        allocation_budget::countdown() = n;
+        bool threw = false;
+        try
+        {
+            jsonpatch::apply_patch(target, patch);
+        }
+        catch (const std::bad_alloc&)
+        {
+            threw = true;
+        }
+        allocation_budget::countdown() = 0;
+        if (!threw)
+        {
+            CHECK(target == expected);
+            break;
+        }
+        ++failures;
+        CHECK(target == doc);
+    }
+    CHECK(failures > 5);
+}
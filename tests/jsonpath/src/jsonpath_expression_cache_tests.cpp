@@ -0,0 +1,147 @@
+// Copyright 2021 Daniel Parker
+// Distributed under Boost license
+
+#if defined(_MSC_VER)
+#include "windows.h" // test no inadvertant macro expansions
+#endif
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpath/expression_cache.hpp>
+#include <catch/catch.hpp>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+using json = jsoncons::json;
+namespace jsonpath = jsoncons::jsonpath;
+
+TEST_CASE("jsonpath expression_cache tests")
+{
+    json root = json::parse(R"({"books":[{"title":"A","price":5},{"title":"B","price":15},{"title":"C","price":25}]})");
+
+    SECTION("hit returns same expression")
+    {
+        jsonpath::expression_cache<json> cache(4);
+        auto expr1 = cache.get("$.books[*].title");
+        auto expr2 = cache.get("$.books[*].title");
+        CHECK(expr1 == expr2);
+        CHECK(cache.size() == 1);
+        CHECK(expr1->evaluate(root) == json::parse(R"(["A","B","C"])"));
+    }
+
+    SECTION("least recently used is evicted")
+    {
+        jsonpath::expression_cache<json> cache(2);
+        auto a = cache.get("$.books[0]");
+        auto b = cache.get("$.books[1]");
+        CHECK(cache.get("$.books[0]") == a); // $.books[1] is now least recently used
+        auto c = cache.get("$.books[2]");
+        CHECK(cache.size() == 2);
+        CHECK(cache.get("$.books[0]") == a);
+        CHECK(cache.get("$.books[1]") != b);
+        CHECK(b->evaluate(root) == json::parse(R"([{"title":"B","price":15}])"));
+    }
+
+    SECTION("compile errors are not cached")
+    {
+        jsonpath::expression_cache<json> cache(2);
+        std::error_code ec;
+        auto expr = cache.get("$.books[", ec);
+        CHECK(ec);
+        CHECK_FALSE(expr);
+        CHECK(cache.size() == 0);
+        CHECK_THROWS_AS(cache.get("$.books["), jsonpath::jsonpath_error);
+    }
+
+    SECTION("custom functions")
+    {
+        jsonpath::custom_functions<json> functions;
+        functions.register_function("twice", 1,
+             [](jsoncons::span<const jsonpath::parameter<json>> params, std::error_code&) -> json 
+             {
+                return json(params[0].value().as<int64_t>() * 2);
+             }
+        );
+        jsonpath::expression_cache<json> cache(2, functions);
+        auto expr = cache.get("twice($.books[0].price)");
+        CHECK(expr->evaluate(root) == json::parse("[10]"));
+
+        std::error_code ec;
+        jsonpath::expression_cache<json>::instance().get("twice($.books[0].price)", ec);
+        CHECK(ec == jsonpath::jsonpath_errc::unknown_function);
+    }
+}
+
+TEST_CASE("jsonpath concurrent evaluation tests")
+{
+    json root(jsoncons::json_array_arg);
+    for (int i = 0; i < 200; ++i)
+    {
+        json item(jsoncons::json_object_arg);
+        item.try_emplace("id", i);
+        item.try_emplace("name", "item" + std::to_string(i));
+        root.push_back(std::move(item));
+    }
+
+    const std::size_t num_threads = 8;
+
+    SECTION("one compiled expression evaluated from many threads")
+    {
+        auto expr = jsonpath::make_expression<json>("$[?(@.id >= 100 && @.id < 110)].name");
+        json expected = expr.evaluate(root);
+        REQUIRE(expected.size() == 10);
+        json expected_paths = expr.evaluate(root, jsonpath::result_options::path | jsonpath::result_options::sort);
+
+        std::atomic<int> mismatches(0);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < num_threads; ++t)
+        {
+            threads.emplace_back([&]()
+            {
+                for (int i = 0; i < 50; ++i)
+                {
+                    if (expr.evaluate(root) != expected || 
+                        expr.evaluate(root, jsonpath::result_options::path | jsonpath::result_options::sort) != expected_paths)
+                    {
+                        ++mismatches;
+                    }
+                }
+            });
+        }
+        for (auto& th : threads)
+        {
+            th.join();
+        }
+        CHECK(mismatches == 0);
+    }
+
+    SECTION("shared cache used from many threads")
+    {
+        jsonpath::expression_cache<json> cache(4);
+        std::vector<std::string> paths = {"$[0].name", "$[1].name", "$[2].name", "$[3].name", "$[4].name", "$[5].name"};
+
+        std::atomic<int> mismatches(0);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < num_threads; ++t)
+        {
+            threads.emplace_back([&, t]()
+            {
+                for (std::size_t i = 0; i < 100; ++i)
+                {
+                    std::size_t k = (i + t) % paths.size();
+                    json result = cache.get(paths[k])->evaluate(root);
+                    if (result.size() != 1 || result[0].as<std::string>() != "item" + std::to_string(k))
+                    {
+                        ++mismatches;
+                    }
+                }
+            });
+        }
+        for (auto& th : threads)
+        {
+            th.join();
+        }
+        CHECK(mismatches == 0);
+        CHECK(cache.size() <= 4);
+    }
+}
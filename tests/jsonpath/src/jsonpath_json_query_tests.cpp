@@ -120,3 +120,103 @@ TEST_CASE("jsonpath json_query wjson test")
     }
 }
 
+
+TEST_CASE("jsonpath json_query normalized paths")
+{
+    json j = json::parse(R"(
+{"a" : {"b" : [{"c" : 1}, {"c" : 2}], "c" : 3}, "b" : [10,20]}
+    )");
+
+    SECTION("recursive descent")
+    {
+        json result = jsonpath::json_query(j, "$..c", jsonpath::result_options::path);
+        json expected = json::parse(R"(["$['a']['c']","$['a']['b'][0]['c']","$['a']['b'][1]['c']"])");
+        CHECK(result == expected);
+    }
+
+    SECTION("sort")
+    {
+        json result = jsonpath::json_query(j, "$..c", jsonpath::result_options::path | jsonpath::result_options::sort);
+        json expected = json::parse(R"(["$['a']['b'][0]['c']","$['a']['b'][1]['c']","$['a']['c']"])");
+        CHECK(result == expected);
+    }
+
+    SECTION("nodups")
+    {
+        json result = jsonpath::json_query(j, "$['b','a','b'][1,0,1]", jsonpath::result_options::path | jsonpath::result_options::nodups);
+        json expected = json::parse(R"(["$['b'][1]","$['b'][0]"])");
+        CHECK(result == expected);
+    }
+
+    SECTION("sort and nodups with prefixes")
+    {
+        json result = jsonpath::json_query(j, "$['a','a'].b[*].c", jsonpath::result_options::path | jsonpath::result_options::nodups | jsonpath::result_options::sort);
+        json expected = json::parse(R"(["$['a']['b'][0]['c']","$['a']['b'][1]['c']"])");
+        CHECK(result == expected);
+
+        json values = jsonpath::json_query(j, "$['a','a']..c", jsonpath::result_options::nodups | jsonpath::result_options::sort);
+        json expected_values = json::parse(R"([1,2,3])");
+        CHECK(values == expected_values);
+    }
+
+    SECTION("callback")
+    {
+        std::vector<std::string> paths;
+        jsonpath::json_query(j, "$.b[*]", 
+            [&paths](const std::string& path, const json&) {paths.push_back(path);},
+            jsonpath::result_options::path);
+        REQUIRE(paths.size() == 2);
+        CHECK(paths[0] == "$['b'][0]");
+        CHECK(paths[1] == "$['b'][1]");
+    }
+}
+
+TEST_CASE("jsonpath json_query_first and limit")
+{
+    json j = json::parse(R"(
+[{"id" : 1, "tags" : ["a"]}, {"id" : 42, "items" : [{"id" : 42}]}, {"id" : 3}, {"id" : 42}]
+    )");
+
+    SECTION("json_query_first")
+    {
+        json result = jsonpath::json_query_first(j, "$..[?(@.id == 42)]");
+        json expected = json::parse(R"([{"id" : 42, "items" : [{"id" : 42}]}])");
+        CHECK(result == expected);
+
+        json path = jsonpath::json_query_first(j, "$..[?(@.id == 42)]", jsonpath::result_options::path);
+        REQUIRE(path.size() == 1);
+
+        CHECK(jsonpath::json_query_first(j, "$..[?(@.id == 7)]").empty());
+    }
+
+    SECTION("limit")
+    {
+        auto expr = jsonpath::make_expression<json>("$[*].id");
+        CHECK(expr.evaluate(j, 2) == json::parse("[1,42]"));
+        CHECK(expr.evaluate(j, 10) == json::parse("[1,42,3,42]"));
+        CHECK(expr.evaluate(j, 0).empty());
+        CHECK(expr.evaluate(j, 2, jsonpath::result_options::sort) == json::parse("[1,42]"));
+
+        auto expr2 = jsonpath::make_expression<json>("$..id");
+        CHECK(expr2.evaluate(j, 3, jsonpath::result_options::nodups) == json::parse("[1,42,42]"));
+        CHECK(expr2.evaluate(j, 1, jsonpath::result_options::path | jsonpath::result_options::sort) == json::parse(R"(["$[0]['id']"])"));
+
+        auto expr3 = jsonpath::make_expression<json>("$[0,3,2].id");
+        CHECK(expr3.evaluate(j, 2) == json::parse("[1,42]"));
+    }
+
+    SECTION("conjuncts")
+    {
+        json result = jsonpath::json_query(j, "$[?(@.tags[0] =~ /a.*/ && @.id == 1 && length(@.tags) == 1)].id");
+        CHECK(result == json::parse("[1]"));
+
+        result = jsonpath::json_query(j, "$[?(@.id == 42 && (@.items || @.tags))].id");
+        CHECK(result == json::parse("[42]"));
+
+        result = jsonpath::json_query(j, "$[?(@.id > 1 + 1 && @.id < 2 * 10)].id");
+        CHECK(result == json::parse("[3]"));
+
+        result = jsonpath::json_query(j, "$[?(@.missing.x && @.id == 1)].id");
+        CHECK(result.empty());
+    }
+}
@@ -480,3 +480,108 @@ TEST_CASE("[jsonpointer] create_if_missing")
     }*/
 }
 
+
+TEST_CASE("[jsonpointer] operations on a parsed pointer")
+{
+    json example = json::parse(R"(
+       {
+          "a/b": ["bar", "baz"],
+          "m~n": {"x": 1}
+       }
+    )");
+
+    SECTION("get")
+    {
+        jsonpointer::json_pointer ptr("/a~1b/1");
+        CHECK(jsonpointer::get(example, ptr) == json("baz"));
+        const json& cexample = example;
+        CHECK(jsonpointer::get(cexample, ptr) == json("baz"));
+        CHECK(jsonpointer::contains(example, ptr));
+        CHECK_FALSE(jsonpointer::contains(example, jsonpointer::json_pointer("/a~1b/2")));
+        CHECK(jsonpointer::get(example, jsonpointer::json_pointer()) == example);
+    }
+
+    SECTION("same results as the string overloads")
+    {
+        std::vector<std::string> locations = {"/a~1b/0", "/a~1b/-", "/a~1b/x", "/a~1b/01", "/m~0n/x", "/m~0n/y", "/m~0n/x/z"};
+        for (const auto& location : locations)
+        {
+            INFO(location);
+            std::error_code ec1;
+            std::error_code ec2;
+            const json& j1 = jsonpointer::get(example, location, ec1);
+            const json& j2 = jsonpointer::get(example, jsonpointer::json_pointer(location), ec2);
+            CHECK(ec1 == ec2);
+            if (!ec1)
+            {
+                CHECK(j1 == j2);
+            }
+        }
+    }
+
+    SECTION("add, add_if_absent, replace and remove")
+    {
+        jsonpointer::json_pointer ptr;
+        ptr /= "a/b";
+        ptr /= 0;
+
+        jsonpointer::add(example, ptr, json("foo"));
+        CHECK(example["a/b"] == json::parse(R"(["foo","bar","baz"])"));
+
+        jsonpointer::json_pointer end_ptr("/a~1b/-");
+        jsonpointer::add(example, end_ptr, json("qux"));
+        CHECK(example["a/b"].size() == 4);
+
+        std::error_code ec;
+        jsonpointer::add_if_absent(example, jsonpointer::json_pointer("/m~0n/x"), json(2), ec);
+        CHECK(ec == jsonpointer::jsonpointer_errc::key_already_exists);
+        jsonpointer::add_if_absent(example, jsonpointer::json_pointer("/m~0n/y"), json(2));
+        CHECK(example["m~n"]["y"] == json(2));
+
+        jsonpointer::replace(example, ptr, json("oof"));
+        CHECK(example["a/b"][0] == json("oof"));
+
+        jsonpointer::remove(example, ptr);
+        CHECK(example["a/b"] == json::parse(R"(["bar","baz","qux"])"));
+
+        jsonpointer::remove(example, jsonpointer::json_pointer("/m~0n/x"));
+        CHECK_FALSE(example["m~n"].contains("x"));
+    }
+
+    SECTION("string")
+    {
+        jsonpointer::json_pointer ptr("/a~1b");
+        ptr /= 1;
+        ptr /= "m~n";
+        CHECK(ptr.string() == "/a~1b/1/m~0n");
+        CHECK(jsonpointer::json_pointer(ptr.string()) == ptr);
+    }
+
+    SECTION("create if missing")
+    {
+        json doc;
+        jsonpointer::json_pointer ptr("/foo/bar/baz");
+        jsonpointer::add(doc, ptr, json("str"), true);
+        CHECK(doc == json::parse(R"({"foo":{"bar":{"baz":"str"}}})"));
+    }
+
+    SECTION("malformed pointer")
+    {
+        std::error_code ec;
+        jsonpointer::get(example, jsonpointer::json_pointer("a/b"), ec);
+        CHECK(ec == jsonpointer::jsonpointer_errc::expected_slash);
+
+        ec = std::error_code();
+        jsonpointer::remove(example, jsonpointer::json_pointer("/m~2n"), ec);
+        CHECK(ec == jsonpointer::jsonpointer_errc::expected_0_or_1);
+    }
+
+    SECTION("ojson")
+    {
+        ojson doc = ojson::parse(R"({"b":1,"a":{"c":[1,2]}})");
+        jsonpointer::json_pointer ptr("/a/c/1");
+        jsonpointer::remove(doc, ptr);
+        jsonpointer::remove(doc, jsonpointer::json_pointer("/b"));
+        CHECK(doc == ojson::parse(R"({"a":{"c":[1]}})"));
+    }
+}
@@ -0,0 +1,297 @@
+// Copyright 2020 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#include <jsoncons_ext/jsonschema/jsonschema.hpp>
+#include <jsoncons_ext/jsonschema/schema_snapshot.hpp>
+
+#include <catch/catch.hpp>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using jsoncons::json;
+namespace jsonschema = jsoncons::jsonschema;
+namespace cbor = jsoncons::cbor;
+
+namespace {
+
+    const std::map<std::string,std::string> documents = {
+        {"http://example.com/common.json", R"(
+{
+    "definitions": {
+        "id": { "type": "integer", "minimum": 1 },
+        "name": { "type": "string", "maxLength": 8 }
+    },
+    "things": {
+        "flag": { "type": "boolean" }
+    }
+}
+        )"},
+        {"http://example.com/node.json", R"(
+{
+    "type": "object",
+    "properties": {
+        "id": { "$ref": "common.json#/definitions/id" },
+        "tree": { "$ref": "tree.json" }
+    }
+}
+        )"},
+        {"http://example.com/code.json", R"(
+{
+    "type": "string",
+    "pattern": "^ab"
+}
+        )"},
+        {"http://example.com/tree.json", R"(
+{
+    "type": "array",
+    "items": { "$ref": "node.json" }
+}
+        )"}
+    };
+
+    struct counting_resolver
+    {
+        std::shared_ptr<std::size_t> count;
+
+        counting_resolver()
+            : count(std::make_shared<std::size_t>(0))
+        {
+        }
+
+        json operator()(const jsoncons::uri& uri) const
+        {
+            ++(*count);
+            auto it = documents.find(std::string(uri.base()));
+            if (it == documents.end())
+            {
+                JSONCONS_THROW(jsonschema::schema_error("Don't know how to load JSON Schema " + std::string(uri.base())));
+            }
+            return json::parse(it->second);
+        }
+    };
+
+    // Matches no string, and counts the patterns it compiles
+    class nothing_matcher : public jsonschema::regex_matcher
+    {
+    public:
+        bool search(const jsoncons::string_view&) const override
+        {
+            return false;
+        }
+    };
+
+    jsonschema::regex_engine counting_engine(std::shared_ptr<std::size_t> count)
+    {
+        return [count](const std::string&) -> jsonschema::regex_matcher_pointer
+        {
+            ++(*count);
+            return std::make_shared<nothing_matcher>();
+        };
+    }
+
+    const std::string person_schema = R"(
+{
+    "type": "object",
+    "properties": {
+        "id": { "$ref": "http://example.com/common.json#/definitions/id" },
+        "name": { "$ref": "http://example.com/common.json#/definitions/name" },
+        "active": { "$ref": "http://example.com/common.json#/things/flag" }
+    },
+    "required": ["id"]
+}
+    )";
+
+    const std::string order_schema = R"(
+{
+    "type": "object",
+    "properties": {
+        "order_id": { "$ref": "http://example.com/common.json#/definitions/id" },
+        "customer": { "$ref": "http://example.com/common.json#/definitions/name" }
+    }
+}
+    )";
+}
+
+TEST_CASE("jsonschema schema cache")
+{
+    SECTION("a document is resolved once")
+    {
+        counting_resolver resolver;
+        jsonschema::schema_cache<json> cache;
+
+        jsonschema::json_validator<json> person(jsonschema::make_schema(json::parse(person_schema), resolver, cache));
+        CHECK(*resolver.count == 1);
+        jsonschema::json_validator<json> order(jsonschema::make_schema(json::parse(order_schema), resolver, cache));
+        CHECK(*resolver.count == 1);
+        CHECK(cache.size() == 1);
+
+        CHECK(person.is_valid(json::parse(R"({"id":1,"name":"a","active":true})")));
+        CHECK_FALSE(person.is_valid(json::parse(R"({"id":0})")));
+        CHECK_FALSE(person.is_valid(json::parse(R"({"id":1,"name":"abcdefghij"})")));
+        CHECK_FALSE(person.is_valid(json::parse(R"({"id":1,"active":1})")));
+        CHECK(order.is_valid(json::parse(R"({"order_id":5,"customer":"b"})")));
+        CHECK_FALSE(order.is_valid(json::parse(R"({"order_id":"5"})")));
+    }
+
+    SECTION("same errors as without a cache")
+    {
+        jsonschema::schema_cache<json> cache;
+        jsonschema::json_validator<json> cached(jsonschema::make_schema(json::parse(person_schema), counting_resolver(), cache));
+        jsonschema::json_validator<json> uncached(jsonschema::make_schema(json::parse(person_schema), counting_resolver()));
+
+        json instance = json::parse(R"({"id":-1,"name":"abcdefghij","active":"yes"})");
+        std::vector<std::string> expected;
+        uncached.validate(instance, [&expected](const jsonschema::validation_output& o)
+        {
+            expected.push_back(o.instance_location() + ": " + o.message());
+        });
+        std::vector<std::string> result;
+        cached.validate(instance, [&result](const jsonschema::validation_output& o)
+        {
+            result.push_back(o.instance_location() + ": " + o.message());
+        });
+        CHECK(expected.size() == 3);
+        CHECK(result == expected);
+    }
+
+    SECTION("schemas outlive the cache")
+    {
+        std::shared_ptr<jsonschema::json_schema<json>> sch;
+        {
+            jsonschema::schema_cache<json> cache;
+            sch = jsonschema::make_schema(json::parse(person_schema), counting_resolver(), cache);
+            cache.clear();
+        }
+        jsonschema::json_validator<json> validator(sch);
+        CHECK(validator.is_valid(json::parse(R"({"id":1})")));
+        CHECK_FALSE(validator.is_valid(json::parse(R"({"id":0})")));
+    }
+
+    SECTION("documents that refer to each other")
+    {
+        counting_resolver resolver;
+        jsonschema::schema_cache<json> cache;
+        json schema = json::parse(R"({"$ref": "http://example.com/tree.json"})");
+
+        jsonschema::json_validator<json> validator(jsonschema::make_schema(schema, resolver, cache));
+        std::size_t count = *resolver.count;
+        jsonschema::json_validator<json> validator2(jsonschema::make_schema(schema, resolver, cache));
+        CHECK(*resolver.count == count);
+
+        CHECK(validator.is_valid(json::parse(R"([{"id":1,"tree":[{"id":2,"tree":[]}]}])")));
+        CHECK_FALSE(validator.is_valid(json::parse(R"([{"id":1,"tree":[{"id":0}]}])")));
+        CHECK_FALSE(validator2.is_valid(json::parse(R"([{"id":1,"tree":[{"tree":{}}]}])")));
+    }
+
+    SECTION("undefined reference")
+    {
+        jsonschema::schema_cache<json> cache;
+        json schema = json::parse(R"({"$ref": "http://example.com/common.json#/definitions/other"})");
+        REQUIRE_THROWS_AS(jsonschema::make_schema(schema, counting_resolver(), cache), jsonschema::schema_error);
+    }
+
+    SECTION("the cache's regex engine is used for every document")
+    {
+        json schema = json::parse(R"(
+{
+    "properties": {
+        "code": { "$ref": "http://example.com/code.json" },
+        "name": { "pattern": "^x" }
+    }
+}
+        )");
+        json instance = json::parse(R"({"code":"abc","name":"xyz"})");
+
+        auto count = std::make_shared<std::size_t>(0);
+        jsonschema::schema_cache<json> cache(counting_engine(count));
+        jsonschema::schema_cache<json> default_cache;
+
+        jsonschema::json_validator<json> validator(jsonschema::make_schema(schema, counting_resolver(), cache));
+        CHECK(*count == 2);
+        CHECK_FALSE(validator.is_valid(instance));
+
+        // The cached document is not compiled again, the new schema's patterns are
+        jsonschema::json_validator<json> validator2(jsonschema::make_schema(schema, counting_resolver(), cache));
+        CHECK(*count == 3);
+        CHECK_FALSE(validator2.is_valid(instance));
+
+        // A cache with another engine doesn't see the documents compiled by the first
+        jsonschema::json_validator<json> default_validator(jsonschema::make_schema(schema, counting_resolver(), default_cache));
+        CHECK(*count == 3);
+        CHECK(default_validator.is_valid(instance));
+        CHECK_FALSE(default_validator.is_valid(json::parse(R"({"code":"bc"})")));
+    }
+
+    SECTION("shared by threads")
+    {
+        counting_resolver resolver;
+        jsonschema::schema_cache<json> cache;
+
+        std::vector<std::shared_ptr<jsonschema::json_schema<json>>> schemas(4);
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < schemas.size(); ++i)
+        {
+            threads.emplace_back([&schemas,&cache,resolver,i]()
+            {
+                schemas[i] = jsonschema::make_schema(json::parse(i % 2 == 0 ? person_schema : order_schema), resolver, cache);
+            });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        CHECK(cache.size() == 1);
+        for (const auto& sch : schemas)
+        {
+            jsonschema::json_validator<json> validator(sch);
+            CHECK_FALSE(validator.is_valid(json::parse(R"({"id":0,"order_id":0})")));
+        }
+    }
+}
+
+TEST_CASE("jsonschema schema snapshot")
+{
+    json schema = json::parse(R"(
+{
+    "type": "array",
+    "items": { "$ref": "http://example.com/node.json" }
+}
+    )");
+
+    counting_resolver resolver;
+    std::vector<uint8_t> buffer;
+    jsonschema::encode_schema_snapshot(schema, resolver, buffer);
+    std::size_t count = *resolver.count;
+    CHECK(count == 3);
+
+    SECTION("reload")
+    {
+        jsonschema::json_validator<json> validator(jsonschema::make_schema_from_snapshot<json>(buffer));
+        CHECK(*resolver.count == count);
+
+        jsonschema::json_validator<json> expected(jsonschema::make_schema(schema, resolver));
+        std::vector<json> instances = {
+            json::parse(R"([{"id":1,"tree":[{"id":2}]}])"),
+            json::parse(R"([{"id":1,"tree":[{"id":0}]}])"),
+            json::parse(R"([{"id":"1"}])")
+        };
+        for (const auto& instance : instances)
+        {
+            CHECK(validator.is_valid(instance) == expected.is_valid(instance));
+        }
+    }
+
+    SECTION("not a snapshot")
+    {
+        std::vector<uint8_t> other;
+        cbor::encode_cbor(json::parse(R"({"type":"integer"})"), other);
+        REQUIRE_THROWS_AS(jsonschema::make_schema_from_snapshot<json>(other), jsonschema::schema_error);
+    }
+}
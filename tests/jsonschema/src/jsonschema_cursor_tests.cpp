@@ -0,0 +1,185 @@
+// Copyright 2020 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#include <jsoncons_ext/jsonschema/jsonschema.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+
+#include <catch/catch.hpp>
+#include <iostream>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using jsoncons::json;
+using jsoncons::ojson;
+namespace jsonschema = jsoncons::jsonschema;
+namespace cbor = jsoncons::cbor;
+namespace msgpack = jsoncons::msgpack;
+
+namespace {
+
+    const std::string records_schema = R"(
+{
+    "type": "array",
+    "items": {
+        "type": "object",
+        "properties": {
+            "id": { "type": "integer", "minimum": 0 },
+            "name": { "type": "string", "maxLength": 8 },
+            "tags": { "type": "array", "items": { "type": "string" }, "uniqueItems": true },
+            "status": { "enum": ["active", "inactive"], "default": "active" }
+        },
+        "required": ["id", "name"],
+        "additionalProperties": false
+    },
+    "maxItems": 1000
+}
+    )";
+
+    std::vector<std::string> messages(const jsonschema::json_validator<json>& validator, jsoncons::json_cursor& cursor)
+    {
+        std::vector<std::string> result;
+        auto reporter = [&result](const jsonschema::validation_output& o)
+        {
+            result.push_back(o.instance_location() + ": " + o.message());
+        };
+        validator.validate(cursor, reporter);
+        return result;
+    }
+}
+
+TEST_CASE("jsonschema validate from cursor")
+{
+    auto sch = jsonschema::make_schema(json::parse(records_schema));
+    jsonschema::json_validator<json> validator(sch);
+
+    SECTION("valid")
+    {
+        std::string data = R"([{"id":1,"name":"a","tags":["x","y"],"status":"inactive"},{"id":2,"name":"b"}])";
+        jsoncons::json_cursor cursor(data);
+        CHECK(validator.is_valid(cursor));
+    }
+
+    SECTION("errors")
+    {
+        std::string data = R"([{"id":-1,"name":"a"},{"name":"abcdefghij","extra":{"x":[1,2]}},{"id":3,"name":"c","tags":["x","x"]}])";
+        jsoncons::json_cursor cursor(data);
+        auto result = messages(validator, cursor);
+
+        // The same errors as validating the whole document
+        std::vector<std::string> expected;
+        auto reporter = [&expected](const jsonschema::validation_output& o)
+        {
+            expected.push_back(o.instance_location() + ": " + o.message());
+        };
+        validator.validate(json::parse(data), reporter);
+
+        std::sort(result.begin(), result.end());
+        std::sort(expected.begin(), expected.end());
+        CHECK(result == expected);
+        CHECK(result.size() == 5);
+    }
+
+    SECTION("defaults")
+    {
+        std::string data = R"([{"id":1,"name":"a"},{"id":2,"name":"b","status":"inactive"}])";
+        jsoncons::json_cursor cursor(data);
+        json patch = validator.validate(cursor);
+        CHECK(patch == validator.validate(json::parse(data)));
+
+        json expected = json::parse(R"({"op":"add","path":"/0/status","value":"active"})");
+        bool found = std::find(patch.array_range().begin(), patch.array_range().end(), expected) != patch.array_range().end();
+        CHECK(found);
+    }
+
+    SECTION("the cursor is positioned after the value")
+    {
+        std::string data = R"([[{"id":1,"name":"a"}],[{"id":-1,"name":"b"}]])";
+        jsoncons::json_cursor cursor(data);
+        cursor.next();
+        CHECK(validator.is_valid(cursor));
+        cursor.next();
+        CHECK_FALSE(validator.is_valid(cursor));
+    }
+
+    SECTION("stops reading at the first error")
+    {
+        // The input is malformed after the first invalid record
+        std::string data = R"([{"id":1,"name":"a"},{"id":"2","name":"b"},{"id":3,)";
+        jsoncons::json_cursor cursor(data);
+        CHECK_FALSE(validator.is_valid(cursor));
+
+        jsoncons::json_cursor cursor2(data);
+        REQUIRE_THROWS_AS(validator.validate(cursor2), jsonschema::validation_error);
+    }
+
+    SECTION("malformed input")
+    {
+        std::string data = R"([{"id":1,"name":"a"},{"id":2,)";
+        jsoncons::json_cursor cursor(data);
+        REQUIRE_THROWS_AS(validator.is_valid(cursor), jsoncons::ser_error);
+    }
+
+    SECTION("large array")
+    {
+        json schema = json::parse(R"({"type":"array","items":{"type":"integer"},"maxItems":100000})");
+        jsonschema::json_validator<json> v(jsonschema::make_schema(schema));
+
+        std::ostringstream os;
+        os << "[";
+        for (int i = 0; i < 100001; ++i)
+        {
+            if (i > 0)
+            {
+                os << ",";
+            }
+            os << i;
+        }
+        os << "]";
+        std::string data = os.str();
+        jsoncons::json_cursor cursor(data);
+        std::vector<std::string> result = messages(v, cursor);
+        REQUIRE(result.size() == 1);
+        CHECK(result[0] == "#: Expected maximum item count: 100000, found: 100001");
+    }
+}
+
+TEST_CASE("jsonschema validate from binary cursors")
+{
+    auto sch = jsonschema::make_schema(json::parse(records_schema));
+    jsonschema::json_validator<json> validator(sch);
+
+    json valid = json::parse(R"([{"id":1,"name":"a","tags":["x"]},{"id":2,"name":"b"}])");
+    json invalid = json::parse(R"([{"id":1,"name":"a","tags":["x"]},{"id":2,"name":"b","other":true}])");
+
+    SECTION("cbor")
+    {
+        std::vector<uint8_t> buffer;
+        cbor::encode_cbor(valid, buffer);
+        cbor::cbor_bytes_cursor cursor(buffer);
+        CHECK(validator.is_valid(cursor));
+
+        buffer.clear();
+        cbor::encode_cbor(invalid, buffer);
+        cbor::cbor_bytes_cursor cursor2(buffer);
+        CHECK_FALSE(validator.is_valid(cursor2));
+    }
+
+    SECTION("msgpack")
+    {
+        std::vector<uint8_t> buffer;
+        msgpack::encode_msgpack(valid, buffer);
+        msgpack::msgpack_bytes_cursor cursor(buffer);
+        CHECK(validator.is_valid(cursor));
+
+        buffer.clear();
+        msgpack::encode_msgpack(invalid, buffer);
+        msgpack::msgpack_bytes_cursor cursor2(buffer);
+        CHECK_FALSE(validator.is_valid(cursor2));
+    }
+}
@@ -0,0 +1,215 @@
+// Copyright 2020 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#include <jsoncons_ext/jsonschema/jsonschema.hpp>
+
+#include <catch/catch.hpp>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using jsoncons::json;
+namespace jsonschema = jsoncons::jsonschema;
+
+namespace {
+
+    json resolve(const jsoncons::uri& uri)
+    {
+        JSONCONS_THROW(jsonschema::schema_error("Don't know how to load JSON Schema " + std::string(uri.base())));
+    }
+
+    // Matches strings that start with the pattern, and counts searches
+    class counting_matcher : public jsonschema::regex_matcher
+    {
+        std::string prefix_;
+        std::shared_ptr<std::size_t> count_;
+    public:
+        counting_matcher(const std::string& prefix, std::shared_ptr<std::size_t> count)
+            : prefix_(prefix), count_(count)
+        {
+        }
+
+        bool search(const jsoncons::string_view& s) const override
+        {
+            ++(*count_);
+            return s.size() >= prefix_.size() && s.substr(0, prefix_.size()) == jsoncons::string_view(prefix_);
+        }
+    };
+
+    struct counting_validator
+    {
+        std::shared_ptr<std::size_t> searches;
+        jsonschema::json_validator<json> validator;
+
+        counting_validator(const json& schema)
+            : searches(std::make_shared<std::size_t>(0)), validator(compile(schema, searches))
+        {
+        }
+
+        std::size_t errors(const json& instance) const
+        {
+            std::size_t count = 0;
+            auto reporter = [&count](const jsonschema::validation_output&)
+            {
+                ++count;
+            };
+            validator.validate(instance, reporter);
+            return count;
+        }
+
+        static std::shared_ptr<jsonschema::json_schema<json>> compile(const json& schema, std::shared_ptr<std::size_t> searches)
+        {
+            jsonschema::regex_engine engine = [searches](const std::string& pattern) -> jsonschema::regex_matcher_pointer
+            {
+                return std::make_shared<counting_matcher>(pattern, searches);
+            };
+            return jsonschema::make_schema(schema, resolve, engine);
+        }
+    };
+}
+
+TEST_CASE("jsonschema is_valid stops at the first error")
+{
+    SECTION("items")
+    {
+        counting_validator v(json::parse(R"({"type":"array","items":{"type":"string","pattern":"a"}})"));
+        json instance = json::parse(R"([1,"a","b","c"])");
+
+        CHECK_FALSE(v.validator.is_valid(instance));
+        CHECK(*v.searches == 0);
+
+        CHECK(v.errors(instance) == 3);
+        CHECK(*v.searches == 3);
+    }
+
+    SECTION("properties")
+    {
+        counting_validator v(json::parse(R"(
+{
+    "type": "object",
+    "properties": {
+        "a": { "type": "integer" },
+        "b": { "type": "string", "pattern": "x" },
+        "c": { "type": "string", "pattern": "x" }
+    }
+}
+        )"));
+        json instance = json::parse(R"({"a":"1","b":"y","c":"y"})");
+
+        CHECK_FALSE(v.validator.is_valid(instance));
+        CHECK(*v.searches == 0);
+
+        CHECK(v.errors(instance) == 3);
+        CHECK(*v.searches == 2);
+    }
+
+    SECTION("required before the members")
+    {
+        counting_validator v(json::parse(R"({"properties":{"b":{"pattern":"x"}},"required":["a"]})"));
+
+        CHECK_FALSE(v.validator.is_valid(json::parse(R"({"b":"x"})")));
+        CHECK(*v.searches == 0);
+    }
+
+    SECTION("const before pattern")
+    {
+        counting_validator v(json::parse(R"({"type":"string","pattern":"z","const":"zzz"})"));
+
+        CHECK_FALSE(v.validator.is_valid(json("abc")));
+        CHECK(*v.searches == 0);
+        CHECK(v.validator.is_valid(json("zzz")));
+    }
+}
+
+TEST_CASE("jsonschema combined subschemas are evaluated cheapest first")
+{
+    SECTION("allOf fails on the cheap subschema")
+    {
+        counting_validator v(json::parse(R"({"allOf":[{"type":"string","pattern":"a","minLength":2},{"type":"integer"}]})"));
+
+        CHECK_FALSE(v.validator.is_valid(json("abc")));
+        CHECK(*v.searches == 0);
+    }
+
+    SECTION("anyOf succeeds on the cheap subschema")
+    {
+        counting_validator v(json::parse(R"({"anyOf":[{"type":"string","pattern":"a"},{"type":"string","maxLength":5}]})"));
+
+        CHECK(v.validator.is_valid(json("xyz")));
+        CHECK(*v.searches == 0);
+
+        CHECK(v.validator.is_valid(json("abcdefgh")));
+        CHECK(*v.searches == 1);
+
+        CHECK_FALSE(v.validator.is_valid(json("xyzxyzxyz")));
+    }
+
+}
+
+TEST_CASE("jsonschema validate keeps the declaration order")
+{
+    SECTION("nested errors")
+    {
+        counting_validator v(json::parse(R"({"anyOf":[{"type":"string","pattern":"a"},{"type":"integer"}]})"));
+
+        std::vector<std::string> keywords;
+        auto reporter = [&keywords](const jsonschema::validation_output& o)
+        {
+            for (const auto& nested : o.nested_errors())
+            {
+                keywords.push_back(nested.keyword());
+            }
+        };
+        v.validator.validate(json("x"), reporter);
+        REQUIRE(keywords.size() == 2);
+        CHECK(keywords[0] == "pattern");
+        CHECK(keywords[1] == "type");
+    }
+
+    SECTION("defaults of the first anyOf subschema that matches")
+    {
+        json schema = json::parse(R"(
+{
+    "anyOf": [
+        { "properties": { "a": { "default": 1 }, "c": { "type": "string", "pattern": "x", "format": "email" } } },
+        { "properties": { "b": { "default": 2 } } }
+    ]
+}
+        )");
+        jsonschema::json_validator<json> validator(jsonschema::make_schema(schema));
+
+        json instance = json::object();
+        CHECK(validator.is_valid(instance));
+
+        json patch = validator.validate(instance, [](const jsonschema::validation_output&) {});
+        std::vector<std::string> paths;
+        for (const auto& op : patch.array_range())
+        {
+            paths.push_back(op["path"].as<std::string>());
+        }
+        CHECK(std::find(paths.begin(), paths.end(), "/a") != paths.end());
+        CHECK(std::find(paths.begin(), paths.end(), "/b") == paths.end());
+    }
+
+    SECTION("type, enum and const errors")
+    {
+        json schema = json::parse(R"({"type":"string","enum":["a"],"const":"b"})");
+        jsonschema::json_validator<json> validator(jsonschema::make_schema(schema));
+
+        std::vector<std::string> keywords;
+        auto reporter = [&keywords](const jsonschema::validation_output& o)
+        {
+            keywords.push_back(o.keyword());
+        };
+        validator.validate(json(1), reporter);
+        REQUIRE(keywords.size() == 3);
+        CHECK(keywords[0] == "type");
+        CHECK(keywords[1] == "enum");
+        CHECK(keywords[2] == "const");
+    }
+}
@@ -11,6 +11,7 @@
 #include <fstream>
 #include <iostream>
 #include <regex>
+#include <vector>
 
 using jsoncons::json;
 namespace jsonschema = jsoncons::jsonschema;
@@ -95,3 +96,55 @@ TEST_CASE("jsonschema output format tests")
 /1: Required key "y" not found
 /1: Validation failed for additional property "z". False schema always fails
 */
+
+TEST_CASE("jsonschema instance locations")
+{
+    json schema = json::parse(R"(
+{
+    "type": "object",
+    "properties": {
+        "a/b": { 
+            "type": "array", 
+            "items": { "type": "object", "additionalProperties": { "type": "integer" } } 
+        },
+        "m~n": { "type": "string", "minLength": 2, "default": "xy" }
+    }
+}
+    )");
+
+    auto sch = jsonschema::make_schema(schema);
+    jsonschema::json_validator<json> validator(sch);
+
+    SECTION("escaped names and indices")
+    {
+        json instance = json::parse(R"({"a/b":[{"x":1},{"y":1,"z":"2"}],"m~n":"q"})");
+
+        std::vector<std::string> locations;
+        auto reporter = [&locations](const jsonschema::validation_output& o)
+        {
+            locations.push_back(o.instance_location());
+        };
+        validator.validate(instance, reporter);
+
+        REQUIRE(locations.size() == 2);
+        CHECK(locations[0] == "#/a~1b/1");
+        CHECK(locations[1] == "#/m~0n");
+    }
+
+    SECTION("default value paths")
+    {
+        json instance = json::parse(R"({"a/b":[]})");
+        json patch = validator.validate(instance);
+
+        bool found = false;
+        for (const auto& op : patch.array_range())
+        {
+            if (op["path"] == json("/m~0n"))
+            {
+                found = true;
+                CHECK(op["value"] == json("xy"));
+            }
+        }
+        CHECK(found);
+    }
+}
@@ -0,0 +1,171 @@
+// Copyright 2020 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#include <jsoncons_ext/jsonschema/jsonschema.hpp>
+
+#include <catch/catch.hpp>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using jsoncons::json;
+namespace jsonschema = jsoncons::jsonschema;
+
+namespace {
+
+    const std::string record_schema = R"(
+{
+    "type": "object",
+    "properties": {
+        "id": { "type": "integer", "minimum": 0 },
+        "name": { "type": "string", "pattern": "^[a-z]+$" },
+        "status": { "enum": ["active", "inactive"], "default": "active" }
+    },
+    "required": ["id", "name"]
+}
+    )";
+
+    json make_record(std::size_t i)
+    {
+        json record(jsoncons::json_object_arg);
+        // Every 7th record has a negative id, every 11th a name that doesn't match
+        record.try_emplace("id", i % 7 == 3 ? -static_cast<int64_t>(i) : static_cast<int64_t>(i));
+        record.try_emplace("name", i % 11 == 5 ? std::string("Name") : std::string("name"));
+        if (i % 2 == 0)
+        {
+            record.try_emplace("status", "inactive");
+        }
+        return record;
+    }
+
+    std::vector<std::string> messages(const jsonschema::json_validator<json>& validator, const json& instance)
+    {
+        std::vector<std::string> result;
+        auto reporter = [&result](const jsonschema::validation_output& o)
+        {
+            result.push_back(o.instance_location() + ": " + o.message());
+        };
+        validator.validate(instance, reporter);
+        return result;
+    }
+}
+
+TEST_CASE("jsonschema batch validation")
+{
+    auto sch = jsonschema::make_schema(json::parse(record_schema));
+    jsonschema::json_validator<json> sequential(sch);
+    jsonschema::json_validator<json> validator(sch, 4);
+
+    std::vector<json> records;
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        records.push_back(make_record(i));
+    }
+
+    SECTION("is_valid")
+    {
+        std::vector<bool> valid = validator.is_valid(records.begin(), records.end());
+        REQUIRE(valid.size() == records.size());
+        for (std::size_t i = 0; i < records.size(); ++i)
+        {
+            INFO(i);
+            CHECK(valid[i] == sequential.is_valid(records[i]));
+        }
+    }
+
+    SECTION("validate")
+    {
+        std::vector<std::pair<std::size_t,std::string>> result;
+        auto reporter = [&result](std::size_t index, const jsonschema::validation_output& o)
+        {
+            result.emplace_back(index, o.instance_location() + ": " + o.message());
+        };
+        std::vector<json> patches = validator.validate(records.begin(), records.end(), reporter);
+        REQUIRE(patches.size() == records.size());
+
+        std::vector<std::pair<std::size_t,std::string>> expected;
+        for (std::size_t i = 0; i < records.size(); ++i)
+        {
+            for (const auto& message : messages(sequential, records[i]))
+            {
+                expected.emplace_back(i, message);
+            }
+            CHECK(patches[i] == sequential.validate(records[i], [](const jsonschema::validation_output&){}));
+        }
+        CHECK(result == expected);
+    }
+
+    SECTION("empty batch")
+    {
+        std::vector<json> none;
+        CHECK(validator.is_valid(none.begin(), none.end()).empty());
+    }
+}
+
+TEST_CASE("jsonschema parallel validation of array items")
+{
+    json schema = json::parse(R"({"type":"array","items":)" + record_schema + "}");
+    auto sch = jsonschema::make_schema(schema);
+    jsonschema::json_validator<json> sequential(sch);
+    jsonschema::json_validator<json> validator(sch, 4);
+
+    json records(jsoncons::json_array_arg);
+    for (std::size_t i = 0; i < 5000; ++i)
+    {
+        records.push_back(make_record(i));
+    }
+
+    SECTION("errors are reported in order")
+    {
+        std::vector<std::string> result = messages(validator, records);
+        CHECK_FALSE(result.empty());
+        CHECK(result == messages(sequential, records));
+    }
+
+    SECTION("defaults")
+    {
+        json patch = validator.validate(records, [](const jsonschema::validation_output&){});
+        CHECK(patch.size() == 2500);
+        CHECK(patch == sequential.validate(records, [](const jsonschema::validation_output&){}));
+    }
+
+    SECTION("first error")
+    {
+        CHECK_FALSE(validator.is_valid(records));
+
+        std::string expected;
+        try
+        {
+            sequential.validate(records);
+        }
+        catch (const jsonschema::validation_error& e)
+        {
+            expected = e.what();
+        }
+        REQUIRE_FALSE(expected.empty());
+        try
+        {
+            validator.validate(records);
+            CHECK(false);
+        }
+        catch (const jsonschema::validation_error& e)
+        {
+            CHECK(std::string(e.what()) == expected);
+        }
+    }
+
+    SECTION("valid")
+    {
+        json valid(jsoncons::json_array_arg);
+        for (std::size_t i = 0; i < 5000; ++i)
+        {
+            valid.push_back(make_record(i*7*11));
+        }
+        CHECK(validator.is_valid(valid));
+        CHECK(messages(validator, valid).empty());
+    }
+}
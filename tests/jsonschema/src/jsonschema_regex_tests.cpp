@@ -0,0 +1,222 @@
+// Copyright 2020 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#include <jsoncons_ext/jsonschema/jsonschema.hpp>
+
+#include <catch/catch.hpp>
+#include <iostream>
+#include <string>
+
+using jsoncons::json;
+namespace jsonschema = jsoncons::jsonschema;
+
+namespace {
+
+    json resolve(const jsoncons::uri& uri)
+    {
+        JSONCONS_THROW(jsonschema::schema_error("Don't know how to load JSON Schema " + std::string(uri.base())));
+    }
+
+    class prefix_matcher : public jsonschema::regex_matcher
+    {
+        std::string prefix_;
+    public:
+        prefix_matcher(const std::string& prefix)
+            : prefix_(prefix)
+        {
+        }
+
+        bool search(const jsoncons::string_view& s) const override
+        {
+            return s.size() >= prefix_.size() && s.substr(0, prefix_.size()) == jsoncons::string_view(prefix_);
+        }
+    };
+}
+
+TEST_CASE("jsonschema default regex engine")
+{
+    auto engine = jsonschema::default_regex_engine();
+
+    SECTION("search is unanchored")
+    {
+        auto re = engine("b+c");
+        REQUIRE(re != nullptr);
+        CHECK(re->search("abbbcd"));
+        CHECK_FALSE(re->search("ac"));
+    }
+
+    SECTION("anchors and classes")
+    {
+        auto re = engine("^[a-z][a-z0-9_]*$");
+        REQUIRE(re != nullptr);
+        CHECK(re->search("abc_123"));
+        CHECK_FALSE(re->search("1abc"));
+        CHECK_FALSE(re->search("abc-d"));
+    }
+
+    SECTION("counted repetition")
+    {
+        auto re = engine("^\\d{3}-\\d{2,4}$");
+        REQUIRE(re != nullptr);
+        CHECK(re->search("123-45"));
+        CHECK(re->search("123-4567"));
+        CHECK_FALSE(re->search("123-45678"));
+        CHECK_FALSE(re->search("12-45"));
+    }
+
+    SECTION("code points outside the BMP match a single .")
+    {
+        auto re = engine("^.$");
+        REQUIRE(re != nullptr);
+        CHECK(re->search("\xF0\x9F\x90\xB2")); // U+1F432
+        CHECK_FALSE(re->search("ab"));
+    }
+
+    SECTION("pathological pattern")
+    {
+        auto re = engine("^(a+)+$");
+        REQUIRE(re != nullptr);
+        std::string s(64, 'a');
+        CHECK(re->search(s));
+        s.push_back('b');
+        CHECK_FALSE(re->search(s));
+    }
+
+    SECTION("invalid pattern")
+    {
+        REQUIRE_THROWS_AS(engine("(abc"), jsonschema::schema_error);
+        REQUIRE_THROWS_AS(engine("[z-a]"), jsonschema::schema_error);
+    }
+}
+
+TEST_CASE("jsonschema pattern and patternProperties")
+{
+    json schema = json::parse(R"(
+{
+    "type": "object",
+    "properties": {
+        "code": { "type": "string", "pattern": "^[A-Z]{3}$" }
+    },
+    "patternProperties": {
+        "^x-": { "type": "string" },
+        "_id$": { "type": "integer" }
+    },
+    "additionalProperties": false
+}
+    )");
+
+    auto sch = jsonschema::make_schema(schema);
+    jsonschema::json_validator<json> validator(sch);
+
+    SECTION("valid instance")
+    {
+        json instance = json::parse(R"({"code":"ABC","x-note":"a","user_id":1,"x-other":"b"})");
+        CHECK(validator.is_valid(instance));
+    }
+
+    SECTION("pattern mismatch")
+    {
+        json instance = json::parse(R"({"code":"AB1"})");
+        CHECK_FALSE(validator.is_valid(instance));
+    }
+
+    SECTION("patternProperties schema mismatch")
+    {
+        json instance = json::parse(R"({"x-id":"a","user_id":"1"})");
+        CHECK_FALSE(validator.is_valid(instance));
+    }
+
+    SECTION("property that matches both patterns")
+    {
+        json instance = json::parse(R"({"x-user_id":1})");
+        CHECK_FALSE(validator.is_valid(instance));
+    }
+
+    SECTION("additional property")
+    {
+        json instance = json::parse(R"({"other":1})");
+        CHECK_FALSE(validator.is_valid(instance));
+    }
+
+    SECTION("repeated validation")
+    {
+        json instance = json::parse(R"({"x-note":"a","user_id":1})");
+        for (int i = 0; i < 3; ++i)
+        {
+            CHECK(validator.is_valid(instance));
+        }
+        json invalid = json::parse(R"({"x-note":1,"user_id":1})");
+        for (int i = 0; i < 3; ++i)
+        {
+            CHECK_FALSE(validator.is_valid(invalid));
+        }
+    }
+}
+
+TEST_CASE("jsonschema invalid pattern")
+{
+    json schema = json::parse(R"({"type": "string", "pattern": "a(b"})");
+    REQUIRE_THROWS_AS(jsonschema::make_schema(schema), jsonschema::schema_error);
+}
+
+TEST_CASE("jsonschema pattern the automaton cannot compile")
+{
+    json schema = json::parse(R"(
+{
+    "properties": {
+        "word": { "type": "string", "pattern": "\\bcat\\b" }
+    },
+    "patternProperties": {
+        "^(?!x-|word).": { "type": "integer" }
+    }
+}
+    )");
+
+#if defined(JSONCONS_HAS_STD_REGEX)
+    auto sch = jsonschema::make_schema(schema);
+    jsonschema::json_validator<json> validator(sch);
+
+    CHECK(validator.is_valid(json::parse(R"({"word":"a cat"})")));
+    CHECK_FALSE(validator.is_valid(json::parse(R"({"word":"concat"})")));
+    CHECK(validator.is_valid(json::parse(R"({"x-note":"a"})")));
+    CHECK_FALSE(validator.is_valid(json::parse(R"({"note":"a"})")));
+#else
+    // Rejected when the schema is loaded rather than ignored
+    REQUIRE_THROWS_AS(jsonschema::make_schema(schema), jsonschema::schema_error);
+#endif
+}
+
+TEST_CASE("jsonschema custom regex engine")
+{
+    json schema = json::parse(R"(
+{
+    "properties": {
+        "name": { "type": "string", "pattern": "abc" }
+    },
+    "patternProperties": {
+        "abc": { "type": "integer" }
+    }
+}
+    )");
+
+    std::size_t count = 0;
+    jsonschema::regex_engine engine = [&count](const std::string& pattern) -> jsonschema::regex_matcher_pointer
+    {
+        ++count;
+        return std::make_shared<prefix_matcher>(pattern);
+    };
+
+    auto sch = jsonschema::make_schema(schema, resolve, engine);
+    jsonschema::json_validator<json> validator(sch);
+
+    // The same pattern is compiled once
+    CHECK(count == 1);
+
+    CHECK(validator.is_valid(json::parse(R"({"name":"abcd","abcd":1})")));
+    CHECK(validator.is_valid(json::parse(R"({"xabc":"a"})")));
+    CHECK_FALSE(validator.is_valid(json::parse(R"({"name":"xabc"})")));
+    CHECK_FALSE(validator.is_valid(json::parse(R"({"abcd":"a"})")));
+}
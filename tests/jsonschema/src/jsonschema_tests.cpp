@@ -64,6 +64,13 @@ namespace {
                     }
                 };
                 validator.validate(test_case.at("data"), reporter);
+
+                // Validating as the data is read gives the same result
+                std::string data;
+                test_case.at("data").dump(data);
+                jsoncons::json_cursor cursor(data);
+                INFO(fpath << ": " << test_case["description"].as<std::string>());
+                CHECK(validator.is_valid(cursor) == validator.is_valid(test_case.at("data")));
             }
         }
     }
@@ -74,9 +81,7 @@ TEST_CASE("jsonschema-tests")
     SECTION("compliance")
     {
         jsonschema_tests("./jsonschema/input/compliance/draft7/additionalItems.json");
-#ifdef JSONCONS_HAS_STD_REGEX
         jsonschema_tests("./jsonschema/input/compliance/draft7/additionalProperties.json");
-#endif
         jsonschema_tests("./jsonschema/input/compliance/draft7/allOf.json");
         jsonschema_tests("./jsonschema/input/compliance/draft7/anyOf.json");
         jsonschema_tests("./jsonschema/input/compliance/draft7/boolean_schema.json");
@@ -108,11 +113,9 @@ TEST_CASE("jsonschema-tests")
         jsonschema_tests("./jsonschema/input/compliance/draft7/multipleOf.json");
         jsonschema_tests("./jsonschema/input/compliance/draft7/not.json");
         jsonschema_tests("./jsonschema/input/compliance/draft7/oneOf.json");
-#ifdef JSONCONS_HAS_STD_REGEX
         jsonschema_tests("./jsonschema/input/compliance/draft7/pattern.json");
         jsonschema_tests("./jsonschema/input/compliance/draft7/patternProperties.json");
         jsonschema_tests("./jsonschema/input/compliance/draft7/properties.json");
-#endif
 
         jsonschema_tests("./jsonschema/input/compliance/draft7/propertyNames.json");
 
@@ -146,5 +149,50 @@ TEST_CASE("jsonschema-tests")
         //jsonschema_tests("./jsonschema/input/compliance/draft7/optional/format/uri-template.json");
 
         jsonschema_tests("./jsonschema/input/compliance/draft7/optional/content.json");
+        jsonschema_tests("./jsonschema/input/compliance/draft7/optional/ecmascript-regex.json");
+        jsonschema_tests("./jsonschema/input/compliance/draft7/optional/non-bmp-regex.json");
+    }
+}
+
+TEST_CASE("jsonschema uniqueItems and enum on large inputs")
+{
+    SECTION("uniqueItems")
+    {
+        json schema = json::parse(R"({"uniqueItems": true})");
+        jsonschema::json_validator<json> validator(jsonschema::make_schema(schema));
+
+        json instance(jsoncons::json_array_arg);
+        for (int i = 0; i < 50000; ++i)
+        {
+            instance.push_back("id-" + std::to_string(i));
+        }
+        instance.push_back(json::parse(R"({"a":1,"b":[1,2]})"));
+        instance.push_back(json::parse(R"({"b":[1,2],"a":2})"));
+        CHECK(validator.is_valid(instance));
+
+        instance.push_back(json::parse(R"({"b":[1.0,2],"a":1.0})"));
+        CHECK_FALSE(validator.is_valid(instance));
+
+        json numbers = json::parse("[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,1.0]");
+        CHECK_FALSE(validator.is_valid(numbers));
+    }
+
+    SECTION("enum")
+    {
+        json values(jsoncons::json_array_arg);
+        for (int i = 0; i < 1000; ++i)
+        {
+            values.push_back(i);
+        }
+        values.push_back(json::parse(R"({"name":"x"})"));
+        json schema(jsoncons::json_object_arg);
+        schema.try_emplace("enum", values);
+        jsonschema::json_validator<json> validator(jsonschema::make_schema(schema));
+
+        CHECK(validator.is_valid(json(999)));
+        CHECK(validator.is_valid(json(999.0)));
+        CHECK(validator.is_valid(json::parse(R"({"name":"x"})")));
+        CHECK_FALSE(validator.is_valid(json(1000)));
+        CHECK_FALSE(validator.is_valid(json("1")));
     }
 }
@@ -0,0 +1,201 @@
+// Copyright 2020 Daniel Parker
+// Distributed under Boost license
+
+#if defined(_MSC_VER)
+#include "windows.h" // test no inadvertant macro expansions
+#endif
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <jsoncons_ext/msgpack/msgpack_cbor_transcode.hpp>
+#include <catch/catch.hpp>
+#include <vector>
+#include <string>
+
+using namespace jsoncons;
+
+TEST_CASE("cbor_to_msgpack tests")
+{
+    SECTION("same encoding as visitor path")
+    {
+        std::vector<json> items;
+        items.push_back(json::parse(R"({"id":1,"name":"first","tags":["a","b"]})"));
+        items.push_back(json::parse(R"([0,23,24,255,256,65535,65536,4294967295,4294967296,18446744073709551615])"));
+        items.push_back(json::parse(R"([-1,-32,-33,-128,-129,-32768,-32769,-2147483648,-2147483649,-9223372036854775808])"));
+        items.push_back(json(std::string(300, 'x')));
+        items.push_back(json(byte_string{1,2,3}));
+        items.push_back(json::parse(R"([null,true,false,[],{}])"));
+
+        for (const auto& item : items)
+        {
+            std::vector<uint8_t> c;
+            cbor::encode_cbor(item, c);
+            std::vector<uint8_t> expected;
+            msgpack::encode_msgpack(item, expected);
+
+            std::vector<uint8_t> m;
+            msgpack::cbor_to_msgpack(c, m);
+            CHECK(m == expected);
+        }
+    }
+
+    SECTION("floating point")
+    {
+        std::vector<uint8_t> c = {0x82,0xfa,0x3f,0xc0,0x00,0x00, // 1.5f
+                                  0xfb,0x3f,0xb9,0x99,0x99,0x99,0x99,0x99,0x9a}; // 0.1
+        std::vector<uint8_t> m;
+        msgpack::cbor_to_msgpack(c, m);
+        std::vector<uint8_t> expected = {0x92,0xca,0x3f,0xc0,0x00,0x00,
+                                         0xcb,0x3f,0xb9,0x99,0x99,0x99,0x99,0x99,0x9a};
+        CHECK(m == expected);
+    }
+
+    SECTION("indefinite length containers")
+    {
+        // {_ "a": [_ 1, 2], "b": "c"}
+        std::vector<uint8_t> c = {0xbf,0x61,'a',0x9f,0x01,0x02,0xff,0x61,'b',0x61,'c',0xff};
+        std::vector<uint8_t> m;
+        msgpack::cbor_to_msgpack(c, m);
+        CHECK(msgpack::decode_msgpack<json>(m) == json::parse(R"({"a":[1,2],"b":"c"})"));
+    }
+
+    SECTION("items on the visitor path")
+    {
+        // [1(1363896240), 0xf9 half 1.0, (_ h'01', h'02'), -18446744073709551616]
+        std::vector<uint8_t> c = {0x84,
+                                  0xc1,0x1a,0x51,0x4b,0x67,0xb0,
+                                  0xf9,0x3c,0x00,
+                                  0x5f,0x41,0x01,0x41,0x02,0xff,
+                                  0x3b,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff};
+        std::vector<uint8_t> m;
+        msgpack::cbor_to_msgpack(c, m);
+
+        std::vector<uint8_t> expected;
+        {
+            msgpack::msgpack_bytes_encoder encoder(expected);
+            cbor::cbor_bytes_reader reader(c, encoder);
+            reader.read();
+        }
+        CHECK(m == expected);
+        json j = msgpack::decode_msgpack<json>(m);
+        REQUIRE(j.size() == 4);
+        CHECK(j[0].as<int64_t>() == 1363896240);
+        CHECK(j[1].as<double>() == 1.0);
+        CHECK(j[2].as<byte_string>() == byte_string{1,2});
+    }
+
+    SECTION("errors")
+    {
+        std::error_code ec;
+        std::vector<uint8_t> m;
+
+        std::vector<uint8_t> truncated = {0x82,0x01};
+        msgpack::cbor_to_msgpack(truncated, m, ec);
+        CHECK(ec == cbor::cbor_errc::unexpected_eof);
+        REQUIRE_THROWS(msgpack::cbor_to_msgpack(truncated, m));
+
+        ec = std::error_code();
+        std::vector<uint8_t> bad_utf8 = {0x61,0xff};
+        msgpack::cbor_to_msgpack(bad_utf8, m, ec);
+        CHECK(ec == cbor::cbor_errc::invalid_utf8_text_string);
+        CHECK(m.empty());
+
+        ec = std::error_code();
+        std::vector<uint8_t> trailing = {0x82,0x01,0x02,0x03};
+        msgpack::cbor_to_msgpack(trailing, m, ec);
+        CHECK(ec == cbor::cbor_errc::trailing_data);
+        CHECK(m.empty());
+        REQUIRE_THROWS(msgpack::cbor_to_msgpack(trailing, m));
+    }
+
+    SECTION("dest is restored on failure")
+    {
+        std::vector<uint8_t> m = {0xc0};
+        std::error_code ec;
+        std::vector<uint8_t> truncated = {0x83,0x01,0x61,'a'};
+        msgpack::cbor_to_msgpack(truncated, m, ec);
+        CHECK(ec == cbor::cbor_errc::unexpected_eof);
+        CHECK(m == std::vector<uint8_t>{0xc0});
+    }
+}
+
+TEST_CASE("msgpack_to_cbor tests")
+{
+    SECTION("same encoding as visitor path")
+    {
+        std::vector<json> items;
+        items.push_back(json::parse(R"({"id":1,"name":"first","tags":["a","b"]})"));
+        items.push_back(json::parse(R"([0,23,24,255,256,65535,65536,4294967295,4294967296,18446744073709551615])"));
+        items.push_back(json::parse(R"([-1,-32,-33,-128,-129,-32768,-32769,-2147483648,-2147483649,-9223372036854775808])"));
+        items.push_back(json(std::string(300, 'x')));
+        items.push_back(json(byte_string{1,2,3}));
+        items.push_back(json::parse(R"([null,true,false,[],{},1.5])"));
+
+        for (const auto& item : items)
+        {
+            std::vector<uint8_t> m;
+            msgpack::encode_msgpack(item, m);
+            std::vector<uint8_t> expected;
+            cbor::encode_cbor(item, expected);
+
+            std::vector<uint8_t> c;
+            msgpack::msgpack_to_cbor(m, c);
+            CHECK(c == expected);
+        }
+    }
+
+    SECTION("timestamp ext")
+    {
+        std::vector<uint8_t> m = {0x92,0xd6,0xff,0x51,0x4b,0x67,0xb0,0x01}; // [timestamp 32, 1]
+        std::vector<uint8_t> c;
+        msgpack::msgpack_to_cbor(m, c);
+        std::vector<uint8_t> expected = {0x82,0xc1,0x1a,0x51,0x4b,0x67,0xb0,0x01};
+        CHECK(c == expected);
+    }
+
+    SECTION("round trip")
+    {
+        json j = json::parse(R"({"a":[1,-2,"three",{"four":4.25}],"b":null})");
+        std::vector<uint8_t> m;
+        msgpack::encode_msgpack(j, m);
+        std::vector<uint8_t> c;
+        msgpack::msgpack_to_cbor(m, c);
+        std::vector<uint8_t> m2;
+        msgpack::cbor_to_msgpack(c, m2);
+        CHECK(m2 == m);
+    }
+
+    SECTION("errors")
+    {
+        std::error_code ec;
+        std::vector<uint8_t> c;
+
+        std::vector<uint8_t> truncated = {0x92,0x01};
+        msgpack::msgpack_to_cbor(truncated, c, ec);
+        CHECK(ec == msgpack::msgpack_errc::unexpected_eof);
+        REQUIRE_THROWS(msgpack::msgpack_to_cbor(truncated, c));
+
+        ec = std::error_code();
+        std::vector<uint8_t> unknown = {0x91,0xc1};
+        msgpack::msgpack_to_cbor(unknown, c, ec);
+        CHECK(ec == msgpack::msgpack_errc::unknown_type);
+        CHECK(c.empty());
+
+        ec = std::error_code();
+        std::vector<uint8_t> trailing = {0x92,0x01,0x02,0x03};
+        msgpack::msgpack_to_cbor(trailing, c, ec);
+        CHECK(ec == msgpack::msgpack_errc::trailing_data);
+        CHECK(c.empty());
+        REQUIRE_THROWS(msgpack::msgpack_to_cbor(trailing, c));
+    }
+
+    SECTION("dest is restored on failure")
+    {
+        std::vector<uint8_t> c = {0xf6};
+        std::error_code ec;
+        std::vector<uint8_t> truncated = {0x93,0x01,0xa1,'a'};
+        msgpack::msgpack_to_cbor(truncated, c, ec);
+        CHECK(ec == msgpack::msgpack_errc::unexpected_eof);
+        CHECK(c == std::vector<uint8_t>{0xf6});
+    }
+}
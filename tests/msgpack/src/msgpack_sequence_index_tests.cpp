@@ -0,0 +1,104 @@
+// Copyright 2020 Daniel Parker
+// Distributed under Boost license
+
+#if defined(_MSC_VER)
+#include "windows.h" // test no inadvertant macro expansions
+#endif
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <catch/catch.hpp>
+#include <vector>
+#include <string>
+#include <type_traits>
+
+using namespace jsoncons;
+
+// The index points into its source, so it can't be made from a temporary
+static_assert(std::is_constructible<msgpack::msgpack_sequence_index,const std::vector<uint8_t>&>::value, "");
+static_assert(!std::is_constructible<msgpack::msgpack_sequence_index,std::vector<uint8_t>>::value, "");
+static_assert(!std::is_constructible<msgpack::msgpack_sequence_index,std::vector<uint8_t>,std::vector<std::size_t>>::value, "");
+
+TEST_CASE("msgpack_sequence_index tests")
+{
+    std::vector<json> items;
+    items.push_back(json::parse(R"({"id":1,"name":"first","tags":["a","b"]})"));
+    items.push_back(json(-1000));
+    items.push_back(json(byte_string{1,2,3}));
+    items.push_back(json::parse(R"([1.5,"a long text string that is more than thirty one bytes",null,true,18446744073709551615])"));
+    items.push_back(json(std::string(300, 'x')));
+
+    std::vector<uint8_t> data;
+    for (const auto& item : items)
+    {
+        std::vector<uint8_t> buf;
+        msgpack::encode_msgpack(item, buf);
+        data.insert(data.end(), buf.begin(), buf.end());
+    }
+
+    SECTION("random access")
+    {
+        msgpack::msgpack_sequence_index index(data);
+        REQUIRE(index.size() == items.size());
+        CHECK(index.offset(0) == 0);
+        for (std::size_t i = items.size(); i-- > 0; )
+        {
+            json j = msgpack::decode_msgpack<json>(index.item(i));
+            CHECK(j == items[i]);
+        }
+    }
+
+    SECTION("restore from offsets")
+    {
+        msgpack::msgpack_sequence_index index(data);
+        msgpack::msgpack_sequence_index other(data, index.offsets());
+        REQUIRE(other.size() == items.size());
+        CHECK(msgpack::decode_msgpack<json>(other.item(3)) == items[3]);
+    }
+
+    SECTION("restore from invalid offsets")
+    {
+        std::vector<std::vector<std::size_t>> invalid = {
+            {0, 5, 5},
+            {3, 1},
+            {0, data.size()},
+            {data.size() + 10}
+        };
+        for (const auto& offsets : invalid)
+        {
+            std::error_code ec;
+            msgpack::msgpack_sequence_index index(data, offsets, ec);
+            CHECK(ec == msgpack::msgpack_errc::invalid_offsets);
+            CHECK(index.size() == 0);
+            REQUIRE_THROWS_AS(msgpack::msgpack_sequence_index(data, offsets), ser_error);
+        }
+    }
+
+    SECTION("ext types")
+    {
+        std::vector<uint8_t> v = {0xd6,0xff,0x00,0x00,0x00,0x01, // timestamp 32
+                                  0xc7,0x02,0x05,0xaa,0xbb, // ext 8
+                                  0x01};
+        msgpack::msgpack_sequence_index index(v);
+        REQUIRE(index.size() == 3);
+        CHECK(index.offset(1) == 6);
+        CHECK(index.offset(2) == 11);
+    }
+
+    SECTION("truncated item")
+    {
+        std::vector<uint8_t> v(data.begin(), data.end()-1);
+        std::error_code ec;
+        msgpack::msgpack_sequence_index index(v, msgpack::msgpack_decode_options(), ec);
+        CHECK(ec == msgpack::msgpack_errc::unexpected_eof);
+        CHECK(index.size() == 0);
+        REQUIRE_THROWS(msgpack::msgpack_sequence_index(v));
+    }
+
+    SECTION("unknown type")
+    {
+        std::vector<uint8_t> v = {0x01,0xc1};
+        std::error_code ec;
+        msgpack::msgpack_sequence_index index(v, msgpack::msgpack_decode_options(), ec);
+        CHECK(ec == msgpack::msgpack_errc::unknown_type);
+    }
+}
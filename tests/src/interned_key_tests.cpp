@@ -0,0 +1,139 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
+#include <catch/catch.hpp>
+#include <map>
+#include <string>
+
+using namespace jsoncons;
+
+using interned_json = basic_json<char,interned_policy>;
+using interned_key = basic_interned_key<char>;
+
+TEST_CASE("basic_interned_key tests")
+{
+    SECTION("empty")
+    {
+        interned_key key;
+        CHECK(key.empty());
+        CHECK(key.size() == 0);
+        CHECK(key.c_str()[0] == 0);
+        CHECK(key == "");
+        CHECK(key.use_count() == 0);
+    }
+
+    SECTION("copies share a buffer")
+    {
+        interned_key key("name");
+        interned_key copy(key);
+        CHECK(copy.data() == key.data());
+        CHECK(key.use_count() == 2);
+        CHECK(copy == key);
+        CHECK(std::string(copy.begin(), copy.end()) == "name");
+
+        interned_key other(std::string("name"));
+        CHECK(other.data() != key.data());
+        CHECK(other == key);
+        CHECK(other.compare(key) == 0);
+    }
+
+    SECTION("order")
+    {
+        interned_key a("ab");
+        interned_key b("abc");
+        CHECK(a < b);
+        CHECK_FALSE(b < a);
+        CHECK(a != b);
+        CHECK(a.compare(string_view("aa")) > 0);
+    }
+
+    SECTION("pool")
+    {
+        interned_key::pool_type pool;
+        interned_key a = pool.intern("id");
+        interned_key b = pool.intern(std::string("id"));
+        interned_key c = pool.intern("name");
+        CHECK(a.data() == b.data());
+        CHECK(a.data() != c.data());
+        CHECK(pool.size() == 2);
+
+        pool.clear();
+        CHECK(pool.size() == 0);
+        CHECK(a.use_count() == 2);
+        CHECK(std::string(b.c_str()) == "id");
+    }
+}
+
+TEST_CASE("interned_policy tests")
+{
+    std::string input = R"(
+[
+    {"id": 1, "name": "a", "tags": {"id": "x"}},
+    {"id": 2, "name": "b", "tags": {}},
+    {"name": "c", "id": 3}
+]
+    )";
+
+    SECTION("repeated keys are stored once")
+    {
+        interned_json j = interned_json::parse(input);
+
+        const char* id = j[0].object_range().begin()->key().data();
+        CHECK(j[1].object_range().begin()->key().data() == id);
+        CHECK(j[2].object_range().begin()->key().data() == id);
+        CHECK(j[0]["tags"].object_range().begin()->key().data() == id);
+        CHECK(j[0].object_range().begin()->key().use_count() == 4);
+    }
+
+    SECTION("same as json")
+    {
+        interned_json j = interned_json::parse(input);
+        json expected = json::parse(input);
+
+        std::string s1;
+        std::string s2;
+        j.dump(s1);
+        expected.dump(s2);
+        CHECK(s1 == s2);
+
+        CHECK(j[2].at("id").as<int>() == 3);
+        CHECK(j[0].contains("tags"));
+        CHECK_FALSE(j[1].contains("other"));
+        CHECK(j[0].get_value_or<int>("other", 7) == 7);
+        CHECK(jsonpointer::get(j, "/0/tags/id").as<std::string>() == "x");
+
+        auto m = j[0].as<std::map<std::string,interned_json>>();
+        CHECK(m.size() == 3);
+    }
+
+    SECTION("modify")
+    {
+        interned_json j = interned_json::parse(input);
+        interned_json copy = j;
+        CHECK(copy == j);
+
+        copy[0].insert_or_assign("other", 4);
+        copy[0].erase("name");
+        copy[1]["name"] = "z";
+        CHECK(copy != j);
+        CHECK(copy[0].size() == 3);
+        CHECK(copy[0]["other"].as<int>() == 4);
+        CHECK(copy[1]["name"].as<std::string>() == "z");
+        CHECK(j[0].size() == 3);
+        CHECK(j[1]["name"].as<std::string>() == "b");
+
+        interned_json o(json_object_arg, {{"b", 1}, {"a", 2}});
+        CHECK(o.object_range().begin()->key() == "a");
+    }
+
+    SECTION("find with a member's own name")
+    {
+        interned_json j = interned_json::parse(input);
+        const auto& key = j[0].object_range().begin()->key();
+        auto it = j[1].find(string_view(key));
+        REQUIRE(bool(it != j[1].object_range().end()));
+        CHECK(it->value().as<int>() == 2);
+    }
+}
@@ -536,3 +536,78 @@ TEST_CASE("basic_json bool comparator")
     }
 }
 
+
+TEST_CASE("basic_json hash")
+{
+    SECTION("numbers that compare equal")
+    {
+        json a(10);
+        json b(uint64_t(10));
+        json c(10.0);
+        json d(-0.0);
+        json e(0);
+        CHECK(a == b);
+        CHECK(a == c);
+        CHECK(a.hash() == b.hash());
+        CHECK(a.hash() == c.hash());
+        CHECK(d == e);
+        CHECK(d.hash() == e.hash());
+    }
+
+    SECTION("short and long strings")
+    {
+        std::string s(100, 'a');
+        json a(s);
+        json b(s.substr(0, 3));
+        json c("aaa");
+        CHECK(a.hash() == json(s).hash());
+        CHECK(b.hash() == c.hash());
+        CHECK(a.hash() != c.hash());
+    }
+
+    SECTION("empty objects")
+    {
+        json o1;
+        json o2(json_object_arg);
+        json o3 = json::parse("{}");
+        CHECK(o1.hash() == o2.hash());
+        CHECK(o1.hash() == o3.hash());
+    }
+
+    SECTION("object member order")
+    {
+        ojson a = ojson::parse(R"({"first":1,"second":[1,2,{"x":true}]})");
+        ojson b = ojson::parse(R"({"second":[1,2.0,{"x":true}],"first":1.0})");
+        CHECK(a.hash() == b.hash());
+    }
+
+    SECTION("arrays are ordered")
+    {
+        json a = json::parse("[1,2,3]");
+        json b = json::parse("[3,2,1]");
+        CHECK(a != b);
+        CHECK(a.hash() != b.hash());
+        CHECK(a.hash() == json::parse("[1.0,2,3]").hash());
+    }
+
+    SECTION("different types")
+    {
+        CHECK(json(null_type()).hash() != json(false).hash());
+        CHECK(json(true).hash() != json(false).hash());
+        CHECK(json("1").hash() != json(1).hash());
+        CHECK(json::parse("[]").hash() != json::parse("{}").hash());
+    }
+
+    SECTION("json_const_pointer")
+    {
+        json a = json::parse(R"({"a":[1,2]})");
+        json p(json_const_pointer_arg, &a);
+        CHECK(p.hash() == a.hash());
+    }
+
+    SECTION("std::hash")
+    {
+        json a = json::parse(R"({"a":[1,2]})");
+        CHECK(std::hash<json>()(a) == a.hash());
+    }
+}
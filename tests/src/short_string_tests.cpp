@@ -30,3 +30,62 @@ TEST_CASE("test_small_string")
 }
 
 
+
+TEST_CASE("inline string policy tests")
+{
+    using json24 = basic_json<char,inline_string_policy>;
+    using json40 = basic_json<char,basic_inline_string_policy<40>>;
+
+    CHECK(sizeof(json) == 16);
+    CHECK(sizeof(json24) == 24);
+    CHECK(sizeof(json40) == 40);
+
+    SECTION("lengths")
+    {
+        for (std::size_t length = 0; length <= 40; ++length)
+        {
+            std::string s;
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                s.push_back(static_cast<char>('a' + i % 26));
+            }
+            INFO(length);
+
+            json24 a(s);
+            CHECK((a.storage() == storage_kind::short_string_value) == (length <= 21));
+            CHECK(a.as_string_view() == string_view(s));
+            CHECK(std::string(a.as_cstring()) == s);
+
+            json40 b(s);
+            CHECK((b.storage() == storage_kind::short_string_value) == (length <= 37));
+            CHECK(b.as_string_view() == string_view(s));
+
+            json40 c(b);
+            CHECK(c.as<std::string>() == s);
+            json40 d;
+            d = c;
+            CHECK(d == b);
+            json40 e(std::move(c));
+            CHECK(e.as<std::string>() == s);
+        }
+    }
+
+    SECTION("tags")
+    {
+        json24 j("2020-11-10T08:15:30Z", semantic_tag::datetime);
+        CHECK(j.storage() == storage_kind::short_string_value);
+        CHECK(j.tag() == semantic_tag::datetime);
+    }
+
+    SECTION("parse")
+    {
+        std::string input = R"({"id":"123e4567-e89b-12d3-a456-426614174000","created":"2020-11-10T08:15:30Z"})";
+        json40 j = json40::parse(input);
+        CHECK(j["id"].storage() == storage_kind::short_string_value);
+        CHECK(j["created"].storage() == storage_kind::short_string_value);
+
+        std::string output;
+        j.dump(output);
+        CHECK(output == json::parse(input).to_string());
+    }
+}
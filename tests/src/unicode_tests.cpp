@@ -57,3 +57,45 @@ BOOST_AUTO_TEST_CASE( test1 )
 }
 #endif
 
+
+TEST_CASE("unicode_traits::validate utf8 tests")
+{
+    SECTION("long ascii")
+    {
+        std::string s(100, 'a');
+        auto r = unicode_traits::validate(s.data(), s.size());
+        CHECK(r.ec == unicode_traits::conv_errc());
+        CHECK(r.ptr == s.data() + s.size());
+    }
+    SECTION("ascii with multibyte sequences")
+    {
+        std::string s = std::string(37, 'a') + "\xC3\xA9" + std::string(20, 'b') + "\xE2\x82\xAC" + std::string(17, 'c') + "\xF0\x9F\x98\x80";
+        auto r = unicode_traits::validate(s.data(), s.size());
+        CHECK(r.ec == unicode_traits::conv_errc());
+        CHECK(r.ptr == s.data() + s.size());
+    }
+    SECTION("invalid byte after ascii run")
+    {
+        for (std::size_t n = 0; n < 40; ++n)
+        {
+            std::string s = std::string(n, 'a') + "\x80" + std::string(20, 'b');
+            auto r = unicode_traits::validate(s.data(), s.size());
+            CHECK(r.ec == unicode_traits::conv_errc::source_illegal);
+            CHECK(r.ptr == s.data() + n);
+        }
+    }
+    SECTION("expected continuation byte")
+    {
+        std::string s = std::string(33, 'a') + "\xC3" + "a" + std::string(20, 'b');
+        auto r = unicode_traits::validate(s.data(), s.size());
+        CHECK(r.ec == unicode_traits::conv_errc::expected_continuation_byte);
+        CHECK(r.ptr == s.data() + 33);
+    }
+    SECTION("truncated sequence at end")
+    {
+        std::string s = std::string(24, 'a') + "\xE2\x82";
+        auto r = unicode_traits::validate(s.data(), s.size());
+        CHECK(r.ec == unicode_traits::conv_errc::source_exhausted);
+        CHECK(r.ptr == s.data() + 24);
+    }
+}
@@ -182,3 +182,59 @@ TEST_CASE("decode indefinite length ubjson arrays and maps")
 }
 
 
+
+TEST_CASE("decode ubjson strongly typed numeric arrays")
+{
+    SECTION("uint8")
+    {
+        check_decode_ubjson({'[','$','U','#','U',0x03,0x01,0x02,0xff}, json::parse("[1,2,255]"));
+    }
+    SECTION("int16")
+    {
+        check_decode_ubjson({'[','$','I','#','U',0x02,0xff,0xff,0x01,0x00}, json::parse("[-1,256]"));
+    }
+    SECTION("float32")
+    {
+        check_decode_ubjson({'[','$','d','#','U',0x02,0x3f,0xc0,0x00,0x00,0xc0,0x00,0x00,0x00}, json::parse("[1.5,-2.0]"));
+    }
+    SECTION("empty")
+    {
+        check_decode_ubjson({'[','$','l','#','U',0x00}, json(json_array_arg));
+    }
+    SECTION("truncated")
+    {
+        std::vector<uint8_t> v = {'[','$','l','#','U',0x02,0x00,0x00,0x00,0x01,0x00};
+        REQUIRE_THROWS(ubjson::decode_ubjson<json>(v));
+    }
+    SECTION("round trip std::vector<double>")
+    {
+        std::vector<double> v = {0.1, 1.5, -1000.25};
+        std::vector<uint8_t> buf;
+        ubjson::encode_ubjson(v, buf);
+        auto u = ubjson::decode_ubjson<std::vector<double>>(buf);
+        CHECK(u == v);
+    }
+    SECTION("round trip std::vector<int64_t> in array")
+    {
+        std::vector<std::vector<int64_t>> v = {{1, -70000, 3}, {}, {4000000000}};
+        std::vector<uint8_t> buf;
+        ubjson::encode_ubjson(v, buf);
+        auto u = ubjson::decode_ubjson<std::vector<std::vector<int64_t>>>(buf);
+        CHECK(u == v);
+    }
+    SECTION("cursor")
+    {
+        std::vector<uint8_t> v = {'[','$','U','#','U',0x02,0x07,0x08};
+        ubjson::ubjson_bytes_cursor cursor(v);
+        CHECK(cursor.current().event_type() == staj_event_type::begin_array);
+        CHECK(cursor.is_typed_array());
+        cursor.next();
+        CHECK(cursor.current().get<int>() == 7);
+        cursor.next();
+        CHECK(cursor.current().get<int>() == 8);
+        cursor.next();
+        CHECK(cursor.current().event_type() == staj_event_type::end_array);
+        cursor.next();
+        CHECK(cursor.done());
+    }
+}
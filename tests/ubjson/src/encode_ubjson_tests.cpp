@@ -8,6 +8,7 @@
 #include <jsoncons_ext/ubjson/ubjson.hpp>
 #include <sstream>
 #include <vector>
+#include <map>
 #include <utility>
 #include <ctime>
 #include <limits>
@@ -211,3 +212,50 @@ TEST_CASE("encode_ubjson overloads")
     }
 }
 
+
+TEST_CASE("encode_ubjson typed arrays")
+{
+    SECTION("std::vector<int64_t> with small values")
+    {
+        std::vector<int64_t> v = {1,2,255};
+        std::vector<uint8_t> result;
+        ubjson::encode_ubjson(v, result);
+        check_encode_ubjson({'[','$','U','#','U',0x03,0x01,0x02,0xff}, result);
+    }
+    SECTION("std::vector<int32_t> with negative values")
+    {
+        std::vector<int32_t> v = {-1,256};
+        std::vector<uint8_t> result;
+        ubjson::encode_ubjson(v, result);
+        check_encode_ubjson({'[','$','I','#','U',0x02,0xff,0xff,0x01,0x00}, result);
+    }
+    SECTION("std::vector<double> representable as float")
+    {
+        std::vector<double> v = {1.5,-2.0};
+        std::vector<uint8_t> result;
+        ubjson::encode_ubjson(v, result);
+        check_encode_ubjson({'[','$','d','#','U',0x02,0x3f,0xc0,0x00,0x00,0xc0,0x00,0x00,0x00}, result);
+    }
+    SECTION("std::vector<double>")
+    {
+        std::vector<double> v = {0.1};
+        std::vector<uint8_t> result;
+        ubjson::encode_ubjson(v, result);
+        check_encode_ubjson({'[','$','D','#','U',0x01,0x3f,0xb9,0x99,0x99,0x99,0x99,0x99,0x9a}, result);
+    }
+    SECTION("std::vector<uint64_t> out of int64 range")
+    {
+        std::vector<uint64_t> v = {1,(std::numeric_limits<uint64_t>::max)()};
+        std::vector<uint8_t> result;
+        ubjson::encode_ubjson(v, result);
+        REQUIRE(result.size() >= 2);
+        CHECK(result[1] == '#');
+    }
+    SECTION("nested in object")
+    {
+        std::map<std::string,std::vector<int>> m = {{"a",{1,2,3}}};
+        std::vector<uint8_t> result;
+        ubjson::encode_ubjson(m, result);
+        check_encode_ubjson({'{','#','U',0x01,'U',0x01,'a','[','$','U','#','U',0x03,0x01,0x02,0x03}, result);
+    }
+}